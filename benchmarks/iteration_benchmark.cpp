@@ -0,0 +1,115 @@
+/*
+ * iteration_benchmark.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ *
+ * Compares the iteration policies for the point-wise FDTD kernels on a single
+ * process. Usage: huerto_benchmark [cells per dimension] [steps]
+ */
+
+#include "../electromagnetics/fdtd/fdtd_kernels.hpp"
+#include "../util/parallel_iteration.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const int NGhost = 2;
+
+void initFields(FDTD_FieldContainer &c, ptrdiff_t N)
+{
+  Index lo, hi;
+  Vector domainLo, domainHi;
+  Stagger stagger;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    stagger[d] = false;
+    lo[d] = -NGhost;
+    hi[d] = N - 1 + NGhost;
+    domainLo[d] = 0.0;
+    domainHi[d] = 1.0;
+    c.dx[d] = 1.0/N;
+  }
+  Domain domain{domainLo, domainHi};
+  c.dt = 0.5/(clight*N*DIMENSION);
+
+  for (Field *f : {&c.Ex, &c.Ey, &c.Ez, &c.Bx, &c.By, &c.Bz, &c.Jx, &c.Jy, &c.Jz}) {
+    f->resize(lo, hi, domain, stagger, NGhost);
+    *f = 0.0;
+  }
+  c.Ex = 1.0;
+  c.By = 1.0;
+
+  for (Grid1d *kappa : {&c.KappaDx
+#ifndef HUERTO_ONE_DIM
+                        , &c.KappaDy
+#endif
+#ifdef HUERTO_THREE_DIM
+                        , &c.KappaDz
+#endif
+                       }) {
+    kappa->resize(Grid1d::IndexType{lo[0]}, Grid1d::IndexType{hi[0]});
+    *kappa = 1.0;
+  }
+}
+
+template<class Iterator>
+void runBenchmark(const std::string &name, ptrdiff_t N, int steps)
+{
+  FDTD_FieldContainer fields;
+  initFields(fields, N);
+  Index lo, hi;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    lo[d] = 0;
+    hi[d] = N - 1;
+  }
+  Range range{lo, hi};
+
+  FDTD_StepE stepE{fields};
+  FDTD_StepB stepB{fields};
+
+  // One warm-up step to touch all the memory
+  Iterator::forEach(range, stepE);
+  Iterator::forEach(range, stepB);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int s=0; s<steps; ++s) {
+    Iterator::forEach(range, stepE);
+    Iterator::forEach(range, stepB);
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(stop - start).count();
+  double cells = 1.0;
+  for (size_t d=0; d<DIMENSION; ++d) cells *= N;
+
+  std::cout << std::setw(12) << name
+      << std::setw(12) << std::fixed << std::setprecision(3) << seconds << " s"
+      << std::setw(12) << std::setprecision(1) << cells*steps/seconds/1e6 << " Mcells/s"
+      << std::endl;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  ptrdiff_t N = (argc > 1) ? std::atol(argv[1]) : 128;
+  int steps = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+  std::cout << "FDTD update, " << N << "^" << DIMENSION << " cells, "
+      << steps << " steps" << std::endl;
+
+  runBenchmark<schnek::RangeCIterationPolicy<DIMENSION>>("serial", N, steps);
+  runBenchmark<FieldSlabIterator>("slabs", N, steps);
+#ifdef HUERTO_USE_KOKKOS
+  runBenchmark<RangeKokkosIterationPolicy<DIMENSION>>("kokkos", N, steps);
+  huertoFinalizeKokkos();
+#endif
+
+  return 0;
+}
@@ -7,9 +7,79 @@
 
 #include "current.hpp"
 #include "../util/field_util.hpp"
+#include "../util/parallel_iteration.hpp"
 
+#include <schnek/grid/iteration/range-iteration.hpp>
+
+#include <algorithm>
 #include <memory>
 
+namespace {
+
+/**
+ * True if any of the currents in the list is a volume current
+ */
+template<class CurrentList>
+bool hasVolumeCurrent(const CurrentList &currentList)
+{
+  for (pCurrent current: currentList) {
+    if (current->isVolumeCurrent()) return true;
+  }
+  return false;
+}
+
+/**
+ * Add up the components of all currents in the list into the sum grids `sums`
+ *
+ * The slabs of the grids are distributed over threads if `threaded` is true.
+ */
+template<class CurrentList>
+void sumCurrentList(HuertoDecomposition &decomposition,
+                    const CurrentList &currentList,
+                    std::vector<schnek::GridRegistration> sums,
+                    bool threaded)
+{
+  for (int c=0; c<3; ++c) {
+    decomposition.getGridContext({sums[c]}).forEach([&](Range range, Field &sum) {
+      SetField<Field> set{sum, 0.0};
+      FieldSlabIterator::forEach(range, set, threaded);
+    });
+  }
+
+  for (pCurrent current: currentList) {
+    for (int c=0; c<3; ++c) {
+      for (schnek::GridRegistration reg: current->getComponentGrids(c)) {
+        decomposition.getGridContext({reg, sums[c]}).forEach([&](Range range, Grid &grid, Field &sum) {
+          AddToField<Field, Grid> add{sum, grid};
+          FieldSlabIterator::forEach(range, add, threaded);
+        });
+      }
+    }
+  }
+}
+
+/**
+ * Collect the local grids of all current components in a list of patches
+ */
+template<class CurrentList>
+void collectPatches(HuertoDecomposition &decomposition,
+                    const CurrentList &currentList,
+                    std::vector<CurrentPatch> &patches)
+{
+  patches.clear();
+  for (pCurrent current: currentList) {
+    for (int c=0; c<3; ++c) {
+      for (schnek::GridRegistration reg: current->getComponentGrids(c)) {
+        decomposition.getGridContext({reg}).forEach([&](Range range, Grid &grid) {
+          patches.push_back(CurrentPatch{range, grid, c});
+        });
+      }
+    }
+  }
+}
+
+}
+
 void CurrentContainer::addCurrent(pCurrent current)
 {
   current->init();
@@ -24,47 +94,91 @@ void CurrentContainer::addMagCurrent(pCurrent current)
 
 void CurrentContainer::sumCurrents()
 {
+  if (sparseCurrents) return;
   auto &decomposition = context->getDecomposition();
 
-  setField<Field>(decomposition, {Jx}, 0.0);
-  setField<Field>(decomposition, {Jy}, 0.0);
-  setField<Field>(decomposition, {Jz}, 0.0);
-
-  for (pCurrent current: this->currents)
-  {
-    addToField<Field, Grid>(decomposition, Jx, current->getJx());
-    addToField<Field, Grid>(decomposition, Jy, current->getJy());
-    addToField<Field, Grid>(decomposition, Jz, current->getJz());
-  }
+  sumCurrentList(decomposition, currents, {Jx, Jy, Jz}, threadedCurrents);
 }
 
 void CurrentContainer::sumMagCurrents()
 {
+  if (sparseMagCurrents) return;
   auto &decomposition = context->getDecomposition();
 
-  setField<Field>(decomposition, {Mx}, 0.0);
-  setField<Field>(decomposition, {My}, 0.0);
-  setField<Field>(decomposition, {Mz}, 0.0);
+  sumCurrentList(decomposition, magCurrents, {Mx, My, Mz}, threadedCurrents);
+}
+
+std::vector<Field> CurrentContainer::getLocalCurrentSums(bool magnetic)
+{
+  std::vector<Field> sums;
+  if (magnetic ? sparseMagCurrents : sparseCurrents) {
+    sums.resize(3);
+    return sums;
+  }
+
+  auto &decomposition = context->getDecomposition();
+  schnek::GridRegistration x = magnetic ? Mx : Jx;
+  schnek::GridRegistration y = magnetic ? My : Jy;
+  schnek::GridRegistration z = magnetic ? Mz : Jz;
+  decomposition.getGridContext({x, y, z}).forEach([&](Range /* range */, Field &x, Field &y, Field &z) {
+    sums.push_back(x);
+    sums.push_back(y);
+    sums.push_back(z);
+  });
+  return sums;
+}
 
-  for (pCurrent current: this->magCurrents)
-  {
-    addToField<Field, Grid>(decomposition, Mx, current->getJx());
-    addToField<Field, Grid>(decomposition, My, current->getJy());
-    addToField<Field, Grid>(decomposition, Mz, current->getJz());
+void CurrentContainer::addCurrentPatches(const std::vector<CurrentPatch> &patches,
+                                         const Range &range,
+                                         Field &x, Field &y, Field &z,
+                                         double factor)
+{
+  Field *components[3] = {&x, &y, &z};
+  for (const CurrentPatch &patch: patches) {
+    Index lo, hi;
+    bool empty = false;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      lo[d] = std::max(range.getLo(d), patch.range.getLo(d));
+      hi[d] = std::min(range.getHi(d), patch.range.getHi(d));
+      empty = empty || (lo[d] > hi[d]);
+    }
+    if (empty) continue;
+
+    // This is called from within the threaded field update, so the
+    // iteration itself is serial
+    Field &field = *components[patch.component];
+    const Grid &grid = patch.grid;
+    schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{lo, hi}, [&](const Index &pos) {
+      field[pos] += factor*grid[pos];
+    });
   }
 }
 
-void CurrentContainer::init(SimulationContext &context)
+void CurrentContainer::init(SimulationContext &context, bool allowSparse, bool threaded)
 {
   this->context = &context;
+  threadedCurrents = threaded;
   auto &decomposition = context.getDecomposition();
-  Jx = decomposition.registerField(schnek::GridFactory<Field>{exStaggerYee, 2});
-  Jy = decomposition.registerField(schnek::GridFactory<Field>{eyStaggerYee, 2});
-  Jz = decomposition.registerField(schnek::GridFactory<Field>{ezStaggerYee, 2});
+  int ghostCells = context.getGhostCells();
 
-  Mx = decomposition.registerField(schnek::GridFactory<Field>{bxStaggerYee, 2});
-  My = decomposition.registerField(schnek::GridFactory<Field>{byStaggerYee, 2});
-  Mz = decomposition.registerField(schnek::GridFactory<Field>{bzStaggerYee, 2});
+  sparseCurrents = allowSparse && !hasVolumeCurrent(currents);
+  sparseMagCurrents = allowSparse && !hasVolumeCurrent(magCurrents);
+
+  if (sparseCurrents) {
+    collectPatches(decomposition, currents, currentPatches);
+  } else {
+    Jx = decomposition.registerField(schnek::GridFactory<Field>{exStaggerYee, ghostCells});
+    Jy = decomposition.registerField(schnek::GridFactory<Field>{eyStaggerYee, ghostCells});
+    Jz = decomposition.registerField(schnek::GridFactory<Field>{ezStaggerYee, ghostCells});
+  }
+
+  if (sparseMagCurrents) {
+    collectPatches(decomposition, magCurrents, magCurrentPatches);
+  } else {
+    Mx = decomposition.registerField(schnek::GridFactory<Field>{bxStaggerYee, ghostCells});
+    My = decomposition.registerField(schnek::GridFactory<Field>{byStaggerYee, ghostCells});
+    Mz = decomposition.registerField(schnek::GridFactory<Field>{bzStaggerYee, ghostCells});
+  }
 }
 
 
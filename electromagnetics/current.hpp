@@ -17,9 +17,32 @@
 
 #include <schnek/variables/blockcontainer.hpp>
 
+#include <vector>
+
 class Current;
 typedef std::shared_ptr<Current> pCurrent;
 
+/**
+ * One component of a current on the part of the local grid that it covers
+ */
+struct CurrentPatch
+{
+    /**
+     * The range covered by the current
+     */
+    Range range;
+
+    /**
+     * The grid holding the current
+     */
+    Grid grid;
+
+    /**
+     * The component of the current, 0, 1, or 2
+     */
+    int component;
+};
+
 /**
  * A container for currents that distinguishes between electric and magnetic
  * currents. The currents are added up from all the Current references added
@@ -33,6 +56,13 @@ typedef std::shared_ptr<Current> pCurrent;
  * Typically an implementation of an electromagnetic FieldSolver will also inherit 
  * from CurrentContainer. This allows the field solver to access the summed up 
  * currents and include them in the field equations.
+ *
+ * Most currents, such as the CPML currents and the incident field sources, only
+ * cover thin slabs of the domain. Unless a volume current is present, the
+ * currents are therefore not summed. Instead, the field solver adds each current
+ * directly to the fields on the range it covers, see #currentPatches and
+ * addCurrentPatches(). The full-domain sum grids are only allocated if they
+ * are needed.
  */
 class CurrentContainer
 {
@@ -65,22 +95,75 @@ class CurrentContainer
     schnek::GridRegistration Mx, My, Mz;
 
     /**
-     * Add all electric currents and store the result in #pJx, #pJy, #pJz
+     * True if the electric currents are applied directly instead of being summed
+     */
+    bool sparseCurrents;
+
+    /**
+     * True if the magnetic currents are applied directly instead of being summed
+     */
+    bool sparseMagCurrents;
+
+    /**
+     * True if the currents are summed and updated with multiple threads
+     */
+    bool threadedCurrents;
+
+    /**
+     * The components of the electric currents on their local ranges; only used
+     * if #sparseCurrents is true
+     */
+    std::vector<CurrentPatch> currentPatches;
+
+    /**
+     * The components of the magnetic currents on their local ranges; only used
+     * if #sparseMagCurrents is true
+     */
+    std::vector<CurrentPatch> magCurrentPatches;
+
+    /**
+     * Add all electric currents and store the result in #Jx, #Jy, #Jz
      *
      * Each current can be defined on a separate sub-domain of the local grid
-     * domain
+     * domain. Does nothing if the currents are applied directly.
      */
     void sumCurrents();
 
     /**
-     * Add all magnetic currents and store the result in #pMx, #pMy, #pMz
+     * Add all magnetic currents and store the result in #Mx, #My, #Mz
      *
      * Each current can be defined on a separate sub-domain of the local grid
-     * domain
+     * domain. Does nothing if the currents are applied directly.
      */
     void sumMagCurrents();
 
+    /**
+     * The local grids of the summed electric or magnetic currents
+     *
+     * If the currents are applied directly, the sum grids are not allocated and
+     * empty grids are returned.
+     */
+    std::vector<Field> getLocalCurrentSums(bool magnetic);
+
   public:
+    /**
+     * Virtual destructor
+     */
+    virtual ~CurrentContainer() {}
+
+    /**
+     * Returns true if absorbing layers may be placed on a boundary of the domain
+     *
+     * This is not the case for a boundary that lies on a symmetry axis.
+     */
+    virtual bool isOpenBoundary(Direction /* dir */) { return true; }
+
+    /**
+     * Returns true if the currents should use multiple threads
+     *
+     * The setting is passed to init() by the field solver.
+     */
+    bool isThreaded() const { return threadedCurrents; }
 
     /**
      * Add an electric current to the list
@@ -92,10 +175,26 @@ class CurrentContainer
      */
     void addMagCurrent(pCurrent current);
 
+    /**
+     * Add `factor` times the current patches to the field components `x`, `y`, `z`
+     *
+     * Only the part of the patches inside `range` is added.
+     */
+    static void addCurrentPatches(const std::vector<CurrentPatch> &patches,
+                                  const Range &range,
+                                  Field &x, Field &y, Field &z,
+                                  double factor);
+
     /**
      * Initialises the sum of the currents to the local grid domain
+     *
+     * This has to be called after all the currents have been added. If
+     * `allowSparse` is true and none of the currents is a volume current, the
+     * sum grids are not allocated and the current patches are collected instead.
+     * If `threaded` is true, the currents are summed and updated with multiple
+     * threads.
      */
-    void init(SimulationContext &context);
+    void init(SimulationContext &context, bool allowSparse = true, bool threaded = false);
 };
 
 /**
@@ -169,6 +268,39 @@ class Current
      */
     virtual void stepScheme(double dt) = 0;
 
+    /**
+     * Returns true if the current extends over a large part of the domain
+     *
+     * Volume currents are summed into full-domain grids. All other currents
+     * are added directly to the fields on the range they cover. The currents
+     * on the boundary slabs keep the default. A current whose grids cover most
+     * of the domain should return true, so that the solver sweeps the summed
+     * grids instead of adding many overlapping patches.
+     */
+    virtual bool isVolumeCurrent() { return false; }
+
+    /**
+     * Returns true if the current vanishes wherever the fields have always vanished
+     *
+     * This is the case for currents that only respond to the fields, such as
+     * the CPML currents. They do not seed the active region of a field solver
+     * that tracks the activity of the fields.
+     */
+    virtual bool vanishesWithFields() { return false; }
+
+    /**
+     * Get the grids holding a component of the current
+     *
+     * By default, this returns the single grid #Jx, #Jy, or #Jz. A current that
+     * is made up of several disjoint boxes can return one grid for each box.
+     * Components that vanish everywhere can be left out.
+     */
+    virtual std::vector<schnek::GridRegistration> getComponentGrids(int component)
+    {
+      schnek::GridRegistration grids[3] = {Jx, Jy, Jz};
+      return {grids[component]};
+    }
+
     /**
      * Get the x-component of the current
      */
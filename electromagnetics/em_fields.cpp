@@ -8,6 +8,8 @@
 #include "em_fields.hpp"
 #include "../types.hpp"
 #include "../constants.hpp"
+#include "../simulation/grid_grading.hpp"
+#include "../simulation/moving_window.hpp"
 
 #include <schnek/util/logger.hpp>
 #include <schnek/tools/fieldtools.hpp>
@@ -29,13 +31,14 @@ void EMFields::registerData() {
   SimulationEntity::init(this);
   
   auto &decomposition = getContext().getDecomposition();
-  E[0].field = decomposition.registerField(schnek::GridFactory<Field>{exStaggerYee, 2});
-  E[1].field = decomposition.registerField(schnek::GridFactory<Field>{eyStaggerYee, 2});
-  E[2].field = decomposition.registerField(schnek::GridFactory<Field>{ezStaggerYee, 2});
+  int ghostCells = getContext().getGhostCells();
+  E[0].field = decomposition.registerField(schnek::GridFactory<Field>{exStaggerYee, ghostCells});
+  E[1].field = decomposition.registerField(schnek::GridFactory<Field>{eyStaggerYee, ghostCells});
+  E[2].field = decomposition.registerField(schnek::GridFactory<Field>{ezStaggerYee, ghostCells});
 
-  B[0].field = decomposition.registerField(schnek::GridFactory<Field>{bxStaggerYee, 2});
-  B[1].field = decomposition.registerField(schnek::GridFactory<Field>{byStaggerYee, 2});
-  B[2].field = decomposition.registerField(schnek::GridFactory<Field>{bzStaggerYee, 2});
+  B[0].field = decomposition.registerField(schnek::GridFactory<Field>{bxStaggerYee, ghostCells});
+  B[1].field = decomposition.registerField(schnek::GridFactory<Field>{byStaggerYee, ghostCells});
+  B[2].field = decomposition.registerField(schnek::GridFactory<Field>{bzStaggerYee, ghostCells});
 
   for (size_t i=0; i<3; ++i) {
     addData(indexToCoord(i, "E"), E[i].field);
@@ -58,8 +61,8 @@ void EMFields::fillValues() {
   for (size_t i=0; i<3; ++i) {
     auto gridContext = decomposition.getGridContext({E[i].field, B[i].field});
     gridContext.forEach([&](Range& /* range */, Field &Efield, Field &Bfield) {
-      schnek::fill_field(Efield, x, E[i].value, updater, E[i].parameter);
-      schnek::fill_field(Bfield, x, B[i].value, updater, B[i].parameter);
+      fillGradedField(getContext(), Efield, x, E[i].value, updater, E[i].parameter);
+      fillGradedField(getContext(), Bfield, x, B[i].value, updater, B[i].parameter);
     });
   }
 }
@@ -72,5 +75,36 @@ void EMFields::init() {
   schnek::ChildBlock<EMFields>::init();
 
   fillValues();
+  getContext().registerShiftable(this);
+}
+
+void EMFields::shiftWindow(size_t dim) {
+  auto &decomposition = getContext().getDecomposition();
+  schnek::pBlockVariables blockVars = getVariables();
+  schnek::pDependencyMap depMap(new schnek::DependencyMap(blockVars));
+
+  schnek::DependencyUpdater updater(depMap);
+
+  Vector &x = getContext().getX();
+  schnek::Array<schnek::pParameter, DIMENSION> x_parameters = getContext().getXParameter();
+  updater.addIndependentArray(x_parameters);
+
+  Range global = decomposition.getGlobalRange();
+
+  // The solver may have left some ghost cells stale, but the shift reads the
+  // ghost cells above the local grid
+  decomposition.exchange({E[0].field, E[1].field, E[2].field});
+  decomposition.exchange({B[0].field, B[1].field, B[2].field});
+
+  for (size_t i=0; i<3; ++i) {
+    auto gridContext = decomposition.getGridContext({E[i].field, B[i].field});
+    gridContext.forEach([&](Range& /* range */, Field &Efield, Field &Bfield) {
+      shiftInitialisedField(Efield, global, dim, getContext(), x, E[i].value, updater, E[i].parameter);
+      shiftInitialisedField(Bfield, global, dim, getContext(), x, B[i].value, updater, B[i].parameter);
+    });
+  }
+
+  decomposition.exchange({E[0].field, E[1].field, E[2].field});
+  decomposition.exchange({B[0].field, B[1].field, B[2].field});
 }
 // end of main
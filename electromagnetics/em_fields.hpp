@@ -24,7 +24,8 @@ class MPulse;
  */
 class EMFields :
         public schnek::ChildBlock<EMFields>,
-        public SimulationEntity
+        public SimulationEntity,
+        public WindowShiftable
 {
   private:
     /// The electric field in V/m
@@ -69,6 +70,14 @@ class EMFields :
      * Initialise the simulation data
      */
     void init();
+
+    /**
+     * Shift the fields when the window moves
+     *
+     * The cells entering the window at the leading edge are filled from the
+     * expressions provided in the setup file.
+     */
+    void shiftWindow(size_t dim) override;
 };
 
 
@@ -0,0 +1,276 @@
+/*
+ * fdtd_adi.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "fdtd_adi.hpp"
+
+#include "../pml/cpml_border.hpp"
+
+#include "../../constants.hpp"
+
+#include <schnek/grid.hpp>
+#include <schnek/tools/literature.hpp>
+
+#include <mpi.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/**
+ * The difference \f$(f_i - f_{i-1})/dx\f$ along `dim`
+ *
+ * Derivatives along dimensions that are not simulated vanish.
+ */
+template<class GridType>
+inline double backwardDiff(const GridType &f, Index pos, size_t dim, const Vector &dx)
+{
+  if (dim >= DIMENSION) return 0.0;
+  double f0 = f[pos];
+  --pos[dim];
+  return (f0 - f[pos])/dx[dim];
+}
+
+/**
+ * The difference \f$(f_{i+1} - f_i)/dx\f$ along `dim`
+ *
+ * Derivatives along dimensions that are not simulated vanish.
+ */
+template<class GridType>
+inline double forwardDiff(const GridType &f, Index pos, size_t dim, const Vector &dx)
+{
+  if (dim >= DIMENSION) return 0.0;
+  double f0 = f[pos];
+  ++pos[dim];
+  return (f[pos] - f0)/dx[dim];
+}
+
+/**
+ * The forward difference along `inner` followed by the backward difference along
+ * `outer`
+ *
+ * This is the product of the Yee differences that take a component of the
+ * electric field to the magnetic field and back.
+ */
+template<class GridType>
+inline double mixedDiff(const GridType &f, Index pos, size_t inner, size_t outer, const Vector &dx)
+{
+  if (outer >= DIMENSION) return 0.0;
+  double d0 = forwardDiff(f, pos, inner, dx);
+  --pos[outer];
+  return (d0 - forwardDiff(f, pos, inner, dx))/dx[outer];
+}
+
+/**
+ * Advance the magnetic field component \f$B_b\f$ explicitly by `h`
+ *
+ * The components `eu` and `ew` are \f$E_{b+1}\f$ and \f$E_{b+2}\f$, each taken
+ * at the time level required by the half step.
+ */
+template<class GridU, class GridW>
+void stepBComponent(Field &b, const GridU &eu, const GridW &ew, const Field &m,
+                    size_t u, size_t w, const Range &range, double h, const Vector &dx)
+{
+  FieldIterator::forEach(range, [&](Index pos) {
+    b[pos] += h*(forwardDiff(eu, pos, w, dx) - forwardDiff(ew, pos, u, dx) + m[pos]);
+  });
+}
+
+} // namespace
+
+void FDTD_ADI::init()
+{
+  SimulationEntity::init(this);
+
+  if (getContext().isGraded()) {
+    throw std::runtime_error("FDTD_ADI: the implicit solver cannot be used on a graded grid");
+  }
+
+  retrieveData("Ex", Ex);
+  retrieveData("Ey", Ey);
+  retrieveData("Ez", Ez);
+
+  retrieveData("Bx", Bx);
+  retrieveData("By", By);
+  retrieveData("Bz", Bz);
+
+  for (pCurrentBlock current: schnek::BlockContainer<CurrentBlock>::childBlocks())
+  {
+    // The CPML currents would be evaluated without the stretch factors and
+    // reflect the fields instead of absorbing them
+    if (dynamic_cast<CPMLBorder*>(current.get()) != nullptr) {
+      throw std::runtime_error("FDTD_ADI: CPMLBorder layers cannot be used with the implicit solver");
+    }
+    current->initCurrents(*this);
+  }
+
+  // The currents enter the right hand side on the whole local grid
+  CurrentContainer::init(getContext(), false);
+
+  schemeDt = 0.0;
+
+  schnek::LiteratureArticle Zheng2000("Zheng2000", "Zheng, F. and Chen, Z. and Zhang, J.",
+      "Toward the development of a three-dimensional unconditionally stable finite-difference time-domain method",
+      "IEEE Transactions on Microwave Theory and Techniques", "2000", "48", "1550--1558");
+
+  schnek::LiteratureManager::instance().addReference(
+      "Integration of electrodynamic fields uses the alternating-direction-implicit FDTD method.",
+      Zheng2000);
+}
+
+void FDTD_ADI::initSystems(double dt)
+{
+  Vector dx = getContext().getDx();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    double r = 0.25*clight2*dt*dt/(dx[d]*dx[d]);
+    if (periodic[d]) {
+      system[d] = std::make_unique<CyclicTridiagonal>(transpose[d]->lineLength(), -r, 1.0 + 2.0*r, -r);
+    } else {
+      openSystem[d] = std::make_unique<Tridiagonal>(transpose[d]->lineLength(), -r, 1.0 + 2.0*r, -r);
+    }
+  }
+  schemeDt = dt;
+}
+
+void FDTD_ADI::stepSchemeInit(double dt)
+{
+  auto &decomposition = getContext().getDecomposition();
+  decomposition.getGridContext({Ex}).forEach([&](Range range, Field &ex) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      transpose[d] = std::make_unique<LineTranspose>(range, d, decomposition.getComm());
+    }
+    for (int c=0; c<3; ++c) {
+      previousE[c].resize(ex.getLo(), ex.getHi());
+    }
+  });
+
+  int dims[DIMENSION], periods[DIMENSION], coords[DIMENSION];
+  MPI_Cart_get(decomposition.getComm(), DIMENSION, dims, periods, coords);
+  for (size_t d=0; d<DIMENSION; ++d) periodic[d] = periods[d];
+
+  initSystems(dt);
+
+  // Both fields start at the same time level, no half step is needed
+  for (pCurrent current: this->magCurrents) {
+    current->stepSchemeInit(dt);
+  }
+
+  for (pCurrent current: this->currents) {
+    current->stepSchemeInit(dt);
+  }
+}
+
+void FDTD_ADI::stepScheme(double dt)
+{
+  if (dt != schemeDt) initSystems(dt);
+
+  for (pCurrent current: this->currents) {
+    current->stepScheme(dt);
+  }
+  sumCurrents();
+
+  for (pCurrent current: this->magCurrents) {
+    current->stepScheme(dt);
+  }
+  sumMagCurrents();
+
+  halfStep(dt, false);
+  halfStep(dt, true);
+}
+
+void FDTD_ADI::solveLines(Field &field, size_t dim)
+{
+  LineTranspose &lineTranspose = *transpose[dim];
+  size_t length = lineTranspose.lineLength();
+
+  lineTranspose.gather(field, lines);
+  for (size_t l=0; l<lineTranspose.numLines(); ++l) {
+    if (periodic[dim]) {
+      system[dim]->solve(&lines[l*length]);
+    } else {
+      openSystem[dim]->solve(&lines[l*length]);
+    }
+  }
+  lineTranspose.scatter(lines, field);
+}
+
+void FDTD_ADI::halfStep(double dt, bool second)
+{
+  auto &decomposition = getContext().getDecomposition();
+  Vector dx = getContext().getDx();
+  double h = 0.5*dt;
+  std::vector<Field> jSums = getLocalCurrentSums(false);
+  std::vector<Field> mSums = getLocalCurrentSums(true);
+
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz});
+
+  // The electric field, implicit along one axis for each component
+  gridContext.forEach([&](
+    Range range,
+    Field &ex, Field &ey, Field &ez,
+    Field &bx, Field &by, Field &bz) {
+      Field *e[3] = {&ex, &ey, &ez};
+      Field *b[3] = {&bx, &by, &bz};
+
+      for (int c=0; c<3; ++c) {
+        Field &field = *e[c];
+        Grid &previous = previousE[c];
+        FieldIterator::forEach(Range{field.getLo(), field.getHi()}, [&](Index pos) {
+          previous[pos] = field[pos];
+        });
+      }
+
+      for (size_t c=0; c<3; ++c) {
+        size_t p = (c + 1) % 3;
+        size_t q = (c + 2) % 3;
+        size_t a = second ? q : p;
+
+        Field &field = *e[c];
+        const Field &bp = *b[p];
+        const Field &bq = *b[q];
+        const Field &j = jSums[c];
+        const Grid &ec = previousE[c];
+        const Grid &ea = previousE[a];
+
+        // Substituting the implicit magnetic field leaves the second derivative
+        // along a on the left hand side and a mixed derivative on the right
+        FieldIterator::forEach(range, [&](Index pos) {
+          double curl = backwardDiff(bq, pos, p, dx) - backwardDiff(bp, pos, q, dx);
+          field[pos] = ec[pos]
+              + clight2*h*curl
+              - clight2*h*h*mixedDiff(ea, pos, c, a, dx)
+              - h*j[pos]/eps_0;
+        });
+
+        if (a < DIMENSION) solveLines(field, a);
+      }
+  });
+
+  decomposition.exchange({Ex, Ey, Ez});
+
+  // The magnetic field follows explicitly
+  gridContext.forEach([&](
+    Range range,
+    Field &ex, Field &ey, Field &ez,
+    Field &bx, Field &by, Field &bz) {
+      Field *e[3] = {&ex, &ey, &ez};
+      Field *b[3] = {&bx, &by, &bz};
+
+      for (size_t c=0; c<3; ++c) {
+        size_t u = (c + 1) % 3;
+        size_t w = (c + 2) % 3;
+        if (second) {
+          stepBComponent(*b[c], previousE[u], *e[w], mSums[c], u, w, range, h, dx);
+        } else {
+          stepBComponent(*b[c], *e[u], previousE[w], mSums[c], u, w, range, h, dx);
+        }
+      }
+  });
+
+  decomposition.exchange({Bx, By, Bz});
+}
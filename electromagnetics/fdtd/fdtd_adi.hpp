@@ -0,0 +1,129 @@
+/*
+ * fdtd_adi.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+
+#ifndef HUERTO_FDTD_ADI_H
+#define HUERTO_FDTD_ADI_H
+
+#include "../fieldsolver.hpp"
+#include "../current.hpp"
+
+#include "../../maths/linear/tridiagonal.hpp"
+
+#include "../../simulation/line_transpose.hpp"
+#include "../../simulation/simulation_context.hpp"
+
+#include "../../types.hpp"
+
+#include <memory>
+#include <vector>
+
+/**
+ * Unconditionally stable alternating-direction-implicit FDTD solver
+ *
+ * The fields are stored on the Yee grid, but each time step is split into two
+ * half steps. In each half step, one of the two terms of each curl component is
+ * taken at the new time level, the other at the old one. Substituting the
+ * magnetic field into the update of the electric field gives a tridiagonal system
+ * along one axis for each component of \f$\mathbf{E}\f$. The second half step
+ * swaps the roles of the two terms. The magnetic field then follows explicitly.
+ *
+ * The scheme is stable for any time step, so that the time step can be chosen
+ * far above the Courant limit where the temporal resolution is not needed. The
+ * numerical dispersion grows with the time step.
+ *
+ * The tridiagonal systems span the whole global domain. Along the periodic
+ * dimensions of the decomposition, the systems are cyclic. Along the other
+ * dimensions, the field beyond the ends of the lines is taken to vanish, as at a
+ * perfect conductor. The lines are redistributed between the processes with a
+ * LineTranspose, so that each process solves complete lines.
+ *
+ * Unlike the Yee scheme, the electric and magnetic fields are both known at the
+ * full time steps. The currents are evaluated once per time step and enter both
+ * half steps explicitly. CPML layers and graded grids are not supported because
+ * the solver does not provide any stretch factors, and init() fails if either
+ * is present.
+ */
+class FDTD_ADI : public FieldSolver,
+                 public CurrentContainer,
+                 public schnek::BlockContainer<CurrentBlock>
+{
+  private:
+    /**
+     * The local grid of the electric field components,
+     * \f$\mathbf{E}\f$
+     */
+    schnek::GridRegistration Ex, Ey, Ez;
+
+    /**
+     * The local grid of the magnetic field components,
+     * \f$\mathbf{B}\f$
+     */
+    schnek::GridRegistration Bx, By, Bz;
+
+    /**
+     * The electric field at the start of the current half step
+     */
+    Grid previousE[3];
+
+    /**
+     * The redistribution of the grid lines along each dimension
+     */
+    std::unique_ptr<LineTranspose> transpose[DIMENSION];
+
+    /**
+     * True for the dimensions along which the decomposition is periodic
+     */
+    bool periodic[DIMENSION];
+
+    /**
+     * The tridiagonal system along each periodic dimension
+     */
+    std::unique_ptr<CyclicTridiagonal> system[DIMENSION];
+
+    /**
+     * The tridiagonal system along each non-periodic dimension
+     */
+    std::unique_ptr<Tridiagonal> openSystem[DIMENSION];
+
+    /**
+     * The time step for which the tridiagonal systems have been set up
+     */
+    double schemeDt;
+
+    /**
+     * The complete lines along a dimension, collected by the LineTranspose
+     */
+    std::vector<double> lines;
+
+    /**
+     * Set up the tridiagonal systems for the time step `dt`
+     */
+    void initSystems(double dt);
+
+    /**
+     * Perform one half step
+     *
+     * In the first half step (`second` false), the electric field component
+     * \f$E_c\f$ is implicit along the axis \f$c+1\f$, in the second along the axis
+     * \f$c+2\f$, modulo 3.
+     */
+    void halfStep(double dt, bool second);
+
+    /**
+     * Solve the tridiagonal systems along dimension `dim` with the right hand side
+     * stored in `field`
+     */
+    void solveLines(Field &field, size_t dim);
+  public:
+    void init();
+
+    void stepSchemeInit(double dt);
+    void stepScheme(double dt);
+};
+
+#endif
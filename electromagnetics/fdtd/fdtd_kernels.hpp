@@ -0,0 +1,981 @@
+/*
+ * fdtd_kernels.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_FDTD_KERNELS_H
+#define HUERTO_FDTD_KERNELS_H
+
+#include "../../constants.hpp"
+#include "../../types.hpp"
+
+#include <schnek/macros.hpp>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <vector>
+
+//===============================================================
+//==========  Fields of the Yee kernels
+//===============================================================
+
+/**
+ * A line of coefficients \f$c_i = f / (\kappa_i dx)\f$ along the innermost
+ * dimension
+ *
+ * The row-wise kernels read the coefficients of the stretched grid from this
+ * line. It covers the whole range of the stretch factors and is only read by the
+ * kernels, so that it can be shared by all tasks. The coefficients are computed
+ * in double precision and stored as `T`.
+ */
+template<typename T>
+class FDTD_CoefficientLine
+{
+  private:
+    std::vector<T> values;
+    ptrdiff_t lo = 0;
+    double factor = 0.0;
+    double dx = 0.0;
+  public:
+    /**
+     * Compute the coefficients unless the line already holds them for the same
+     * range of stretch factors, `f`, and `dx`
+     *
+     * The stretch factors themselves are not compared, they must not change
+     * after the line has been computed.
+     */
+    void update(const Grid1d &kappa, double f, double dx)
+    {
+      ptrdiff_t kappaLo = kappa.getLo(0);
+      size_t length = kappa.getHi(0) - kappaLo + 1;
+      if ((lo == kappaLo) && (values.size() == length) && (factor == f) && (this->dx == dx)) return;
+
+      values.resize(length);
+      for (size_t i=0; i<length; ++i) {
+        values[i] = f / (kappa(kappaLo + ptrdiff_t(i))*dx);
+      }
+      lo = kappaLo;
+      factor = f;
+      this->dx = dx;
+    }
+
+    /**
+     * A pointer to the coefficient at position `i`
+     */
+    const T *at(ptrdiff_t i) const { return values.data() + (i - lo); }
+};
+
+/**
+ * The fields and stretch factors used by the Yee kernels
+ *
+ * The value type `T` of the fields is a template parameter so that the row-wise
+ * kernels can be instantiated for single and double precision in the same build.
+ */
+template<typename T>
+struct FDTD_FieldContainerT {
+    typedef schnek::Field<T, DIMENSION, HuertoGridChecker> FieldType;
+
+    Vector dx;
+    double dt;
+    FieldType Ex, Ey, Ez;
+    FieldType Bx, By, Bz;
+    FieldType Jx, Jy, Jz;
+    Grid1d KappaDx;
+
+#ifndef HUERTO_ONE_DIM
+    Grid1d KappaDy;
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    Grid1d KappaDz;
+#endif
+
+    /// The coefficients \f$c^2 dt / (\kappa dx)\f$ of the electric field along
+    /// the innermost dimension; only read by the row-wise kernels on stretched grids
+    const FDTD_CoefficientLine<T> *CoeffE;
+
+    /// The coefficients \f$dt / (\kappa dx)\f$ of the magnetic field along the
+    /// innermost dimension; only read by the row-wise kernels on stretched grids
+    const FDTD_CoefficientLine<T> *CoeffB;
+};
+
+typedef FDTD_FieldContainerT<Real> FDTD_FieldContainer;
+
+//===============================================================
+//==========  Row-wise Yee kernels
+//===============================================================
+
+/**
+ * Scalar operations for the row-wise kernels
+ *
+ * These are also used for the remainder of a row that does not fill a whole
+ * SIMD register, so that all elements of a row are computed with the same
+ * sequence of floating point operations.
+ */
+template<typename T>
+struct FDTD_ScalarOps {
+  typedef T Vec;
+  static const ptrdiff_t width = 1;
+  static SCHNEK_INLINE Vec load(const T *p) { return *p; }
+  static SCHNEK_INLINE void store(T *p, Vec v) { *p = v; }
+  static SCHNEK_INLINE Vec set1(double a) { return T(a); }
+  static SCHNEK_INLINE Vec add(Vec a, Vec b) { return a + b; }
+  static SCHNEK_INLINE Vec sub(Vec a, Vec b) { return a - b; }
+  static SCHNEK_INLINE Vec mul(Vec a, Vec b) { return a * b; }
+};
+
+#ifdef __AVX2__
+/**
+ * AVX2 operations for the row-wise kernels, processing 4 doubles or 8 floats at a time
+ */
+template<typename T>
+struct FDTD_Avx2Ops;
+
+template<>
+struct FDTD_Avx2Ops<double> {
+  typedef __m256d Vec;
+  static const ptrdiff_t width = 4;
+  static SCHNEK_INLINE Vec load(const double *p) { return _mm256_loadu_pd(p); }
+  static SCHNEK_INLINE void store(double *p, Vec v) { _mm256_storeu_pd(p, v); }
+  static SCHNEK_INLINE Vec set1(double a) { return _mm256_set1_pd(a); }
+  static SCHNEK_INLINE Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+  static SCHNEK_INLINE Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+  static SCHNEK_INLINE Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+};
+
+template<>
+struct FDTD_Avx2Ops<float> {
+  typedef __m256 Vec;
+  static const ptrdiff_t width = 8;
+  static SCHNEK_INLINE Vec load(const float *p) { return _mm256_loadu_ps(p); }
+  static SCHNEK_INLINE void store(float *p, Vec v) { _mm256_storeu_ps(p, v); }
+  static SCHNEK_INLINE Vec set1(double a) { return _mm256_set1_ps(float(a)); }
+  static SCHNEK_INLINE Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+  static SCHNEK_INLINE Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+  static SCHNEK_INLINE Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+};
+#endif
+
+#ifdef __AVX512F__
+/**
+ * AVX-512 operations for the row-wise kernels, processing 8 doubles or 16 floats at a time
+ */
+template<typename T>
+struct FDTD_Avx512Ops;
+
+template<>
+struct FDTD_Avx512Ops<double> {
+  typedef __m512d Vec;
+  static const ptrdiff_t width = 8;
+  static SCHNEK_INLINE Vec load(const double *p) { return _mm512_loadu_pd(p); }
+  static SCHNEK_INLINE void store(double *p, Vec v) { _mm512_storeu_pd(p, v); }
+  static SCHNEK_INLINE Vec set1(double a) { return _mm512_set1_pd(a); }
+  static SCHNEK_INLINE Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+  static SCHNEK_INLINE Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+  static SCHNEK_INLINE Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+};
+
+template<>
+struct FDTD_Avx512Ops<float> {
+  typedef __m512 Vec;
+  static const ptrdiff_t width = 16;
+  static SCHNEK_INLINE Vec load(const float *p) { return _mm512_loadu_ps(p); }
+  static SCHNEK_INLINE void store(float *p, Vec v) { _mm512_storeu_ps(p, v); }
+  static SCHNEK_INLINE Vec set1(double a) { return _mm512_set1_ps(float(a)); }
+  static SCHNEK_INLINE Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+  static SCHNEK_INLINE Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+  static SCHNEK_INLINE Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+};
+#endif
+
+/**
+ * The SIMD operations used by the row-wise kernels for the value type `T`
+ *
+ * The instruction set is selected at compile time from the target architecture.
+ * Defining `HUERTO_FDTD_SCALAR` forces the scalar fallback.
+ */
+#if defined(__AVX512F__) && !defined(HUERTO_FDTD_SCALAR)
+template<typename T> using FDTD_SimdOps = FDTD_Avx512Ops<T>;
+#elif defined(__AVX2__) && !defined(HUERTO_FDTD_SCALAR)
+template<typename T> using FDTD_SimdOps = FDTD_Avx2Ops<T>;
+#else
+template<typename T> using FDTD_SimdOps = FDTD_ScalarOps<T>;
+#endif
+
+/**
+ * The terms contributing to the update of one row of a field component
+ *
+ * The update of the field \f$f\f$ at position \f$k\f$ along the row is
+ *
+ * \f[
+ * f_k \leftarrow f_k + c_j j_k + \sum_{n} c^{(n)} (p^{(n)}_k - q^{(n)}_k) + c_{l,k} (p_{l,k} - q_{l,k})
+ * \f]
+ *
+ * where the \f$c^{(n)}\f$ are constant along the row and \f$c_{l,k}\f$ is a
+ * coefficient line along the row. Where the grid is not stretched, the
+ * coefficient line is replaced by the constant `cc`. All pointers point to the
+ * first element of the row.
+ */
+template<typename T>
+struct FDTD_RowTerms {
+    double cs[2];
+    const T *ps[2];
+    const T *qs[2];
+    const T *cl;
+    double cc;
+    const T *pl;
+    const T *ql;
+    double cj;
+    const T *j;
+};
+
+template<class Ops, int scalarTerms, bool lineTerm, bool kappa, bool current, typename T>
+SCHNEK_INLINE void fdtdRowOps(ptrdiff_t begin, ptrdiff_t end, T *f, const FDTD_RowTerms<T> &t)
+{
+  typedef typename Ops::Vec Vec;
+  const Vec cj = Ops::set1(t.cj);
+  const Vec cs0 = Ops::set1(t.cs[0]);
+  const Vec cs1 = Ops::set1(t.cs[1]);
+  const Vec cc = Ops::set1(t.cc);
+
+  for (ptrdiff_t k = begin; k < end; k += Ops::width)
+  {
+    Vec update = current ? Ops::mul(cj, Ops::load(t.j + k)) : Ops::set1(0.0);
+    if (scalarTerms > 0) {
+      update = Ops::add(update, Ops::mul(cs0, Ops::sub(Ops::load(t.ps[0] + k), Ops::load(t.qs[0] + k))));
+    }
+    if (scalarTerms > 1) {
+      update = Ops::add(update, Ops::mul(cs1, Ops::sub(Ops::load(t.ps[1] + k), Ops::load(t.qs[1] + k))));
+    }
+    if (lineTerm) {
+      update = Ops::add(update,
+          Ops::mul(kappa ? Ops::load(t.cl + k) : cc, Ops::sub(Ops::load(t.pl + k), Ops::load(t.ql + k))));
+    }
+    Ops::store(f + k, Ops::add(Ops::load(f + k), update));
+  }
+}
+
+/**
+ * Update a contiguous row of `n` values of a field component
+ *
+ * The `kappa` and `current` flags select whether the coefficient line and the
+ * current are read at all. Without them, the kernel only streams the fields.
+ */
+template<int scalarTerms, bool lineTerm, bool kappa, bool current, typename T>
+SCHNEK_INLINE void fdtdRow(ptrdiff_t n, T *f, const FDTD_RowTerms<T> &t)
+{
+  if ((scalarTerms == 0) && !lineTerm && !current) return;
+  ptrdiff_t vecEnd = n - n % FDTD_SimdOps<T>::width;
+  fdtdRowOps<FDTD_SimdOps<T>, scalarTerms, lineTerm, kappa, current>(0, vecEnd, f, t);
+  fdtdRowOps<FDTD_ScalarOps<T>, scalarTerms, lineTerm, kappa, current>(vecEnd, n, f, t);
+}
+
+/**
+ * The stretch factor at position `i`, or 1 if the kernel ignores stretching
+ */
+template<bool kappa>
+SCHNEK_INLINE double fdtdKappa(const Grid1d &kappaLine, ptrdiff_t i)
+{
+  return kappa ? kappaLine(i) : 1.0;
+}
+
+/**
+ * Row-wise update of the electric field
+ *
+ * The innermost dimension of the range is processed as whole contiguous rows.
+ * The divisions by the stretched grid spacing are replaced by the precomputed
+ * coefficient line #CoeffE, \f$c^2 dt / (\kappa dx)\f$, which must be set
+ * unless `kappa` is false.
+ *
+ * Setting `kappa` or `current` to false gives a specialised kernel that assumes
+ * unit stretch factors or a vanishing current in the range and does not read them.
+ */
+template<bool kappa = true, bool current = true, typename T = Real>
+struct FDTD_StepERows : public FDTD_FieldContainerT<T> {
+  typedef FDTD_FieldContainerT<T> Container;
+  using Container::dx;
+  using Container::dt;
+  using Container::Ex;
+  using Container::Ey;
+  using Container::Ez;
+  using Container::Bx;
+  using Container::By;
+  using Container::Bz;
+  using Container::Jx;
+  using Container::Jy;
+  using Container::Jz;
+  using Container::KappaDx;
+#ifndef HUERTO_ONE_DIM
+  using Container::KappaDy;
+#endif
+#ifdef HUERTO_THREE_DIM
+  using Container::KappaDz;
+#endif
+  using Container::CoeffE;
+  using Container::CoeffB;
+
+  void operator()(const Range &range);
+};
+
+/**
+ * Row-wise update of the magnetic field
+ *
+ * The innermost dimension of the range is processed as whole contiguous rows.
+ * The divisions by the stretched grid spacing are replaced by the precomputed
+ * coefficient line #CoeffB, \f$dt / (\kappa dx)\f$, which must be set unless
+ * `kappa` is false.
+ *
+ * Setting `kappa` or `current` to false gives a specialised kernel that assumes
+ * unit stretch factors or a vanishing magnetic current in the range and does not
+ * read them.
+ */
+template<bool kappa = true, bool current = true, typename T = Real>
+struct FDTD_StepBRows : public FDTD_FieldContainerT<T> {
+  typedef FDTD_FieldContainerT<T> Container;
+  using Container::dx;
+  using Container::dt;
+  using Container::Ex;
+  using Container::Ey;
+  using Container::Ez;
+  using Container::Bx;
+  using Container::By;
+  using Container::Bz;
+  using Container::Jx;
+  using Container::Jy;
+  using Container::Jz;
+  using Container::KappaDx;
+#ifndef HUERTO_ONE_DIM
+  using Container::KappaDy;
+#endif
+#ifdef HUERTO_THREE_DIM
+  using Container::KappaDz;
+#endif
+  using Container::CoeffE;
+  using Container::CoeffB;
+
+  void operator()(const Range &range);
+};
+
+#ifdef HUERTO_ONE_DIM
+template<bool kappa, bool current, typename T>
+inline void FDTD_StepERows<kappa, current, T>::operator()(const Range &range) {
+  ptrdiff_t i0 = range.getLo(0);
+  ptrdiff_t n = range.getHi(0) - i0 + 1;
+  if (n <= 0) return;
+  const T *cex = kappa ? CoeffE->at(i0) : nullptr;
+
+  FDTD_RowTerms<T> t{};
+  t.cj = -dt/eps_0;
+
+  t.j = current ? &Jx(i0) : nullptr;
+  fdtdRow<0, false, kappa, current>(n, &Ex(i0), t);
+
+  t.cl = cex;
+  t.cc = clight2*dt/dx[0];
+  t.j = current ? &Jy(i0) : nullptr;
+  t.pl = &Bz(i0-1);
+  t.ql = &Bz(i0);
+  fdtdRow<0, true, kappa, current>(n, &Ey(i0), t);
+
+  t.j = current ? &Jz(i0) : nullptr;
+  t.pl = &By(i0);
+  t.ql = &By(i0-1);
+  fdtdRow<0, true, kappa, current>(n, &Ez(i0), t);
+}
+
+template<bool kappa, bool current, typename T>
+inline void FDTD_StepBRows<kappa, current, T>::operator()(const Range &range) {
+  ptrdiff_t i0 = range.getLo(0);
+  ptrdiff_t n = range.getHi(0) - i0 + 1;
+  if (n <= 0) return;
+  const T *cbx = kappa ? CoeffB->at(i0) : nullptr;
+
+  FDTD_RowTerms<T> t{};
+  t.cj = dt;
+  t.cl = cbx;
+  t.cc = dt/dx[0];
+
+  t.j = current ? &Jy(i0) : nullptr;
+  t.pl = &Ez(i0+1);
+  t.ql = &Ez(i0);
+  fdtdRow<0, true, kappa, current>(n, &By(i0), t);
+
+  t.j = current ? &Jz(i0) : nullptr;
+  t.pl = &Ey(i0);
+  t.ql = &Ey(i0+1);
+  fdtdRow<0, true, kappa, current>(n, &Bz(i0), t);
+}
+#endif
+
+#ifdef HUERTO_TWO_DIM
+template<bool kappa, bool current, typename T>
+inline void FDTD_StepERows<kappa, current, T>::operator()(const Range &range) {
+  ptrdiff_t j0 = range.getLo(1);
+  ptrdiff_t n = range.getHi(1) - j0 + 1;
+  if (n <= 0) return;
+  const T *cey = kappa ? CoeffE->at(j0) : nullptr;
+
+  FDTD_RowTerms<T> t{};
+  t.cj = -dt/eps_0;
+  t.cl = cey;
+  t.cc = clight2*dt/dx[1];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    double cex = clight2*dt/(fdtdKappa<kappa>(KappaDx, i)*dx[0]);
+
+    t.j = current ? &Jx(i, j0) : nullptr;
+    t.pl = &Bz(i, j0);
+    t.ql = &Bz(i, j0-1);
+    fdtdRow<0, true, kappa, current>(n, &Ex(i, j0), t);
+
+    t.j = current ? &Jy(i, j0) : nullptr;
+    t.cs[0] = -cex;
+    t.ps[0] = &Bz(i, j0);
+    t.qs[0] = &Bz(i-1, j0);
+    fdtdRow<1, false, kappa, current>(n, &Ey(i, j0), t);
+
+    t.j = current ? &Jz(i, j0) : nullptr;
+    t.cs[0] = cex;
+    t.ps[0] = &By(i, j0);
+    t.qs[0] = &By(i-1, j0);
+    t.pl = &Bx(i, j0-1);
+    t.ql = &Bx(i, j0);
+    fdtdRow<1, true, kappa, current>(n, &Ez(i, j0), t);
+  }
+}
+
+template<bool kappa, bool current, typename T>
+inline void FDTD_StepBRows<kappa, current, T>::operator()(const Range &range) {
+  ptrdiff_t j0 = range.getLo(1);
+  ptrdiff_t n = range.getHi(1) - j0 + 1;
+  if (n <= 0) return;
+  const T *cby = kappa ? CoeffB->at(j0) : nullptr;
+
+  FDTD_RowTerms<T> t{};
+  t.cj = dt;
+  t.cl = cby;
+  t.cc = dt/dx[1];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    double cbx = dt/(fdtdKappa<kappa>(KappaDx, i)*dx[0]);
+
+    t.j = current ? &Jx(i, j0) : nullptr;
+    t.pl = &Ez(i, j0);
+    t.ql = &Ez(i, j0+1);
+    fdtdRow<0, true, kappa, current>(n, &Bx(i, j0), t);
+
+    t.j = current ? &Jy(i, j0) : nullptr;
+    t.cs[0] = cbx;
+    t.ps[0] = &Ez(i+1, j0);
+    t.qs[0] = &Ez(i, j0);
+    fdtdRow<1, false, kappa, current>(n, &By(i, j0), t);
+
+    t.j = current ? &Jz(i, j0) : nullptr;
+    t.cs[0] = -cbx;
+    t.ps[0] = &Ey(i+1, j0);
+    t.qs[0] = &Ey(i, j0);
+    t.pl = &Ex(i, j0+1);
+    t.ql = &Ex(i, j0);
+    fdtdRow<1, true, kappa, current>(n, &Bz(i, j0), t);
+  }
+}
+#endif
+
+#ifdef HUERTO_THREE_DIM
+template<bool kappa, bool current, typename T>
+inline void FDTD_StepERows<kappa, current, T>::operator()(const Range &range) {
+  ptrdiff_t k0 = range.getLo(2);
+  ptrdiff_t n = range.getHi(2) - k0 + 1;
+  if (n <= 0) return;
+  const T *cez = kappa ? CoeffE->at(k0) : nullptr;
+
+  FDTD_RowTerms<T> t{};
+  t.cj = -dt/eps_0;
+  t.cl = cez;
+  t.cc = clight2*dt/dx[2];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    double cex = clight2*dt/(fdtdKappa<kappa>(KappaDx, i)*dx[0]);
+    for (ptrdiff_t j=range.getLo(1); j<=range.getHi(1); ++j) {
+      double cey = clight2*dt/(fdtdKappa<kappa>(KappaDy, j)*dx[1]);
+
+      t.j = current ? &Jx(i, j, k0) : nullptr;
+      t.cs[0] = cey;
+      t.ps[0] = &Bz(i, j, k0);
+      t.qs[0] = &Bz(i, j-1, k0);
+      t.pl = &By(i, j, k0-1);
+      t.ql = &By(i, j, k0);
+      fdtdRow<1, true, kappa, current>(n, &Ex(i, j, k0), t);
+
+      t.j = current ? &Jy(i, j, k0) : nullptr;
+      t.cs[0] = -cex;
+      t.ps[0] = &Bz(i, j, k0);
+      t.qs[0] = &Bz(i-1, j, k0);
+      t.pl = &Bx(i, j, k0);
+      t.ql = &Bx(i, j, k0-1);
+      fdtdRow<1, true, kappa, current>(n, &Ey(i, j, k0), t);
+
+      t.j = current ? &Jz(i, j, k0) : nullptr;
+      t.cs[0] = cex;
+      t.ps[0] = &By(i, j, k0);
+      t.qs[0] = &By(i-1, j, k0);
+      t.cs[1] = -cey;
+      t.ps[1] = &Bx(i, j, k0);
+      t.qs[1] = &Bx(i, j-1, k0);
+      fdtdRow<2, false, kappa, current>(n, &Ez(i, j, k0), t);
+    }
+  }
+}
+
+template<bool kappa, bool current, typename T>
+inline void FDTD_StepBRows<kappa, current, T>::operator()(const Range &range) {
+  ptrdiff_t k0 = range.getLo(2);
+  ptrdiff_t n = range.getHi(2) - k0 + 1;
+  if (n <= 0) return;
+  const T *cbz = kappa ? CoeffB->at(k0) : nullptr;
+
+  FDTD_RowTerms<T> t{};
+  t.cj = dt;
+  t.cl = cbz;
+  t.cc = dt/dx[2];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    double cbx = dt/(fdtdKappa<kappa>(KappaDx, i)*dx[0]);
+    for (ptrdiff_t j=range.getLo(1); j<=range.getHi(1); ++j) {
+      double cby = dt/(fdtdKappa<kappa>(KappaDy, j)*dx[1]);
+
+      t.j = current ? &Jx(i, j, k0) : nullptr;
+      t.cs[0] = -cby;
+      t.ps[0] = &Ez(i, j+1, k0);
+      t.qs[0] = &Ez(i, j, k0);
+      t.pl = &Ey(i, j, k0+1);
+      t.ql = &Ey(i, j, k0);
+      fdtdRow<1, true, kappa, current>(n, &Bx(i, j, k0), t);
+
+      t.j = current ? &Jy(i, j, k0) : nullptr;
+      t.cs[0] = cbx;
+      t.ps[0] = &Ez(i+1, j, k0);
+      t.qs[0] = &Ez(i, j, k0);
+      t.pl = &Ex(i, j, k0);
+      t.ql = &Ex(i, j, k0+1);
+      fdtdRow<1, true, kappa, current>(n, &By(i, j, k0), t);
+
+      t.j = current ? &Jz(i, j, k0) : nullptr;
+      t.cs[0] = cby;
+      t.ps[0] = &Ex(i, j+1, k0);
+      t.qs[0] = &Ex(i, j, k0);
+      t.cs[1] = -cbx;
+      t.ps[1] = &Ey(i+1, j, k0);
+      t.qs[1] = &Ey(i, j, k0);
+      fdtdRow<2, false, kappa, current>(n, &Bz(i, j, k0), t);
+    }
+  }
+}
+#endif
+
+//===============================================================
+//==========  Point-wise Yee kernels
+//===============================================================
+
+/**
+ * Update a single value of a field component
+ *
+ * This performs the same sequence of floating point operations as fdtdRow() does
+ * for each element of a row, so that the point-wise and the row-wise kernels
+ * give identical results. The coefficient line `t.cl` points to the coefficient
+ * of the updated value.
+ */
+template<int scalarTerms, bool lineTerm, typename T>
+SCHNEK_INLINE void fdtdPoint(T &f, const FDTD_RowTerms<T> &t)
+{
+  fdtdRowOps<FDTD_ScalarOps<T>, scalarTerms, lineTerm, true, true>(0, 1, &f, t);
+}
+
+#ifdef HUERTO_ONE_DIM
+struct FDTD_StepE : public FDTD_FieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto i = pos[0];
+    Real cex = clight2*dt/(KappaDx(i)*dx[0]);
+
+    FDTD_RowTerms<Real> t{};
+    t.cj = -dt/eps_0;
+    t.cl = &cex;
+
+    t.j = &Jx(i);
+    fdtdPoint<0, false>(Ex(i), t);
+
+    t.j = &Jy(i);
+    t.pl = &Bz(i-1);
+    t.ql = &Bz(i);
+    fdtdPoint<0, true>(Ey(i), t);
+
+    t.j = &Jz(i);
+    t.pl = &By(i);
+    t.ql = &By(i-1);
+    fdtdPoint<0, true>(Ez(i), t);
+  }
+};
+
+struct FDTD_StepB : public FDTD_FieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto i = pos[0];
+    Real cbx = dt/(KappaDx(i)*dx[0]);
+
+    FDTD_RowTerms<Real> t{};
+    t.cj = dt;
+    t.cl = &cbx;
+
+    t.j = &Jy(i);
+    t.pl = &Ez(i+1);
+    t.ql = &Ez(i);
+    fdtdPoint<0, true>(By(i), t);
+
+    t.j = &Jz(i);
+    t.pl = &Ey(i);
+    t.ql = &Ey(i+1);
+    fdtdPoint<0, true>(Bz(i), t);
+  }
+};
+#endif
+
+#ifdef HUERTO_TWO_DIM
+struct FDTD_StepE : public FDTD_FieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto [i, j] = pos;
+    double cex = clight2*dt/(KappaDx(i)*dx[0]);
+    Real cey = clight2*dt/(KappaDy(j)*dx[1]);
+
+    FDTD_RowTerms<Real> t{};
+    t.cj = -dt/eps_0;
+    t.cl = &cey;
+
+    t.j = &Jx(i, j);
+    t.pl = &Bz(i, j);
+    t.ql = &Bz(i, j-1);
+    fdtdPoint<0, true>(Ex(i, j), t);
+
+    t.j = &Jy(i, j);
+    t.cs[0] = -cex;
+    t.ps[0] = &Bz(i, j);
+    t.qs[0] = &Bz(i-1, j);
+    fdtdPoint<1, false>(Ey(i, j), t);
+
+    t.j = &Jz(i, j);
+    t.cs[0] = cex;
+    t.ps[0] = &By(i, j);
+    t.qs[0] = &By(i-1, j);
+    t.pl = &Bx(i, j-1);
+    t.ql = &Bx(i, j);
+    fdtdPoint<1, true>(Ez(i, j), t);
+  }
+};
+
+struct FDTD_StepB : public FDTD_FieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto [i, j] = pos;
+    double cbx = dt/(KappaDx(i)*dx[0]);
+    Real cby = dt/(KappaDy(j)*dx[1]);
+
+    FDTD_RowTerms<Real> t{};
+    t.cj = dt;
+    t.cl = &cby;
+
+    t.j = &Jx(i, j);
+    t.pl = &Ez(i, j);
+    t.ql = &Ez(i, j+1);
+    fdtdPoint<0, true>(Bx(i, j), t);
+
+    t.j = &Jy(i, j);
+    t.cs[0] = cbx;
+    t.ps[0] = &Ez(i+1, j);
+    t.qs[0] = &Ez(i, j);
+    fdtdPoint<1, false>(By(i, j), t);
+
+    t.j = &Jz(i, j);
+    t.cs[0] = -cbx;
+    t.ps[0] = &Ey(i+1, j);
+    t.qs[0] = &Ey(i, j);
+    t.pl = &Ex(i, j+1);
+    t.ql = &Ex(i, j);
+    fdtdPoint<1, true>(Bz(i, j), t);
+  }
+};
+#endif
+
+#ifdef HUERTO_THREE_DIM
+struct FDTD_StepE : public FDTD_FieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto [i, j, k] = pos;
+    double cex = clight2*dt/(KappaDx(i)*dx[0]);
+    double cey = clight2*dt/(KappaDy(j)*dx[1]);
+    Real cez = clight2*dt/(KappaDz(k)*dx[2]);
+
+    FDTD_RowTerms<Real> t{};
+    t.cj = -dt/eps_0;
+    t.cl = &cez;
+
+    t.j = &Jx(i, j, k);
+    t.cs[0] = cey;
+    t.ps[0] = &Bz(i, j, k);
+    t.qs[0] = &Bz(i, j-1, k);
+    t.pl = &By(i, j, k-1);
+    t.ql = &By(i, j, k);
+    fdtdPoint<1, true>(Ex(i, j, k), t);
+
+    t.j = &Jy(i, j, k);
+    t.cs[0] = -cex;
+    t.ps[0] = &Bz(i, j, k);
+    t.qs[0] = &Bz(i-1, j, k);
+    t.pl = &Bx(i, j, k);
+    t.ql = &Bx(i, j, k-1);
+    fdtdPoint<1, true>(Ey(i, j, k), t);
+
+    t.j = &Jz(i, j, k);
+    t.cs[0] = cex;
+    t.ps[0] = &By(i, j, k);
+    t.qs[0] = &By(i-1, j, k);
+    t.cs[1] = -cey;
+    t.ps[1] = &Bx(i, j, k);
+    t.qs[1] = &Bx(i, j-1, k);
+    fdtdPoint<2, false>(Ez(i, j, k), t);
+  }
+};
+
+struct FDTD_StepB : public FDTD_FieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto [i, j, k] = pos;
+    double cbx = dt/(KappaDx(i)*dx[0]);
+    double cby = dt/(KappaDy(j)*dx[1]);
+    Real cbz = dt/(KappaDz(k)*dx[2]);
+
+    FDTD_RowTerms<Real> t{};
+    t.cj = dt;
+    t.cl = &cbz;
+
+    t.j = &Jx(i, j, k);
+    t.cs[0] = -cby;
+    t.ps[0] = &Ez(i, j+1, k);
+    t.qs[0] = &Ez(i, j, k);
+    t.pl = &Ey(i, j, k+1);
+    t.ql = &Ey(i, j, k);
+    fdtdPoint<1, true>(Bx(i, j, k), t);
+
+    t.j = &Jy(i, j, k);
+    t.cs[0] = cbx;
+    t.ps[0] = &Ez(i+1, j, k);
+    t.qs[0] = &Ez(i, j, k);
+    t.pl = &Ex(i, j, k);
+    t.ql = &Ex(i, j, k+1);
+    fdtdPoint<1, true>(By(i, j, k), t);
+
+    t.j = &Jz(i, j, k);
+    t.cs[0] = cby;
+    t.ps[0] = &Ex(i, j+1, k);
+    t.qs[0] = &Ex(i, j, k);
+    t.cs[1] = -cbx;
+    t.ps[1] = &Ey(i+1, j, k);
+    t.qs[1] = &Ey(i, j, k);
+    fdtdPoint<2, false>(Bz(i, j, k), t);
+  }
+};
+#endif
+
+//===============================================================
+//==========  Fourth-order kernels
+//===============================================================
+
+/**
+ * The fourth-order staggered difference of four consecutive values
+ *
+ * The values \f$f_{-2}, f_{-1}, f_0, f_1\f$ are centred on the midpoint between
+ * \f$f_{-1}\f$ and \f$f_0\f$. The result replaces the Yee difference
+ * \f$f_0 - f_{-1}\f$.
+ */
+SCHNEK_INLINE double fdtdDiff4(double fm2, double fm1, double f0, double fp1)
+{
+  return (9.0/8.0)*(f0 - fm1) - (1.0/24.0)*(fp1 - fm2);
+}
+
+/**
+ * Update of the electric field with a fourth-order curl
+ *
+ * Each Yee difference is replaced by a difference over four points, see fdtdDiff4(),
+ * so that the stencil reaches two cells in each direction. The kernel does not read
+ * the stretch factors and must only be used where these are equal to one.
+ *
+ * Setting `current` to false gives a specialised kernel that assumes a vanishing
+ * current in the range and does not read it.
+ */
+template<bool current = true, typename T = Real>
+struct FDTD_StepE4Rows : public FDTD_FieldContainerT<T> {
+  typedef FDTD_FieldContainerT<T> Container;
+  using Container::dx;
+  using Container::dt;
+  using Container::Ex;
+  using Container::Ey;
+  using Container::Ez;
+  using Container::Bx;
+  using Container::By;
+  using Container::Bz;
+  using Container::Jx;
+  using Container::Jy;
+  using Container::Jz;
+
+  void operator()(const Range &range);
+};
+
+/**
+ * Update of the magnetic field with a fourth-order curl
+ *
+ * See FDTD_StepE4Rows.
+ */
+template<bool current = true, typename T = Real>
+struct FDTD_StepB4Rows : public FDTD_FieldContainerT<T> {
+  typedef FDTD_FieldContainerT<T> Container;
+  using Container::dx;
+  using Container::dt;
+  using Container::Ex;
+  using Container::Ey;
+  using Container::Ez;
+  using Container::Bx;
+  using Container::By;
+  using Container::Bz;
+  using Container::Jx;
+  using Container::Jy;
+  using Container::Jz;
+
+  void operator()(const Range &range);
+};
+
+#ifdef HUERTO_ONE_DIM
+template<bool current, typename T>
+inline void FDTD_StepE4Rows<current, T>::operator()(const Range &range) {
+  double cex = clight2*dt/dx[0];
+  double cj = -dt/eps_0;
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    if (current) Ex(i) += cj*Jx(i);
+
+    Ey(i) += - cex*fdtdDiff4(Bz(i-2), Bz(i-1), Bz(i), Bz(i+1))
+             + (current ? cj*Jy(i) : 0.0);
+
+    Ez(i) += cex*fdtdDiff4(By(i-2), By(i-1), By(i), By(i+1))
+             + (current ? cj*Jz(i) : 0.0);
+  }
+}
+
+template<bool current, typename T>
+inline void FDTD_StepB4Rows<current, T>::operator()(const Range &range) {
+  double cbx = dt/dx[0];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    By(i) += cbx*fdtdDiff4(Ez(i-1), Ez(i), Ez(i+1), Ez(i+2))
+             + (current ? dt*Jy(i) : 0.0);
+
+    Bz(i) += - cbx*fdtdDiff4(Ey(i-1), Ey(i), Ey(i+1), Ey(i+2))
+             + (current ? dt*Jz(i) : 0.0);
+  }
+}
+#endif
+
+#ifdef HUERTO_TWO_DIM
+template<bool current, typename T>
+inline void FDTD_StepE4Rows<current, T>::operator()(const Range &range) {
+  double cex = clight2*dt/dx[0];
+  double cey = clight2*dt/dx[1];
+  double cj = -dt/eps_0;
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    for (ptrdiff_t j=range.getLo(1); j<=range.getHi(1); ++j) {
+      Ex(i, j) += cey*fdtdDiff4(Bz(i, j-2), Bz(i, j-1), Bz(i, j), Bz(i, j+1))
+                  + (current ? cj*Jx(i, j) : 0.0);
+
+      Ey(i, j) += - cex*fdtdDiff4(Bz(i-2, j), Bz(i-1, j), Bz(i, j), Bz(i+1, j))
+                  + (current ? cj*Jy(i, j) : 0.0);
+
+      Ez(i, j) += cex*fdtdDiff4(By(i-2, j), By(i-1, j), By(i, j), By(i+1, j))
+                  - cey*fdtdDiff4(Bx(i, j-2), Bx(i, j-1), Bx(i, j), Bx(i, j+1))
+                  + (current ? cj*Jz(i, j) : 0.0);
+    }
+  }
+}
+
+template<bool current, typename T>
+inline void FDTD_StepB4Rows<current, T>::operator()(const Range &range) {
+  double cbx = dt/dx[0];
+  double cby = dt/dx[1];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    for (ptrdiff_t j=range.getLo(1); j<=range.getHi(1); ++j) {
+      Bx(i, j) += - cby*fdtdDiff4(Ez(i, j-1), Ez(i, j), Ez(i, j+1), Ez(i, j+2))
+                  + (current ? dt*Jx(i, j) : 0.0);
+
+      By(i, j) += cbx*fdtdDiff4(Ez(i-1, j), Ez(i, j), Ez(i+1, j), Ez(i+2, j))
+                  + (current ? dt*Jy(i, j) : 0.0);
+
+      Bz(i, j) += cby*fdtdDiff4(Ex(i, j-1), Ex(i, j), Ex(i, j+1), Ex(i, j+2))
+                  - cbx*fdtdDiff4(Ey(i-1, j), Ey(i, j), Ey(i+1, j), Ey(i+2, j))
+                  + (current ? dt*Jz(i, j) : 0.0);
+    }
+  }
+}
+#endif
+
+#ifdef HUERTO_THREE_DIM
+template<bool current, typename T>
+inline void FDTD_StepE4Rows<current, T>::operator()(const Range &range) {
+  double cex = clight2*dt/dx[0];
+  double cey = clight2*dt/dx[1];
+  double cez = clight2*dt/dx[2];
+  double cj = -dt/eps_0;
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    for (ptrdiff_t j=range.getLo(1); j<=range.getHi(1); ++j) {
+      for (ptrdiff_t k=range.getLo(2); k<=range.getHi(2); ++k) {
+        Ex(i, j, k) += cey*fdtdDiff4(Bz(i, j-2, k), Bz(i, j-1, k), Bz(i, j, k), Bz(i, j+1, k))
+                     - cez*fdtdDiff4(By(i, j, k-2), By(i, j, k-1), By(i, j, k), By(i, j, k+1))
+                     + (current ? cj*Jx(i, j, k) : 0.0);
+
+        Ey(i, j, k) += cez*fdtdDiff4(Bx(i, j, k-2), Bx(i, j, k-1), Bx(i, j, k), Bx(i, j, k+1))
+                     - cex*fdtdDiff4(Bz(i-2, j, k), Bz(i-1, j, k), Bz(i, j, k), Bz(i+1, j, k))
+                     + (current ? cj*Jy(i, j, k) : 0.0);
+
+        Ez(i, j, k) += cex*fdtdDiff4(By(i-2, j, k), By(i-1, j, k), By(i, j, k), By(i+1, j, k))
+                     - cey*fdtdDiff4(Bx(i, j-2, k), Bx(i, j-1, k), Bx(i, j, k), Bx(i, j+1, k))
+                     + (current ? cj*Jz(i, j, k) : 0.0);
+      }
+    }
+  }
+}
+
+template<bool current, typename T>
+inline void FDTD_StepB4Rows<current, T>::operator()(const Range &range) {
+  double cbx = dt/dx[0];
+  double cby = dt/dx[1];
+  double cbz = dt/dx[2];
+
+  for (ptrdiff_t i=range.getLo(0); i<=range.getHi(0); ++i) {
+    for (ptrdiff_t j=range.getLo(1); j<=range.getHi(1); ++j) {
+      for (ptrdiff_t k=range.getLo(2); k<=range.getHi(2); ++k) {
+        Bx(i, j, k) += cbz*fdtdDiff4(Ey(i, j, k-1), Ey(i, j, k), Ey(i, j, k+1), Ey(i, j, k+2))
+                     - cby*fdtdDiff4(Ez(i, j-1, k), Ez(i, j, k), Ez(i, j+1, k), Ez(i, j+2, k))
+                     + (current ? dt*Jx(i, j, k) : 0.0);
+
+        By(i, j, k) += cbx*fdtdDiff4(Ez(i-1, j, k), Ez(i, j, k), Ez(i+1, j, k), Ez(i+2, j, k))
+                     - cbz*fdtdDiff4(Ex(i, j, k-1), Ex(i, j, k), Ex(i, j, k+1), Ex(i, j, k+2))
+                     + (current ? dt*Jy(i, j, k) : 0.0);
+
+        Bz(i, j, k) += cby*fdtdDiff4(Ex(i, j-1, k), Ex(i, j, k), Ex(i, j+1, k), Ex(i, j+2, k))
+                     - cbx*fdtdDiff4(Ey(i-1, j, k), Ey(i, j, k), Ey(i+1, j, k), Ey(i+2, j, k))
+                     + (current ? dt*Jz(i, j, k) : 0.0);
+      }
+    }
+  }
+}
+#endif
+
+#endif // HUERTO_FDTD_KERNELS_H
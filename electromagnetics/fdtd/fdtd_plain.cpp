@@ -7,192 +7,364 @@
 
 #include "../../constants.hpp"
 #include "../../util/field_util.hpp"
+#include "../../util/parallel_iteration.hpp"
+#include "../../util/tiled_iteration.hpp"
 
 #include <schnek/grid.hpp>
 #include <schnek/tools/literature.hpp>
 
 #include "fdtd_plain.hpp"
+#include "fdtd_kernels.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 
-struct FDTD_FieldContainer {
-    Vector dx;
-    double dt;
-    Field Ex, Ey, Ez;
-    Field Bx, By, Bz;
-    Field Jx, Jy, Jz;
-    Grid1d KappaDx;
+/**
+ * Grow a range by `lowGrow` cells at the lower bound and `highGrow` cells at the
+ * upper bound in all dimensions
+ */
+inline Range growRange(const Range &range, ptrdiff_t lowGrow, ptrdiff_t highGrow) {
+  Index lo = range.getLo();
+  Index hi = range.getHi();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    lo[d] -= lowGrow;
+    hi[d] += highGrow;
+  }
+  return Range{lo, hi};
+}
 
-#ifndef HUERTO_ONE_DIM
-    Grid1d KappaDy;
-#endif
+/**
+ * True if a range does not contain any grid points
+ */
+inline bool isEmptyRange(const Range &range) {
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if (range.getLo(d) > range.getHi(d)) return true;
+  }
+  return false;
+}
 
-#ifdef HUERTO_THREE_DIM
-    Grid1d KappaDz;
+/**
+ * Set a line of stretch factors to the relative widths of the cells of a graded grid
+ *
+ * The electric stretch factors use the widths around the grid nodes along `dim`,
+ * the magnetic ones with `stagger` set use the widths around the staggered points.
+ */
+template<typename KappaRegistration>
+void applyGrading(SimulationContext &context, KappaRegistration &kappa, size_t dim, bool stagger) {
+  if (!context.isGraded()) return;
+
+  auto &decomposition = context.getDecomposition();
+#ifdef HUERTO_ONE_DIM
+  auto gridContext = decomposition.getGridContext({kappa});
+#else
+  auto gridContext = decomposition.getProjectedGridContext({kappa});
 #endif
-};
+  gridContext.forEach([&](Range1d /* range */, Grid1d &line) {
+    for (ptrdiff_t i=line.getLo(0); i<=line.getHi(0); ++i) {
+      line(i) = context.getGrading(dim, i, stagger);
+    }
+  });
+}
 
+/**
+ * The largest box inside a range in which all stretch factors are equal to one
+ *
+ * The box is empty if the stretch factors differ from one along a whole line.
+ */
+inline Range unstretchedBox(const FDTD_FieldContainer &fields, const Range &range) {
 #ifdef HUERTO_ONE_DIM
-struct FDTD_StepE : public FDTD_FieldContainer {
-  SCHNEK_INLINE void operator()(Index pos) {
-    auto i = pos[0];
-    double kappaEdx = KappaDx(i) * dx[0];
-
-    Ex(i) += - dt * Jx(i) / eps_0;
-
-    Ey(i) += dt * (
-          clight2 * (
-          - (Bz(i) - Bz(i-1)) / kappaEdx
-          )
-        - Jy(i) / eps_0
-      );
-
-    Ez(i) += dt * (
-          clight2 * (
-            (By(i) - By(i-1)) / kappaEdx
-          )
-        - Jz(i) / eps_0
-      );
+  const Grid1d *kappa[DIMENSION] = {&fields.KappaDx};
+#endif
+#ifdef HUERTO_TWO_DIM
+  const Grid1d *kappa[DIMENSION] = {&fields.KappaDx, &fields.KappaDy};
+#endif
+#ifdef HUERTO_THREE_DIM
+  const Grid1d *kappa[DIMENSION] = {&fields.KappaDx, &fields.KappaDy, &fields.KappaDz};
+#endif
+  Index lo = range.getLo();
+  Index hi = range.getHi();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    ptrdiff_t bestLo = range.getLo(d);
+    ptrdiff_t bestHi = bestLo - 1;
+    ptrdiff_t runLo = range.getLo(d);
+    for (ptrdiff_t i=range.getLo(d); i<=range.getHi(d); ++i) {
+      if ((*kappa[d])(i) != 1.0) {
+        runLo = i + 1;
+      } else if (i - runLo > bestHi - bestLo) {
+        bestLo = runLo;
+        bestHi = i;
+      }
+    }
+    lo[d] = bestLo;
+    hi[d] = bestHi;
   }
-};
+  return Range{lo, hi};
+}
 
-struct FDTD_StepB : public FDTD_FieldContainer {
-  SCHNEK_INLINE void operator()(Index pos) {
-    auto i = pos[0];
-    double kappaHdx = KappaDx(i) * dx[0];
+/**
+ * Find the bounding box of the intersections of a range with a list of boxes
+ *
+ * @return false if the range does not intersect any of the boxes
+ */
+inline bool intersectionBoundingBox(const Range &range, const std::vector<Range> &boxes, Range &result) {
+  bool found = false;
+  Index lo = range.getHi();
+  Index hi = range.getLo();
+  for (const Range &box: boxes) {
+    bool intersects = true;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      intersects = intersects
+          && (box.getLo(d) <= range.getHi(d))
+          && (box.getHi(d) >= range.getLo(d));
+    }
+    if (!intersects) continue;
+    found = true;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      lo[d] = std::min(lo[d], std::max(box.getLo(d), range.getLo(d)));
+      hi[d] = std::max(hi[d], std::min(box.getHi(d), range.getHi(d)));
+    }
+  }
+  result = Range{lo, hi};
+  return found;
+}
 
-    By(i) += dt * (
-          (Ez(i+1) - Ez(i)) / kappaHdx
-        + Jy(i)
-      );
+/**
+ * Split a range into the part inside a box and up to `2*DIMENSION` slabs
+ * covering the remainder
+ *
+ * The function `func(subRange, inside)` is called for every non-empty part.
+ */
+template<class Func>
+void splitRange(const Range &range, const Range &box, Func func) {
+  Index lo = range.getLo();
+  Index hi = range.getHi();
+  Index boxLo, boxHi;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    boxLo[d] = std::max(lo[d], box.getLo(d));
+    boxHi[d] = std::min(hi[d], box.getHi(d));
+    if (boxLo[d] > boxHi[d]) {
+      func(range, false);
+      return;
+    }
+  }
 
-    Bz(i) += dt * (
-        - (Ey(i+1) - Ey(i)) / kappaHdx
-        + Jz(i)
-      );
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if (boxLo[d] > lo[d]) {
+      Index slabHi = hi;
+      slabHi[d] = boxLo[d] - 1;
+      func(Range{lo, slabHi}, false);
+    }
+    if (boxHi[d] < hi[d]) {
+      Index slabLo = lo;
+      slabLo[d] = boxHi[d] + 1;
+      func(Range{slabLo, hi}, false);
+    }
+    lo[d] = boxLo[d];
+    hi[d] = boxHi[d];
   }
+  func(Range{lo, hi}, true);
+}
+
+/**
+ * The currents entering the update of a field
+ *
+ * The kernels read the summed currents inside the `ranges`. The `patches` are
+ * added directly to the updated field components `x`, `y`, `z`, scaled by
+ * `factor`, once the kernel has been applied to a range.
+ */
+struct FDTD_Currents {
+    const std::vector<Range> *ranges;
+    const std::vector<CurrentPatch> *patches;
+    Field x, y, z;
+    double factor;
 };
-#endif
 
-#ifdef HUERTO_TWO_DIM
-struct FDTD_StepE : public FDTD_FieldContainer {
-  SCHNEK_INLINE void operator()(Index pos) {
-    auto [i, j] = pos;
-    double kappaEdx = KappaDx(i)*dx[0];
-    double kappaEdy = KappaDy(j)*dx[1];
-
-    Ex(i, j) += dt*(
-          clight2*(
-            (Bz(i, j) - Bz(i, j-1))/kappaEdy
-          )
-        - Jx(i, j) / eps_0
-      );
-
-    Ey(i, j) += dt*(
-          clight2*(
-          - (Bz(i, j) - Bz(i-1, j))/kappaEdx
-          )
-        - Jy(i, j) / eps_0
-      );
-
-    Ez(i, j) += dt*(
-          clight2*(
-            (By(i, j) - By(i-1, j))/kappaEdx
-          - (Bx(i, j) - Bx(i, j-1))/kappaEdy
-          )
-        - Jz(i, j) / eps_0
-      );
-  }
+/**
+ * Wrap a row-wise kernel into a task that sweeps over the tiles of its range
+ * and then adds the current patches
+ */
+template<class RowFunc>
+BlockTaskList::Task tiledTask(RowFunc func, const Index &tileShape, FDTD_Currents currents)
+{
+  // The task is shared between the threads, so each call works on copies of
+  // the kernel and the current grids
+  return [func, tileShape, currents](const Range &range) {
+    RowFunc rowFunc = func;
+    FieldTileIterator::forEachTile(range, tileShape, rowFunc);
+    if (!currents.patches->empty()) {
+      FDTD_Currents c = currents;
+      CurrentContainer::addCurrentPatches(*c.patches, range, c.x, c.y, c.z, c.factor);
+    }
+  };
+}
+
+/**
+ * The kernel `StepFunc` specialised for unit stretch factors
+ *
+ * The kernels of the unstretched part of the grid only take the `current` flag.
+ */
+template<template<bool, bool, typename> class StepFunc>
+struct UnstretchedStep
+{
+    template<bool current, typename T>
+    using type = StepFunc<false, current, T>;
 };
 
-struct FDTD_StepB : public FDTD_FieldContainer {
-  SCHNEK_INLINE void operator()(Index pos) {
-    auto [i, j] = pos;
-    double kappaHdx = KappaDx(i)*dx[0];
-    double kappaHdy = KappaDy(j)*dx[1];
+/**
+ * Add the update of a range to a task list, with kernels specialised for the sub-ranges
+ *
+ * The range is split into the part with unit stretch factors and the CPML
+ * region. Each of these is split further depending on whether it carries any
+ * current. The kernels only read the stretch factors and the currents where
+ * they are needed. The sub-ranges are independent and can be updated concurrently.
+ * Each task sweeps over tiles of the shape `tileShape`.
+ *
+ * The part with unit stretch factors is updated with `InnerFunc`, which may use a
+ * higher order stencil than `StepFunc`.
+ */
+template<template<bool, bool, typename> class StepFunc,
+         template<bool, typename> class InnerFunc>
+void specialisedStep(const FDTD_FieldContainer &fields,
+                     const Range &range,
+                     const FDTD_Currents &currents,
+                     const Index &tileShape,
+                     BlockTaskList &tasks)
+{
+  splitRange(range, unstretchedBox(fields, range), [&](const Range &subRange, bool unstretched) {
+    Range currentBox;
+    bool hasCurrent = intersectionBoundingBox(subRange, *currents.ranges, currentBox);
+    if (!unstretched) {
+      if (hasCurrent) {
+        tasks.add(subRange, tiledTask(StepFunc<true, true, Real>{fields}, tileShape, currents));
+      } else {
+        tasks.add(subRange, tiledTask(StepFunc<true, false, Real>{fields}, tileShape, currents));
+      }
+      return;
+    }
+
+    splitRange(subRange, currentBox, [&](const Range &part, bool inCurrent) {
+      if (hasCurrent && inCurrent) {
+        tasks.add(part, tiledTask(InnerFunc<true, Real>{fields}, tileShape, currents));
+      } else {
+        tasks.add(part, tiledTask(InnerFunc<false, Real>{fields}, tileShape, currents));
+      }
+    });
+  });
+}
 
-    Bx(i, j) += dt*(
-        - (Ez(i, j+1) - Ez(i, j))/kappaHdy
-        + Jx(i, j)
-      );
+/**
+ * The ghost faces of a Yee field component read by the curl in the FDTD update
+ *
+ * The component `component` is only differentiated along the other coordinate
+ * axes. A component that is staggered in a dimension is differenced with its lower
+ * neighbour, \f$F_i - F_{i-1}\f$. An unstaggered component is differenced with its
+ * upper neighbour, \f$F_{i+1} - F_i\f$.
+ */
+inline HaloFaces yeeCurlFaces(const Stagger &stagger, size_t component) {
+  HaloFaces faces;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    faces.low[d] = (d != component) && stagger[d];
+    faces.high[d] = (d != component) && !stagger[d];
+  }
+  return faces;
+}
 
-    By(i, j) += dt*(
-          (Ez(i+1, j) - Ez(i, j))/kappaHdx
-        + Jy(i, j)
-      );
+/**
+ * Update a range and, if `exchange` is given, exchange the ghost cells of the
+ * updated field
+ *
+ * With an exchange, the shell of width `shellWidth` at the boundary of the range
+ * is updated first. These are the cells sent to the neighbours. The exchange is
+ * then started and the interior is updated while the messages are in flight.
+ * The exchange has to be finished by the caller.
+ *
+ * See specialisedStep() for the kernels `StepFunc` and `InnerFunc`.
+ */
+template<template<bool, bool, typename> class StepFunc,
+         template<bool, typename> class InnerFunc>
+void updateRange(const FDTD_FieldContainer &fields,
+                 const Range &range,
+                 const FDTD_Currents &currents,
+                 const Index &tileShape,
+                 ptrdiff_t shellWidth,
+                 HaloExchange *exchange,
+                 bool threaded)
+{
+  if (isEmptyRange(range)) {
+    if (exchange) exchange->start();
+    return;
+  }
 
-    Bz(i, j) += dt*(
-          (Ex(i, j+1) - Ex(i, j))/kappaHdy
-        - (Ey(i+1, j) - Ey(i, j))/kappaHdx
-        + Jz(i, j)
-      );
+  BlockTaskList tasks;
+  if (!exchange) {
+    specialisedStep<StepFunc, InnerFunc>(fields, range, currents, tileShape, tasks);
+    tasks.run(threaded);
+    return;
   }
-};
-#endif
 
-#ifdef HUERTO_THREE_DIM
-struct FDTD_StepE : public FDTD_FieldContainer {
-  SCHNEK_INLINE void operator()(Index pos) {
-    auto [i, j, k] = pos;
-    double kappaEdx = KappaDx(i)*dx[0];
-    double kappaEdy = KappaDy(j)*dx[1];
-    double kappaEdz = KappaDz(k)*dx[2];
-
-    Ex(i, j, k) += dt * (
-          clight2 * (
-            (Bz(i, j, k) - Bz(i, j-1, k)) / kappaEdy
-          - (By(i, j, k) - By(i, j, k-1)) / kappaEdz
-          )
-        - Jx(i, j, k) / eps_0
-      );
-
-    Ey(i, j, k) += dt * (
-          clight2 * (
-            (Bx(i, j, k) - Bx(i, j, k-1)) / kappaEdz
-          - (Bz(i, j, k) - Bz(i-1, j, k)) / kappaEdx
-          )
-        - Jy(i, j, k) / eps_0
-      );
-
-    Ez(i, j, k) += dt * (
-          clight2 * (
-            (By(i, j, k) - By(i-1, j, k)) / kappaEdx
-          - (Bx(i, j, k) - Bx(i, j-1, k)) / kappaEdy
-          )
-        - Jz(i, j, k) / eps_0
-      );
+  std::vector<Range> interior;
+  splitRange(range, growRange(range, -shellWidth, -shellWidth), [&](const Range &part, bool inside) {
+    if (inside) {
+      interior.push_back(part);
+    } else {
+      specialisedStep<StepFunc, InnerFunc>(fields, part, currents, tileShape, tasks);
+    }
+  });
+  tasks.run(threaded);
+
+  exchange->start();
+
+  for (const Range &part: interior) {
+    specialisedStep<StepFunc, InnerFunc>(fields, part, currents, tileShape, tasks);
   }
-};
+  tasks.run(threaded);
+}
 
-struct FDTD_StepB : public FDTD_FieldContainer {
-  SCHNEK_INLINE void operator()(Index pos) {
-    auto [i, j, k] = pos;
-    double kappaHdx = KappaDx(i)*dx[0];
-    double kappaHdy = KappaDy(j)*dx[1];
-    double kappaHdz = KappaDz(k)*dx[2];
-
-    Bx(i, j, k) += dt * (
-          (Ey(i, j, k+1) - Ey(i, j, k)) / kappaHdz
-        - (Ez(i, j+1, k) - Ez(i, j, k)) / kappaHdy
-        + Jx(i, j, k)
-      );
-
-    By(i, j, k) += dt * (
-          (Ez(i+1, j, k) - Ez(i, j, k)) / kappaHdx
-        - (Ex(i, j, k+1) - Ex(i, j, k)) / kappaHdz
-        + Jy(i, j, k)
-      );
-
-    Bz(i, j, k) += dt*(
-          (Ex(i, j+1, k) - Ex(i, j, k)) / kappaHdy
-        - (Ey(i+1, j, k) - Ey(i, j, k)) / kappaHdx
-        + Jz(i, j, k)
-      );
+/**
+ * Update a range with the Yee kernel `StepFunc` or, if `stencilOrder` is 4, with
+ * the fourth-order kernel `StepFunc4` wherever the grid is not stretched
+ *
+ * See updateRange() for the remaining arguments.
+ */
+template<template<bool, bool, typename> class StepFunc,
+         template<bool, typename> class StepFunc4>
+void updateRangeOrder(int stencilOrder,
+                      const FDTD_FieldContainer &fields,
+                      const Range &range,
+                      const FDTD_Currents &currents,
+                      const Index &tileShape,
+                      ptrdiff_t shellWidth,
+                      HaloExchange *exchange,
+                      bool threaded)
+{
+  if (stencilOrder == 4) {
+    updateRange<StepFunc, StepFunc4>(fields, range, currents, tileShape, shellWidth, exchange, threaded);
+  } else {
+    updateRange<StepFunc, UnstretchedStep<StepFunc>::template type>(fields, range, currents, tileShape,
+                                                                     shellWidth, exchange, threaded);
   }
-};
-#endif
+}
 
+void FDTD_Plain::initParameters(schnek::BlockParameters &blockPars)
+{
+  FieldSolver::initParameters(blockPars);
+
+  blockPars.addParameter("overlapExchange", &overlapExchange, 0);
+  blockPars.addParameter("oneSidedExchange", &oneSidedExchange, 0);
+  blockPars.addParameter("threaded", &threaded, 0);
+  blockPars.addArrayParameter("tileShape", tileShape, 0);
+  blockPars.addParameter("autotuneTiles", &autotuneTiles, 0);
+  blockPars.addParameter("sparseCurrents", &useSparseCurrents, 1);
+  blockPars.addParameter("trackActivity", &trackActivity, 0);
+  blockPars.addParameter("activityThreshold", &activityThreshold, 0.0);
+  blockPars.addParameter("stencilOrder", &stencilOrder, 2);
+}
 
 void FDTD_Plain::registerData()
 {
@@ -264,6 +436,27 @@ void FDTD_Plain::init()
   setField1D<Grid1d>(decomposition, KappaHdz, 1.0, 2U);
 #endif
 
+  // Uniform grids keep the unit stretch factors so that the specialised kernels
+  // can be used
+#ifdef HUERTO_ONE_DIM
+  applyGrading(getContext(), KappaEdx, 0, false);
+  applyGrading(getContext(), KappaHdx, 0, true);
+#endif
+#ifdef HUERTO_TWO_DIM
+  applyGrading(getContext(), KappaEdx, 0, false);
+  applyGrading(getContext(), KappaEdy, 1, false);
+  applyGrading(getContext(), KappaHdx, 0, true);
+  applyGrading(getContext(), KappaHdy, 1, true);
+#endif
+#ifdef HUERTO_THREE_DIM
+  applyGrading(getContext(), KappaEdx, 0, false);
+  applyGrading(getContext(), KappaEdy, 1, false);
+  applyGrading(getContext(), KappaEdz, 2, false);
+  applyGrading(getContext(), KappaHdx, 0, true);
+  applyGrading(getContext(), KappaHdy, 1, true);
+  applyGrading(getContext(), KappaHdz, 2, true);
+#endif
+
   retrieveData("Ex", Ex);
   retrieveData("Ey", Ey);
   retrieveData("Ez", Ez);
@@ -277,7 +470,48 @@ void FDTD_Plain::init()
     current->initCurrents(*this);
   }
 
-  CurrentContainer::init(getContext());
+  if ((stencilOrder != 2) && (stencilOrder != 4)) {
+    throw std::runtime_error("FDTD_Plain: the stencil order must be 2 or 4");
+  }
+  if (getContext().getGhostCells() < stencilOrder/2) {
+    throw std::runtime_error("FDTD_Plain: the stencil needs at least stencilOrder/2 ghost cells");
+  }
+  if (stencilOrder == 4) {
+    // The weights of the fourth-order difference add up to 9/8 + 1/24 = 7/6,
+    // which lowers the Courant limit of the Yee scheme by a factor of 6/7
+    Vector dx = getContext().getDx();
+    double invDx2 = 0.0;
+    for (size_t d=0; d<DIMENSION; ++d) invDx2 += 1.0/(dx[d]*dx[d]);
+    if (clight*getContext().getDt()*std::sqrt(invDx2) > 6.0/7.0) {
+      throw std::runtime_error("FDTD_Plain: the time step exceeds the Courant limit of the fourth-order stencil");
+    }
+  }
+
+  tracking = false;
+  getContext().registerShiftable(this);
+  if (oneSidedExchange && (stencilOrder == 4)) {
+    std::cerr << "FDTD_Plain: the fourth-order stencil reads the ghost cells on both sides, "
+              << "falling back to the full exchange" << std::endl;
+    oneSidedExchange = 0;
+  }
+
+  // The currents and the absorbing layers use the same setting as the field update
+  CurrentContainer::init(getContext(), useSparseCurrents, threaded);
+
+  // With sparse currents the kernels never read the sums. The patches are
+  // added by the tasks instead
+  currentRanges.clear();
+  magCurrentRanges.clear();
+  if (!sparseCurrents) collectCurrentRanges(currents, currentRanges);
+  if (!sparseMagCurrents) collectCurrentRanges(magCurrents, magCurrentRanges);
+
+#ifdef HUERTO_ONE_DIM
+  // Bx is constant in 1D, the summed Mx is never read by the kernel either
+  magCurrentPatches.erase(
+      std::remove_if(magCurrentPatches.begin(), magCurrentPatches.end(),
+                     [](const CurrentPatch &patch) { return patch.component == 0; }),
+      magCurrentPatches.end());
+#endif
 
   schnek::LiteratureArticle Yee1966("Yee1966", "Yee, K",
       "Numerical solution of initial boundary value problems involving Maxwell's equations in isotropic media.",
@@ -288,7 +522,42 @@ void FDTD_Plain::init()
       Yee1966);
 }
 
+void FDTD_Plain::collectCurrentRanges(const CurrentList &currentList, std::vector<Range> &ranges)
+{
+  auto &decomposition = getContext().getDecomposition();
+  ranges.clear();
+  for (pCurrent current: currentList) {
+    for (int c=0; c<3; ++c) {
+      for (schnek::GridRegistration reg: current->getComponentGrids(c)) {
+        decomposition.getGridContext({reg}).forEach([&](Range range, Grid &) {
+          ranges.push_back(range);
+        });
+      }
+    }
+  }
+}
+
 void FDTD_Plain::stepSchemeInit(double dt) {
+  for (size_t d=0; d<DIMENSION; ++d) {
+    tiles[d] = tileShape[d];
+  }
+
+  if (overlapExchange || oneSidedExchange || trackActivity) {
+    auto &decomposition = getContext().getDecomposition();
+    std::vector<HaloFaces> eFaces;
+    std::vector<HaloFaces> bFaces;
+    if (oneSidedExchange) {
+      eFaces = {yeeCurlFaces(exStaggerYee, 0), yeeCurlFaces(eyStaggerYee, 1), yeeCurlFaces(ezStaggerYee, 2)};
+      bFaces = {yeeCurlFaces(bxStaggerYee, 0), yeeCurlFaces(byStaggerYee, 1), yeeCurlFaces(bzStaggerYee, 2)};
+    }
+    exchangeE = std::make_unique<HaloExchange>(decomposition,
+        std::initializer_list<schnek::GridRegistration>{Ex, Ey, Ez}, eFaces);
+    exchangeB = std::make_unique<HaloExchange>(decomposition,
+        std::initializer_list<schnek::GridRegistration>{Bx, By, Bz}, bFaces);
+  }
+
+  initActivity();
+
   for (pCurrent current: this->magCurrents) {
     current->stepSchemeInit(dt);
   }
@@ -298,6 +567,161 @@ void FDTD_Plain::stepSchemeInit(double dt) {
   for (pCurrent current: this->currents) {
     current->stepSchemeInit(dt);
   }
+
+  if (autotuneTiles) {
+    tuneTiles();
+  }
+}
+
+void FDTD_Plain::tuneTiles()
+{
+  Range localRange;
+  getContext().getDecomposition().getGridContext({Ex}).forEach([&](Range range, Field &) {
+    localRange = range;
+  });
+
+  // The currents are summed once so that the update with a vanishing time step
+  // leaves the fields unchanged
+  sumCurrents();
+  sumMagCurrents();
+  tiles = autotuneTileShape(tileShapeCandidates(localRange), [&](const Index &shape) {
+    tiles = shape;
+    updateE(0.0, nullptr);
+    updateB(0.0, nullptr);
+  });
+}
+
+void FDTD_Plain::initActivity()
+{
+  tracking = trackActivity;
+  if (!tracking) return;
+
+  auto &decomposition = getContext().getDecomposition();
+
+  // Start with an empty box and extend it by every active point and range
+  Index lo, hi;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    lo[d] = std::numeric_limits<ptrdiff_t>::max();
+    hi[d] = std::numeric_limits<ptrdiff_t>::min();
+  }
+  auto include = [&](const Index &rangeLo, const Index &rangeHi) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      lo[d] = std::min(lo[d], rangeLo[d]);
+      hi[d] = std::max(hi[d], rangeHi[d]);
+    }
+  };
+
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz});
+  gridContext.forEach([&](
+    Range range,
+    Field &ex, Field &ey, Field &ez,
+    Field &bx, Field &by, Field &bz) {
+      for (Field *field: {&ex, &ey, &ez, &bx, &by, &bz}) {
+        schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos) {
+          if (fabs((*field)[pos]) > activityThreshold) include(pos, pos);
+        });
+      }
+  });
+
+  for (const CurrentList *currentList: {&currents, &magCurrents}) {
+    for (pCurrent current: *currentList) {
+      if (current->vanishesWithFields()) continue;
+      for (int c=0; c<3; ++c) {
+        for (schnek::GridRegistration reg: current->getComponentGrids(c)) {
+          decomposition.getGridContext({reg}).forEach([&](Range range, Grid &) {
+            include(range.getLo(), range.getHi());
+          });
+        }
+      }
+    }
+  }
+
+  // Combine the boxes of all processes, the minimum is found as the maximum of
+  // the negated lower bounds
+  std::vector<long> localBox(2*DIMENSION);
+  std::vector<long> globalBox(2*DIMENSION);
+  for (size_t d=0; d<DIMENSION; ++d) {
+    localBox[d] = -lo[d];
+    localBox[DIMENSION + d] = hi[d];
+  }
+  MPI_Comm comm = decomposition.getComm();
+  MPI_Allreduce(localBox.data(), globalBox.data(), 2*DIMENSION, MPI_LONG, MPI_MAX, comm);
+  for (size_t d=0; d<DIMENSION; ++d) {
+    lo[d] = -globalBox[d];
+    hi[d] = globalBox[DIMENSION + d];
+  }
+  activeRange = Range{lo, hi};
+
+  int dims[DIMENSION], periods[DIMENSION], coords[DIMENSION];
+  MPI_Cart_get(comm, DIMENSION, dims, periods, coords);
+  for (size_t d=0; d<DIMENSION; ++d) periodic[d] = periods[d];
+
+  if (exchangeE) exchangeE->setActiveRange(activeRange);
+  if (exchangeB) exchangeB->setActiveRange(activeRange);
+}
+
+void FDTD_Plain::growActivity()
+{
+  // Without any active points the fields remain zero
+  if (!tracking || isEmptyRange(activeRange)) return;
+
+  Range global = getContext().getDecomposition().getGlobalRange();
+  Index lo = activeRange.getLo();
+  Index hi = activeRange.getHi();
+  bool everywhere = true;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    // The curl reaches one cell in each direction, or two for the fourth-order stencil
+    lo[d] -= stencilOrder/2;
+    hi[d] += stencilOrder/2;
+
+    // Along periodic dimensions, activity that reaches the boundary re-enters
+    // on the other side. Otherwise it stops at the boundary.
+    bool outside = (lo[d] < global.getLo(d)) || (hi[d] > global.getHi(d));
+    if (periodic[d] && outside) {
+      lo[d] = global.getLo(d);
+      hi[d] = global.getHi(d);
+    } else {
+      lo[d] = std::max(lo[d], global.getLo(d));
+      hi[d] = std::min(hi[d], global.getHi(d));
+    }
+    everywhere = everywhere && (lo[d] == global.getLo(d)) && (hi[d] == global.getHi(d));
+  }
+  activeRange = Range{lo, hi};
+
+  if (everywhere) {
+    tracking = false;
+    if (exchangeE) exchangeE->clearActiveRange();
+    if (exchangeB) exchangeB->clearActiveRange();
+  } else {
+    if (exchangeE) exchangeE->setActiveRange(activeRange);
+    if (exchangeB) exchangeB->setActiveRange(activeRange);
+  }
+}
+
+void FDTD_Plain::shiftWindow(size_t dim)
+{
+  if (!tracking || isEmptyRange(activeRange)) return;
+
+  Range global = getContext().getDecomposition().getGlobalRange();
+  Index lo = activeRange.getLo();
+  Index hi = activeRange.getHi();
+  lo[dim] = std::max<ptrdiff_t>(lo[dim] - stencilOrder/2, global.getLo(dim));
+  hi[dim] = global.getHi(dim);
+  activeRange = Range{lo, hi};
+
+  if (exchangeE) exchangeE->setActiveRange(activeRange);
+  if (exchangeB) exchangeB->setActiveRange(activeRange);
+}
+
+Range FDTD_Plain::activePart(const Range &range)
+{
+  if (!tracking) return range;
+  Index lo, hi;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    lo[d] = std::max(range.getLo(d), activeRange.getLo(d));
+    hi[d] = std::min(range.getHi(d), activeRange.getHi(d));
+  }
+  return Range{lo, hi};
 }
 
 void FDTD_Plain::stepScheme(double dt) {
@@ -317,90 +741,132 @@ void FDTD_Plain::stepScheme(double dt) {
 void FDTD_Plain::stepE(double dt)
 {
   sumCurrents();
+  growActivity();
+  updateE(dt, overlapExchange ? exchangeE.get() : nullptr);
+
+  if (exchangeE) {
+    if (!overlapExchange) exchangeE->start();
+    exchangeE->finish();
+  } else {
+    getContext().getDecomposition().exchange({Ex, Ey, Ez});
+  }
+}
+
+void FDTD_Plain::updateE(double dt, HaloExchange *exchange)
+{
   auto &decomposition = getContext().getDecomposition();
+  std::vector<Field> sums = getLocalCurrentSums(false);
 
 #ifdef HUERTO_ONE_DIM
-  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz, KappaEdx});
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, KappaEdx});
   gridContext.forEach([&](
     Range range, 
     Field &ex, Field &ey, Field &ez, 
     Field &bx, Field &by, Field &bz,
-    Field &jx, Field &jy, Field &jz,
     Grid1d &kappaEdx) {
-      FDTD_StepE stepEFunc{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, jx, jy, jz, kappaEdx};
-      FieldIterator::forEach(range, stepEFunc);
+      coeffE.update(kappaEdx, clight2*dt, getContext().getDx()[0]);
+      FDTD_FieldContainer fields{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, sums[0], sums[1], sums[2], kappaEdx,
+                                 &coeffE, nullptr};
+      FDTD_Currents fieldCurrents{&currentRanges, &currentPatches, ex, ey, ez, -dt/eps_0};
+      updateRangeOrder<FDTD_StepERows, FDTD_StepE4Rows>(stencilOrder, fields, activePart(range), fieldCurrents,
+                                                        tiles, getContext().getGhostCells(), exchange, threaded);
   });
 #endif
 #ifdef HUERTO_TWO_DIM
-  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz, KappaEdx, KappaEdy});
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, KappaEdx, KappaEdy});
   gridContext.forEach([&](
     Range range, 
     Field &ex, Field &ey, Field &ez, 
     Field &bx, Field &by, Field &bz,
-    Field &jx, Field &jy, Field &jz,
     Grid1d &kappaEdx, Grid1d &kappaEdy) {
-      FDTD_StepE stepEFunc{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, jx, jy, jz, kappaEdx, kappaEdy};
-      FieldIterator::forEach(range, stepEFunc);
+      coeffE.update(kappaEdy, clight2*dt, getContext().getDx()[1]);
+      FDTD_FieldContainer fields{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, sums[0], sums[1], sums[2], kappaEdx, kappaEdy,
+                                 &coeffE, nullptr};
+      FDTD_Currents fieldCurrents{&currentRanges, &currentPatches, ex, ey, ez, -dt/eps_0};
+      updateRangeOrder<FDTD_StepERows, FDTD_StepE4Rows>(stencilOrder, fields, activePart(range), fieldCurrents,
+                                                        tiles, getContext().getGhostCells(), exchange, threaded);
   });
 #endif
 #ifdef HUERTO_THREE_DIM
-  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, Jx, Jy, Jz, KappaEdx, KappaEdy, KappaEdz});
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, KappaEdx, KappaEdy, KappaEdz});
   gridContext.forEach([&](
     Range range, 
     Field &ex, Field &ey, Field &ez, 
     Field &bx, Field &by, Field &bz,
-    Field &jx, Field &jy, Field &jz,
     Grid1d &kappaEdx, Grid1d &kappaEdy, Grid1d &kappaEdz) {
-      FDTD_StepE stepEFunc{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, jx, jy, jz, kappaEdx, kappaEdy, kappaEdz};
-      FieldIterator::forEach(range, stepEFunc);
+      coeffE.update(kappaEdz, clight2*dt, getContext().getDx()[2]);
+      FDTD_FieldContainer fields{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, sums[0], sums[1], sums[2], kappaEdx, kappaEdy, kappaEdz,
+                                 &coeffE, nullptr};
+      FDTD_Currents fieldCurrents{&currentRanges, &currentPatches, ex, ey, ez, -dt/eps_0};
+      updateRangeOrder<FDTD_StepERows, FDTD_StepE4Rows>(stencilOrder, fields, activePart(range), fieldCurrents,
+                                                        tiles, getContext().getGhostCells(), exchange, threaded);
   });
 #endif
-
-  decomposition.exchange({Ex, Ey, Ez});
 }
 
 void FDTD_Plain::stepB(double dt)
 {
   sumMagCurrents();
+  growActivity();
+  updateB(dt, overlapExchange ? exchangeB.get() : nullptr);
+
+  if (exchangeB) {
+    if (!overlapExchange) exchangeB->start();
+    exchangeB->finish();
+  } else {
+    getContext().getDecomposition().exchange({Bx, By, Bz});
+  }
+}
+
+void FDTD_Plain::updateB(double dt, HaloExchange *exchange)
+{
   auto &decomposition = getContext().getDecomposition();
+  std::vector<Field> sums = getLocalCurrentSums(true);
 
 #ifdef HUERTO_ONE_DIM
-  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, Mx, My, Mz, KappaHdx});
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, KappaHdx});
   gridContext.forEach([&](
     Range range, 
     Field &ex, Field &ey, Field &ez, 
     Field &bx, Field &by, Field &bz,
-    Field &mx, Field &my, Field &mz,
     Grid1d &kappaHdx) {
-      FDTD_StepB stepBFunc{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, mx, my, mz, kappaHdx};
-      FieldIterator::forEach(range, stepBFunc);
+      coeffB.update(kappaHdx, dt, getContext().getDx()[0]);
+      FDTD_FieldContainer fields{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, sums[0], sums[1], sums[2], kappaHdx,
+                                 nullptr, &coeffB};
+      FDTD_Currents fieldCurrents{&magCurrentRanges, &magCurrentPatches, bx, by, bz, dt};
+      updateRangeOrder<FDTD_StepBRows, FDTD_StepB4Rows>(stencilOrder, fields, activePart(range), fieldCurrents,
+                                                        tiles, getContext().getGhostCells(), exchange, threaded);
   });
 #endif
 #ifdef HUERTO_TWO_DIM
-  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, Mx, My, Mz, KappaHdx, KappaHdy});
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, KappaHdx, KappaHdy});
   gridContext.forEach([&](
     Range range, 
     Field &ex, Field &ey, Field &ez, 
     Field &bx, Field &by, Field &bz,
-    Field &mx, Field &my, Field &mz,
     Grid1d &kappaHdx, Grid1d &kappaHdy) {
-      FDTD_StepB stepBFunc{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, mx, my, mz, kappaHdx, kappaHdy};
-      FieldIterator::forEach(range, stepBFunc);
+      coeffB.update(kappaHdy, dt, getContext().getDx()[1]);
+      FDTD_FieldContainer fields{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, sums[0], sums[1], sums[2], kappaHdx, kappaHdy,
+                                 nullptr, &coeffB};
+      FDTD_Currents fieldCurrents{&magCurrentRanges, &magCurrentPatches, bx, by, bz, dt};
+      updateRangeOrder<FDTD_StepBRows, FDTD_StepB4Rows>(stencilOrder, fields, activePart(range), fieldCurrents,
+                                                        tiles, getContext().getGhostCells(), exchange, threaded);
   });
 #endif
 #ifdef HUERTO_THREE_DIM
-  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, Mx, My, Mz, KappaHdx, KappaHdy, KappaHdz});
+  auto gridContext = decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz, KappaHdx, KappaHdy, KappaHdz});
   gridContext.forEach([&](
     Range range, 
     Field &ex, Field &ey, Field &ez, 
     Field &bx, Field &by, Field &bz,
-    Field &mx, Field &my, Field &mz,
     Grid1d &kappaHdx, Grid1d &kappaHdy, Grid1d &kappaHdz) {
-      FDTD_StepB stepBFunc{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, mx, my, mz, kappaHdx, kappaHdy, kappaHdz};
-      FieldIterator::forEach(range, stepBFunc);
+      coeffB.update(kappaHdz, dt, getContext().getDx()[2]);
+      FDTD_FieldContainer fields{getContext().getDx(), dt, ex, ey, ez, bx, by, bz, sums[0], sums[1], sums[2], kappaHdx, kappaHdy, kappaHdz,
+                                 nullptr, &coeffB};
+      FDTD_Currents fieldCurrents{&magCurrentRanges, &magCurrentPatches, bx, by, bz, dt};
+      updateRangeOrder<FDTD_StepBRows, FDTD_StepB4Rows>(stencilOrder, fields, activePart(range), fieldCurrents,
+                                                        tiles, getContext().getGhostCells(), exchange, threaded);
   });
 #endif
-
-  decomposition.exchange({Bx, By, Bz});
 }
 
@@ -11,22 +11,77 @@
 #ifndef HUERTO_FDTD_PLAIN_H
 #define HUERTO_FDTD_PLAIN_H
 
+#include "fdtd_kernels.hpp"
+
 #include "../fieldsolver.hpp"
 #include "../current.hpp"
 
+#include "../../simulation/halo_exchange.hpp"
 #include "../../simulation/simulation_context.hpp"
 
 #include "../../types.hpp"
 
+#include <memory>
+#include <vector>
+
 
 /**
  * Plain FDTD field solver
  *
  * The solver allows any number of electric and "magnetic" currents as well as
+ * stretch factors for the grid cell size.
+ *
+ * On a graded grid, see GridGrading, the stretch factors also hold the widths of
+ * the grid cells relative to the uniform grid spacing.
+ *
+ * Each local range is split into regions with and without stretch factors and
+ * currents. Specialised kernels are used in each region so that the stretch
+ * factors and current grids are only read where they are needed.
+ *
+ * Setting the `overlapExchange` parameter to 1 overlaps the halo exchange with
+ * the field update. The cells next to the boundary of the local grid are updated
+ * first. Non-blocking messages are then sent while the interior is updated.
+ *
+ * Setting the `oneSidedExchange` parameter to 1 restricts the halo exchange to
+ * the ghost cells read by the Yee curl. The magnetic field is only needed below
+ * and the electric field only above the local grid, in the dimensions along which
+ * the component is differentiated. This roughly halves the communication volume
+ * but leaves the other ghost cells stale. It should only be used when no other
+ * part of the simulation reads these.
+ *
+ * When compiled with OpenMP, the sub-blocks of the local grid are split into
+ * slabs. Setting the `threaded` parameter to 1 updates these concurrently with
+ * multiple threads. The setting is passed on to the currents and the absorbing
+ * boundaries of this solver only. It defaults to 0, which suits one MPI process
+ * per core.
+ *
+ * Each slab is swept in tiles so that the neighbouring planes read by the curl
+ * stay in the cache. The `tileShape` parameter sets the tile size in each
+ * dimension, where 0 means that the dimension is not tiled. Setting the
+ * `autotuneTiles` parameter to 1 times the field update for a number of tile
+ * shapes on the local grid at startup and chooses the fastest.
+ *
+ * Unless a volume current is present, the currents are not summed into full-domain
+ * grids. Instead, each current is added to the fields on its own range right after
+ * the kernel has updated that range. Setting the `sparseCurrents` parameter to 0
+ * restores the summation.
+ *
+ * Setting the `stencilOrder` parameter to 4 replaces the Yee curl by a fourth-order
+ * staggered difference over four points wherever the stretch factors are equal to
+ * one. This reduces the numerical dispersion so that a coarser grid can be used.
+ * The stretched regions, including the CPML layers, keep the second-order curl that
+ * the absorbing layers are built on. The stencil reaches two cells, so at least two
+ * ghost cells are needed. The stable time step is reduced by a factor of 6/7
+ * compared to the Yee scheme, and a longer time step is rejected. The fourth-order
+ * stencil cannot be combined with the one-sided exchange.
+ *
+ * The solver follows a MovingWindow. The active region is moved down with the
+ * fields and extended to the leading edge, where new field values may enter.
  */
 class FDTD_Plain : public FieldSolver,
                    public CurrentContainer,
-                   public schnek::BlockContainer<CurrentBlock>
+                   public schnek::BlockContainer<CurrentBlock>,
+                   public WindowShiftable
 {
   private:
     FDTD_Plain *self;
@@ -85,6 +140,152 @@ class FDTD_Plain : public FieldSolver,
     schnek::ProjectedGridRegistration<1, 3> KappaHdx, KappaHdy, KappaHdz;
 #endif
 
+    /**
+     * Overlap the halo exchange with the update of the interior if non-zero
+     */
+    int overlapExchange;
+
+    /**
+     * Only exchange the ghost cells read by the field update if non-zero
+     */
+    int oneSidedExchange;
+
+    /**
+     * Update the fields and currents with multiple threads if non-zero
+     */
+    int threaded;
+
+    /**
+     * The size of the tiles of the field update in each dimension as given in the
+     * setup file; zero means the dimension is not tiled
+     */
+    schnek::Array<int, DIMENSION> tileShape;
+
+    /**
+     * Choose the tile shape by timing the field update at startup if non-zero
+     */
+    int autotuneTiles;
+
+    /**
+     * The tile shape used by the field update
+     */
+    Index tiles;
+
+    /**
+     * Add the currents directly to the fields instead of summing them if non-zero
+     */
+    int useSparseCurrents;
+
+    /**
+     * Restrict the field update to the region reached by the fields if non-zero
+     */
+    int trackActivity;
+
+    /**
+     * Field values up to this magnitude are treated as zero when the initial
+     * active region is determined
+     */
+    double activityThreshold;
+
+    /**
+     * The order of the spatial differences of the curl, either 2 or 4
+     */
+    int stencilOrder;
+
+    /**
+     * True while the field update is restricted to #activeRange
+     */
+    bool tracking;
+
+    /**
+     * The global range outside of which all fields and source currents vanish
+     */
+    Range activeRange;
+
+    /**
+     * True for the dimensions along which the decomposition is periodic
+     */
+    bool periodic[DIMENSION];
+
+    /**
+     * The split-phase exchange of the electric field; only used when
+     * #overlapExchange, #oneSidedExchange, or #trackActivity is set
+     */
+    std::unique_ptr<HaloExchange> exchangeE;
+
+    /**
+     * The split-phase exchange of the magnetic field; only used when
+     * #overlapExchange, #oneSidedExchange, or #trackActivity is set
+     */
+    std::unique_ptr<HaloExchange> exchangeB;
+
+    /**
+     * The coefficient lines of the row-wise kernels on the stretched grid,
+     * recomputed when the time step changes
+     */
+    FDTD_CoefficientLine<Real> coeffE, coeffB;
+
+    /**
+     * The local ranges of the registered electric currents
+     */
+    std::vector<Range> currentRanges;
+
+    /**
+     * The local ranges of the registered magnetic currents
+     */
+    std::vector<Range> magCurrentRanges;
+
+    /**
+     * Store the local ranges of the currents in a list
+     */
+    void collectCurrentRanges(const CurrentList &currentList, std::vector<Range> &ranges);
+
+    /**
+     * Update the electric field without summing the currents
+     *
+     * If `exchange` is given, the halo exchange is started once the boundary
+     * cells have been updated.
+     */
+    void updateE(double dt, HaloExchange *exchange);
+
+    /**
+     * Update the magnetic field without summing the currents
+     *
+     * If `exchange` is given, the halo exchange is started once the boundary
+     * cells have been updated.
+     */
+    void updateB(double dt, HaloExchange *exchange);
+
+    /**
+     * Choose the fastest tile shape for the local grid
+     *
+     * The field update is timed with a vanishing time step so that the fields
+     * are left unchanged.
+     */
+    void tuneTiles();
+
+    /**
+     * Find the initial active region from the non-vanishing fields and the
+     * ranges of the source currents
+     */
+    void initActivity();
+
+    /**
+     * Grow the active region by the reach of one half step of the Yee scheme
+     *
+     * Tracking stops once the region covers the whole domain.
+     */
+    void growActivity();
+
+    /**
+     * The part of a local range that has to be updated
+     */
+    Range activePart(const Range &range);
+  protected:
+    /**
+     * Initialise the parameters available through the setup file
+     */
+    void initParameters(schnek::BlockParameters &blockPars);
   public:
 
     /**
@@ -99,6 +300,11 @@ class FDTD_Plain : public FieldSolver,
 
     void stepE(double dt);
     void stepB(double dt);
+
+    /**
+     * Move the active region with the window
+     */
+    void shiftWindow(size_t dim) override;
 };
 
 #endif
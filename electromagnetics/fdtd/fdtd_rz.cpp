@@ -0,0 +1,280 @@
+/*
+ * fdtd_rz.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "fdtd_rz.hpp"
+
+#include "../../constants.hpp"
+#include "../../util/field_util.hpp"
+
+#include <schnek/grid.hpp>
+#include <schnek/macros.hpp>
+#include <schnek/tools/literature.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#ifdef HUERTO_TWO_DIM
+
+namespace {
+
+/**
+ * The fields, stretch factors, and geometry used by the cylindrical Yee kernels
+ *
+ * The index `axis` is the global grid index of the axis in the second dimension.
+ */
+struct FDTD_RZFieldContainer {
+    Vector dx;
+    double dt;
+    int m;
+    ptrdiff_t axis;
+    Field Ez, Er, Et;
+    Field Bz, Br, Bt;
+    Grid1d KappaDz, KappaDr;
+};
+
+/**
+ * Update the electric field of an azimuthal mode
+ *
+ * \f$E_z\f$ and \f$E_\theta\f$ lie on the axis. Near the axis a mode behaves as
+ * \f$r^{|m-1|}\f$ for \f$E_\theta\f$ and \f$r^m\f$ for \f$E_z\f$, so only
+ * \f$E_z\f$ of mode 0 and \f$E_\theta\f$ of mode 1 are non-zero on the axis.
+ */
+struct FDTD_RZStepE : public FDTD_RZFieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto [i, j] = pos;
+    double dr = dx[1];
+    double kappaEdz = KappaDz(i)*dx[0];
+    double kappaEdr = KappaDr(j)*dr;
+    double r = (j - axis)*dr;
+    double rHalf = r + 0.5*dr;
+
+    Er(i, j) += dt*clight2*(
+          m*Bz(i, j)/rHalf
+        - (Bt(i, j) - Bt(i-1, j))/kappaEdz
+      );
+
+    if (j > axis) {
+      double rLow = r - 0.5*dr;
+      Ez(i, j) += dt*clight2*(
+            (rHalf*Bt(i, j) - rLow*Bt(i, j-1))/(r*kappaEdr)
+          - m*Br(i, j)/r
+        );
+
+      Et(i, j) += dt*clight2*(
+            (Br(i, j) - Br(i-1, j))/kappaEdz
+          - (Bz(i, j) - Bz(i, j-1))/kappaEdr
+        );
+    } else {
+      // The flux of B_theta through the axis cell of radius dr/2
+      Ez(i, j) = (m == 0) ? Ez(i, j) + dt*clight2*4.0*Bt(i, j)/dr : 0.0;
+
+      // B_z of mode 1 is odd in r
+      Et(i, j) = (m == 1)
+          ? Et(i, j) + dt*clight2*((Br(i, j) - Br(i-1, j))/kappaEdz - 2.0*Bz(i, j)/dr)
+          : 0.0;
+    }
+  }
+};
+
+/**
+ * Update the magnetic field of an azimuthal mode
+ *
+ * \f$B_r\f$ lies on the axis and is only non-zero for mode 1.
+ */
+struct FDTD_RZStepB : public FDTD_RZFieldContainer {
+  SCHNEK_INLINE void operator()(Index pos) {
+    auto [i, j] = pos;
+    double dr = dx[1];
+    double kappaHdz = KappaDz(i)*dx[0];
+    double kappaHdr = KappaDr(j)*dr;
+    double r = (j - axis)*dr;
+    double rHalf = r + 0.5*dr;
+
+    Bz(i, j) += dt*(
+        - ((r + dr)*Et(i, j+1) - r*Et(i, j))/(rHalf*kappaHdr)
+        - m*Er(i, j)/rHalf
+      );
+
+    Bt(i, j) += dt*(
+          (Ez(i, j+1) - Ez(i, j))/kappaHdr
+        - (Er(i+1, j) - Er(i, j))/kappaHdz
+      );
+
+    if (j > axis) {
+      Br(i, j) += dt*(
+            m*Ez(i, j)/r
+          + (Et(i+1, j) - Et(i, j))/kappaHdz
+        );
+    } else {
+      // E_z of mode 1 grows linearly with r
+      Br(i, j) = (m == 1)
+          ? Br(i, j) + dt*(Ez(i, j+1)/dr + (Et(i+1, j) - Et(i, j))/kappaHdz)
+          : 0.0;
+    }
+  }
+};
+
+/**
+ * The summed currents on a local range as a list of patches
+ */
+std::vector<CurrentPatch> sumPatches(const Range &range, std::vector<Field> &sums)
+{
+  return {CurrentPatch{range, sums[0], 0}, CurrentPatch{range, sums[1], 1}, CurrentPatch{range, sums[2], 2}};
+}
+
+}
+
+void FDTD_RZ::initParameters(schnek::BlockParameters &blockPars)
+{
+  FieldSolver::initParameters(blockPars);
+
+  blockPars.addParameter("mode", &m, 0);
+}
+
+void FDTD_RZ::registerData()
+{
+  addData("KappaEdx", KappaEdx);
+  addData("KappaEdy", KappaEdy);
+
+  addData("KappaHdx", KappaHdx);
+  addData("KappaHdy", KappaHdy);
+}
+
+void FDTD_RZ::init()
+{
+  SimulationEntity::init(this);
+
+  if (getContext().isGraded()) {
+    throw std::runtime_error("FDTD_RZ: graded grids are not supported by the cylindrical solver");
+  }
+  if (m < 0) {
+    throw std::runtime_error("FDTD_RZ: the azimuthal mode number must not be negative");
+  }
+
+  auto &decomposition = getContext().getDecomposition();
+
+  KappaEdx = decomposition.registerFieldProjection(schnek::GridFactory<Grid1d>{}, {0});
+  KappaEdy = decomposition.registerFieldProjection(schnek::GridFactory<Grid1d>{}, {1});
+  setField1D<Grid1d>(decomposition, KappaEdx, 1.0, 0U);
+  setField1D<Grid1d>(decomposition, KappaEdy, 1.0, 1U);
+
+  KappaHdx = decomposition.registerFieldProjection(schnek::GridFactory<Grid1d>{}, {0});
+  KappaHdy = decomposition.registerFieldProjection(schnek::GridFactory<Grid1d>{}, {1});
+  setField1D<Grid1d>(decomposition, KappaHdx, 1.0, 0U);
+  setField1D<Grid1d>(decomposition, KappaHdy, 1.0, 1U);
+
+  retrieveData("Ex", Ez);
+  retrieveData("Ey", Er);
+  retrieveData("Ez", Et);
+
+  retrieveData("Bx", Bz);
+  retrieveData("By", Br);
+  retrieveData("Bz", Bt);
+
+  for (pCurrentBlock current: schnek::BlockContainer<CurrentBlock>::childBlocks())
+  {
+    current->initCurrents(*this);
+  }
+
+  // A stretched radius would also have to enter the terms proportional to m/r.
+  // Without it, the layer at the outer radius becomes unstable.
+  decomposition.getProjectedGridContext({KappaEdy, KappaHdy}).forEach(
+    [&](Range1d range, Grid1d &kappaE, Grid1d &kappaH) {
+      Field1dIterator::forEach(range, [&](Index1d posIndex) {
+        ptrdiff_t pos = posIndex[0];
+        if ((kappaE(pos) != 1.0) || (kappaH(pos) != 1.0)) {
+          throw std::runtime_error("FDTD_RZ: the absorbing layers must not stretch the radius, kappaMax must be 1");
+        }
+      });
+  });
+
+  CurrentContainer::init(getContext());
+
+  schnek::LiteratureArticle Lifschitz2009("Lifschitz2009", "Lifschitz, A. F. et al.",
+      "Particle-in-Cell modelling of laser-plasma interaction using Fourier decomposition",
+      "Journal of Computational Physics", "2009", "228", "1803--1814");
+
+  schnek::LiteratureManager::instance().addReference(
+      "The electromagnetic fields are expanded in azimuthal modes in cylindrical geometry.",
+      Lifschitz2009);
+}
+
+void FDTD_RZ::stepE(double dt)
+{
+  sumCurrents();
+  std::vector<Field> sums = getLocalCurrentSums(false);
+
+  auto &decomposition = getContext().getDecomposition();
+  ptrdiff_t axis = decomposition.getGlobalRange().getLo(1);
+
+  auto gridContext = decomposition.getGridContext({Ez, Er, Et, Bz, Br, Bt, KappaEdx, KappaEdy});
+  gridContext.forEach([&](
+    Range range,
+    Field &ez, Field &er, Field &et,
+    Field &bz, Field &br, Field &bt,
+    Grid1d &kz, Grid1d &kr) {
+      FDTD_RZStepE step{getContext().getDx(), dt, m, axis, ez, er, et, bz, br, bt, kz, kr};
+      FieldIterator::forEach(range, step);
+      addCurrentPatches(sparseCurrents ? currentPatches : sumPatches(range, sums),
+                        range, ez, er, et, -dt/eps_0);
+  });
+
+  decomposition.exchange({Ez, Er, Et});
+}
+
+void FDTD_RZ::stepB(double dt)
+{
+  sumMagCurrents();
+  std::vector<Field> sums = getLocalCurrentSums(true);
+
+  auto &decomposition = getContext().getDecomposition();
+  ptrdiff_t axis = decomposition.getGlobalRange().getLo(1);
+
+  auto gridContext = decomposition.getGridContext({Ez, Er, Et, Bz, Br, Bt, KappaHdx, KappaHdy});
+  gridContext.forEach([&](
+    Range range,
+    Field &ez, Field &er, Field &et,
+    Field &bz, Field &br, Field &bt,
+    Grid1d &kz, Grid1d &kr) {
+      FDTD_RZStepB step{getContext().getDx(), dt, m, axis, ez, er, et, bz, br, bt, kz, kr};
+      FieldIterator::forEach(range, step);
+      addCurrentPatches(sparseMagCurrents ? magCurrentPatches : sumPatches(range, sums),
+                        range, bz, br, bt, dt);
+  });
+
+  decomposition.exchange({Bz, Br, Bt});
+}
+
+void FDTD_RZ::stepSchemeInit(double dt)
+{
+  for (pCurrent current: this->magCurrents) {
+    current->stepSchemeInit(dt);
+  }
+
+  stepB(0.5*dt);
+
+  for (pCurrent current: this->currents) {
+    current->stepSchemeInit(dt);
+  }
+}
+
+void FDTD_RZ::stepScheme(double dt)
+{
+  for (pCurrent current: this->currents) {
+    current->stepScheme(dt);
+  }
+
+  stepE(dt);
+
+  for (pCurrent current: this->magCurrents) {
+    current->stepScheme(dt);
+  }
+
+  stepB(dt);
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * fdtd_rz.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+
+#ifndef HUERTO_FDTD_RZ_H
+#define HUERTO_FDTD_RZ_H
+
+#include "../fieldsolver.hpp"
+#include "../current.hpp"
+
+#include "../../simulation/simulation_context.hpp"
+
+#include "../../types.hpp"
+
+#ifdef HUERTO_TWO_DIM
+
+/**
+ * FDTD solver for cylindrical geometry and a single azimuthal mode
+ *
+ * The first dimension of the 2D simulation is the axial coordinate \f$z\f$ and
+ * the second dimension is the radius \f$r\f$. The axis lies on the lower boundary
+ * of the global grid in the second dimension. The fields are those of the
+ * azimuthal mode \f$m\f$ set by the `mode` parameter,
+ *
+ * \f[
+ * (E_r, E_z, B_\theta) \propto \cos m\theta, \quad
+ * (E_\theta, B_r, B_z) \propto \sin m\theta.
+ * \f]
+ *
+ * The components are stored in the grids of EMFields, with \f$(x, y, z)\f$
+ * standing for \f$(z, r, \theta)\f$. The Maxwell equations do not couple different
+ * modes, so the solution is exact for setups with this symmetry. Mode 0 describes
+ * axisymmetric fields, e.g. radially polarised beams. Mode 1 describes beams that
+ * are linearly polarised perpendicular to the axis, where \f$E_\theta = -E_r\f$.
+ *
+ * The initial fields of EMFields and the currents of all child blocks are taken
+ * to be the amplitudes of the mode. No absorbing layer is placed on the axis. The
+ * CPMLBorder layers must not stretch the grid, i.e. `kappaMax` has to be 1,
+ * because the terms proportional to \f$m/r\f$ are not stretched.
+ *
+ * The terms proportional to \f$m/r\f$ reduce the stable time step of the higher
+ * modes near the axis. The CFL factor may have to be lowered for \f$m > 1\f$.
+ */
+class FDTD_RZ : public FieldSolver,
+                public CurrentContainer,
+                public schnek::BlockContainer<CurrentBlock>
+{
+  private:
+    /// The electric field components \f$E_z, E_r, E_\theta\f$
+    schnek::GridRegistration Ez, Er, Et;
+
+    /// The magnetic field components \f$B_z, B_r, B_\theta\f$
+    schnek::GridRegistration Bz, Br, Bt;
+
+    /**
+     * Stretch factors for the grid cell size of the electric fields; used by CPML
+     * schemes.
+     */
+    schnek::ProjectedGridRegistration<1, 2> KappaEdx, KappaEdy;
+
+    /**
+     * Stretch factors for the grid cell size of the magnetic fields; used by CPML
+     * schemes.
+     */
+    schnek::ProjectedGridRegistration<1, 2> KappaHdx, KappaHdy;
+
+    /**
+     * The azimuthal mode number
+     */
+    int m;
+
+    /**
+     * Advance the electric field
+     */
+    void stepE(double dt);
+
+    /**
+     * Advance the magnetic field
+     */
+    void stepB(double dt);
+  protected:
+    /**
+     * Initialise the parameters available through the setup file
+     */
+    void initParameters(schnek::BlockParameters &blockPars);
+  public:
+    /**
+     * The lower boundary in \f$r\f$ is the axis and is closed
+     */
+    bool isOpenBoundary(Direction dir) override { return dir != south; }
+
+    /**
+     * Registers the helper grids for sharing
+     */
+    void registerData();
+
+    void init();
+
+    void stepSchemeInit(double dt);
+    void stepScheme(double dt);
+};
+
+#endif
+
+#endif
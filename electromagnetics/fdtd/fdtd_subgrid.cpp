@@ -0,0 +1,409 @@
+/*
+ * fdtd_subgrid.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "fdtd_subgrid.hpp"
+#include "fdtd_kernels.hpp"
+#include "fdtd_plain.hpp"
+
+#include "../em_fields.hpp"
+
+#include "../../util/field_util.hpp"
+
+#include <schnek/grid.hpp>
+#include <schnek/tools/literature.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+const Stagger eStagger[3] = {exStaggerYee, eyStaggerYee, ezStaggerYee};
+const Stagger bStagger[3] = {bxStaggerYee, byStaggerYee, bzStaggerYee};
+
+/**
+ * Assemble the fields of the fine grid in the layout of the Yee kernels
+ */
+FDTD_FieldContainer makeFineFields(const Vector &dx,
+                                   double dt,
+                                   Field *E,
+                                   Field *B,
+                                   Field *J,
+                                   Grid1d *kappa)
+{
+#ifdef HUERTO_ONE_DIM
+  return FDTD_FieldContainer{dx, dt, E[0], E[1], E[2], B[0], B[1], B[2], J[0], J[1], J[2], kappa[0]};
+#endif
+#ifdef HUERTO_TWO_DIM
+  return FDTD_FieldContainer{dx, dt, E[0], E[1], E[2], B[0], B[1], B[2], J[0], J[1], J[2], kappa[0], kappa[1]};
+#endif
+#ifdef HUERTO_THREE_DIM
+  return FDTD_FieldContainer{dx, dt, E[0], E[1], E[2], B[0], B[1], B[2], J[0], J[1], J[2], kappa[0], kappa[1], kappa[2]};
+#endif
+}
+
+/**
+ * The MPI data type matching the field values
+ */
+const MPI_Datatype realType = std::is_same<Real, float>::value ? MPI_FLOAT : MPI_DOUBLE;
+
+} // namespace
+
+//===============================================================
+//==========  FDTD_Subgrid
+//===============================================================
+
+void FDTD_Subgrid::initParameters(schnek::BlockParameters &blockPars)
+{
+  CurrentBlock::initParameters(blockPars);
+
+  blockPars.addArrayParameter("lo", lo, 0);
+  blockPars.addArrayParameter("hi", hi, 0);
+  blockPars.addParameter("ratio", &ratio, 3);
+}
+
+void FDTD_Subgrid::init()
+{
+  schnek::ChildBlock<CurrentBlock>::init();
+
+  schnek::LiteratureArticle Chevalier1997("Chevalier1997", "Chevalier, M. W. and Luebbers, R. J. and Cable, V. P.",
+      "FDTD local grid with material traverse",
+      "IEEE Transactions on Antennas and Propagation", "1997", "45", "411--421");
+
+  schnek::LiteratureManager::instance().addReference(
+      "Local mesh refinement of the FDTD scheme with time sub-stepping", Chevalier1997);
+}
+
+void FDTD_Subgrid::initCurrents(CurrentContainer &container)
+{
+  if (dynamic_cast<FDTD_Plain*>(&container) == nullptr) {
+    throw std::runtime_error("FDTD_Subgrid: the patch can only be used with the FDTD_Plain solver");
+  }
+  if (getContext().isGraded()) {
+    throw std::runtime_error("FDTD_Subgrid: refined patches cannot be used on a graded grid");
+  }
+  if (ratio < 3 || ratio % 2 == 0) {
+    throw std::runtime_error("FDTD_Subgrid: the refinement ratio must be an odd number of at least 3");
+  }
+
+  Range gdomain = getContext().getDecomposition().getGlobalRange();
+  Index patchLo, patchHi;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    patchLo[d] = lo[d];
+    patchHi[d] = hi[d];
+    // The coupling reads the coarse points just outside the patch
+    if (patchLo[d] > patchHi[d] || patchLo[d] <= gdomain.getLo(d) || patchHi[d] >= gdomain.getHi(d)) {
+      throw std::runtime_error("FDTD_Subgrid: the patch must be a non-empty range inside the simulation domain");
+    }
+  }
+
+  container.addMagCurrent(
+    std::make_shared<FDTD_SubgridCurrent>(Range{patchLo, patchHi}, ratio, boost::ref(*this))
+  );
+}
+
+//===============================================================
+//==========  FDTD_SubgridCurrent
+//===============================================================
+
+FDTD_SubgridCurrent::FDTD_SubgridCurrent(const Range &patch, int ratio, CurrentBlock &block)
+  : patch(patch), ratio(ratio), block(block), active(false)
+{}
+
+void FDTD_SubgridCurrent::init()
+{
+  block.retrieveData("Ex", E[0]);
+  block.retrieveData("Ey", E[1]);
+  block.retrieveData("Ez", E[2]);
+  block.retrieveData("Bx", B[0]);
+  block.retrieveData("By", B[1]);
+  block.retrieveData("Bz", B[2]);
+
+  auto &decomposition = block.getContext().getDecomposition();
+  patchReg = decomposition.registerField(schnek::GridFactory<Grid>{}, patch);
+  comm = decomposition.getComm();
+
+  active = false;
+  decomposition.getGridContext({patchReg}).forEach([&](Range range, Grid &) {
+    localPatch = range;
+    active = true;
+  });
+
+  if (!active) return;
+
+  // Each coarse cell i of the patch holds the fine cells from (i - lo)*ratio to
+  // (i - lo)*ratio + ratio - 1
+  Vector dx = block.getContext().getDx();
+  Index fineLo, fineHi, updateLo, updateHi, lo, hi;
+  Vector domainLo, domainHi;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    fineDx[d] = dx[d] / ratio;
+    fineLo[d] = (localPatch.getLo(d) - patch.getLo(d))*ratio;
+    fineHi[d] = (localPatch.getHi(d) - patch.getLo(d))*ratio + ratio - 1;
+
+    // The neighbours across a cut through the patch hold the adjacent part of
+    // the patch, with the same extent in the other dimensions
+    outerLo[d] = localPatch.getLo(d) == patch.getLo(d);
+    outerHi[d] = localPatch.getHi(d) == patch.getHi(d);
+    MPI_Cart_shift(comm, d, 1, &neighbourLo[d], &neighbourHi[d]);
+    if (outerLo[d]) neighbourLo[d] = MPI_PROC_NULL;
+    if (outerHi[d]) neighbourHi[d] = MPI_PROC_NULL;
+    updateLo[d] = outerLo[d] ? fineLo[d] + 1 : fineLo[d];
+    updateHi[d] = outerHi[d] ? fineHi[d] - 1 : fineHi[d];
+
+    lo[d] = fineLo[d] - 1;
+    hi[d] = fineHi[d] + 1;
+    domainLo[d] = patch.getLo(d)*dx[d] + fineLo[d]*fineDx[d];
+    domainHi[d] = patch.getLo(d)*dx[d] + (fineHi[d] + 1)*fineDx[d];
+
+    fineKappa[d].resize(Grid1d::IndexType{lo[d]}, Grid1d::IndexType{hi[d]});
+    for (ptrdiff_t i=lo[d]; i<=hi[d]; ++i) {
+      fineKappa[d](i) = 1.0;
+    }
+  }
+  fineRange = Range{fineLo, fineHi};
+  updateRange = Range{updateLo, updateHi};
+
+  Domain domain{domainLo, domainHi};
+  for (int c=0; c<3; ++c) {
+    fineE[c].resize(lo, hi, domain, eStagger[c], 1);
+    fineB[c].resize(lo, hi, domain, bStagger[c], 1);
+    fineJ[c].resize(lo, hi, domain, eStagger[c], 1);
+
+    SetField<Field> set{fineJ[c], 0.0};
+    FieldIterator::forEach(Range{lo, hi}, set);
+  }
+}
+
+double FDTD_SubgridCurrent::interpolate(const Grid &previous,
+                                        const Field &coarse,
+                                        double frac,
+                                        const Index &pos,
+                                        const Stagger &stagger)
+{
+  // The position of the fine point in units of the coarse grid index of the component
+  Index base;
+  double w[DIMENSION];
+  for (size_t d=0; d<DIMENSION; ++d) {
+    double shift = stagger[d] ? 0.5 : 0.0;
+    double x = patch.getLo(d) + (pos[d] + shift)/ratio - shift;
+    base[d] = ptrdiff_t(std::floor(x));
+    w[d] = x - base[d];
+  }
+
+  double value = 0.0;
+  for (int corner=0; corner < (1 << DIMENSION); ++corner) {
+    Index p = base;
+    double weight = 1.0;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      if (corner & (1 << d)) {
+        ++p[d];
+        weight *= w[d];
+      } else {
+        weight *= 1.0 - w[d];
+      }
+    }
+    // Skipping vanishing weights keeps the stencil inside the coarse ghost cells
+    if (weight == 0.0) continue;
+    value += weight*((1.0 - frac)*previous[p] + frac*coarse[p]);
+  }
+  return value;
+}
+
+void FDTD_SubgridCurrent::setBoundary(double frac)
+{
+  for (int c=0; c<3; ++c) {
+    Field &fine = fineE[c];
+
+    // The slabs at the outer faces of the patch, each reduced by the slabs of
+    // the previous dimensions so that they do not overlap
+    Index restLo = fine.getLo();
+    Index restHi = fine.getHi();
+    for (size_t d=0; d<DIMENSION; ++d) {
+      for (bool upper: {false, true}) {
+        if (!(upper ? outerHi[d] : outerLo[d])) continue;
+        Index lo = restLo;
+        Index hi = restHi;
+        if (upper) {
+          lo[d] = fineRange.getHi(d);
+        } else {
+          hi[d] = fineRange.getLo(d);
+        }
+        FieldIterator::forEach(Range{lo, hi}, [&](Index pos) {
+          fine[pos] = interpolate(previousE[c], coarseE[c], frac, pos, eStagger[c]);
+        });
+      }
+      if (outerLo[d]) restLo[d] = fineRange.getLo(d) + 1;
+      if (outerHi[d]) restHi[d] = fineRange.getHi(d) - 1;
+    }
+  }
+}
+
+void FDTD_SubgridCurrent::exchangeFine(Field *fields)
+{
+  Index lo = fields[0].getLo();
+  Index hi = fields[0].getHi();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if ((neighbourLo[d] == MPI_PROC_NULL) && (neighbourHi[d] == MPI_PROC_NULL)) continue;
+
+    // The planes span the ghost cells of the other dimensions, so that the
+    // edges are filled by the exchange along the later dimensions
+    size_t count = 3;
+    for (size_t e=0; e<DIMENSION; ++e) {
+      if (e != d) count *= hi[e] - lo[e] + 1;
+    }
+    std::vector<Real> sendBuffer(count);
+    std::vector<Real> recvBuffer(count);
+
+    for (int dir: {-1, 1}) {
+      // Send the outermost inner plane towards dir and receive the ghost plane on the opposite side
+      int dest = (dir > 0) ? neighbourHi[d] : neighbourLo[d];
+      int source = (dir > 0) ? neighbourLo[d] : neighbourHi[d];
+      Index sendLo = lo, sendHi = hi, recvLo = lo, recvHi = hi;
+      sendLo[d] = sendHi[d] = (dir > 0) ? fineRange.getHi(d) : fineRange.getLo(d);
+      recvLo[d] = recvHi[d] = (dir > 0) ? lo[d] : hi[d];
+
+      if (dest != MPI_PROC_NULL) {
+        size_t n = 0;
+        for (int c=0; c<3; ++c) {
+          schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{sendLo, sendHi}, [&](const Index &pos) {
+            sendBuffer[n++] = fields[c][pos];
+          });
+        }
+      }
+
+      int tag = 2*d + (dir > 0 ? 1 : 0);
+      MPI_Sendrecv(sendBuffer.data(), count, realType, dest, tag,
+                   recvBuffer.data(), count, realType, source, tag,
+                   comm, MPI_STATUS_IGNORE);
+
+      if (source != MPI_PROC_NULL) {
+        size_t n = 0;
+        for (int c=0; c<3; ++c) {
+          schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{recvLo, recvHi}, [&](const Index &pos) {
+            fields[c][pos] = recvBuffer[n++];
+          });
+        }
+      }
+    }
+  }
+}
+
+void FDTD_SubgridCurrent::stepFineE(double dt)
+{
+  FDTD_StepE step{makeFineFields(fineDx, dt, fineE, fineB, fineJ, fineKappa)};
+  FieldIterator::forEach(updateRange, step);
+}
+
+void FDTD_SubgridCurrent::stepFineB(double dt)
+{
+  FDTD_StepB step{makeFineFields(fineDx, dt, fineE, fineB, fineJ, fineKappa)};
+  FieldIterator::forEach(fineRange, step);
+}
+
+void FDTD_SubgridCurrent::restrictE()
+{
+  for (int c=0; c<3; ++c) {
+    const Stagger &stagger = eStagger[c];
+    Index lo = localPatch.getLo();
+    Index hi = localPatch.getHi();
+    Index offset;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      // Unstaggered points on the lower face of the patch lie in the boundary
+      // layer of the fine grid
+      if (!stagger[d] && outerLo[d]) ++lo[d];
+      offset[d] = stagger[d] ? (ratio - 1)/2 : 0;
+    }
+
+    Field &coarse = coarseE[c];
+    Field &fine = fineE[c];
+    FieldIterator::forEach(Range{lo, hi}, [&](Index pos) {
+      Index finePos;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        finePos[d] = (pos[d] - patch.getLo(d))*ratio + offset[d];
+      }
+      coarse[pos] = fine[finePos];
+    });
+  }
+}
+
+void FDTD_SubgridCurrent::storeCoarseE()
+{
+  for (int c=0; c<3; ++c) {
+    Grid &previous = previousE[c];
+    Field &coarse = coarseE[c];
+    FieldIterator::forEach(Range{coarse.getLo(), coarse.getHi()}, [&](Index pos) {
+      previous[pos] = coarse[pos];
+    });
+  }
+}
+
+void FDTD_SubgridCurrent::stepSchemeInit(double dt)
+{
+  auto &decomposition = block.getContext().getDecomposition();
+  decomposition.exchange({E[0], E[1], E[2]});
+  decomposition.exchange({B[0], B[1], B[2]});
+
+  if (!active) return;
+
+  decomposition.getGridContext({E[0], E[1], E[2], B[0], B[1], B[2]}).forEach([&](
+      Range /* range */,
+      Field &ex, Field &ey, Field &ez,
+      Field &bx, Field &by, Field &bz) {
+    coarseE[0] = ex;
+    coarseE[1] = ey;
+    coarseE[2] = ez;
+    coarseB[0] = bx;
+    coarseB[1] = by;
+    coarseB[2] = bz;
+  });
+
+  for (int c=0; c<3; ++c) {
+    previousE[c].resize(coarseE[c].getLo(), coarseE[c].getHi());
+  }
+  storeCoarseE();
+
+  // Both fine fields start from the coarse fields at t=0. The magnetic field is
+  // then moved half a fine time step ahead.
+  for (int c=0; c<3; ++c) {
+    Field &e = fineE[c];
+    Field &b = fineB[c];
+    FieldIterator::forEach(Range{e.getLo(), e.getHi()}, [&](Index pos) {
+      e[pos] = interpolate(coarseE[c], coarseE[c], 1.0, pos, eStagger[c]);
+      b[pos] = interpolate(coarseB[c], coarseB[c], 1.0, pos, bStagger[c]);
+    });
+  }
+
+  stepFineB(0.5*dt/ratio);
+  exchangeFine(fineB);
+}
+
+void FDTD_SubgridCurrent::stepScheme(double dt)
+{
+  // The solver may only have exchanged the ghost cells that it reads itself
+  auto &decomposition = block.getContext().getDecomposition();
+  decomposition.exchange({E[0], E[1], E[2]});
+
+  if (active) {
+    double fineDt = dt/ratio;
+    for (int s=1; s<=ratio; ++s) {
+      stepFineE(fineDt);
+      setBoundary(double(s)/ratio);
+      exchangeFine(fineE);
+      stepFineB(fineDt);
+      exchangeFine(fineB);
+    }
+    restrictE();
+  }
+
+  // The restricted values may lie in the ghost cells of the neighbours
+  decomposition.exchange({E[0], E[1], E[2]});
+
+  if (active) storeCoarseE();
+}
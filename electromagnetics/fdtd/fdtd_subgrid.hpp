@@ -0,0 +1,191 @@
+/*
+ * fdtd_subgrid.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+
+#ifndef HUERTO_FDTD_SUBGRID_H
+#define HUERTO_FDTD_SUBGRID_H
+
+#include "../current.hpp"
+
+#include "../../simulation/simulation_context.hpp"
+
+#include "../../types.hpp"
+
+#include <mpi.h>
+
+#include <vector>
+
+/**
+ * A locally refined patch of the FDTD grid
+ *
+ * The block is added as a child of FDTD_Plain. The patch covers the coarse cells
+ * from `lo` to `hi`, given as global grid indices. Inside the patch, the fields
+ * are advanced on a grid that is finer by the factor `ratio` in each dimension.
+ * The fine grid takes `ratio` time steps for each step of the coarse grid, so
+ * that the Courant number of the coarse grid is kept.
+ *
+ * The ratio has to be odd. The points of each Yee component on the coarse grid
+ * then coincide with points of the same component on the fine grid.
+ */
+class FDTD_Subgrid : public CurrentBlock
+{
+  public:
+    void initCurrents(CurrentContainer &container);
+  protected:
+    void initParameters(schnek::BlockParameters &blockPars);
+    void init();
+  private:
+    /// The lowest coarse cell of the patch
+    schnek::Array<int, DIMENSION> lo;
+
+    /// The highest coarse cell of the patch
+    schnek::Array<int, DIMENSION> hi;
+
+    /// The refinement ratio in space and time
+    int ratio;
+};
+
+/**
+ * The fine grid of an FDTD_Subgrid patch
+ *
+ * The patch is added to the field solver as a magnetic current that does not
+ * carry any current grids. It is stepped after the coarse electric field has
+ * been advanced from \f$t_n\f$ to \f$t_{n+1}\f$ and advances the fine grid over the
+ * same interval.
+ *
+ * The fine electric field in the outermost layer of cells of the patch and in the
+ * ghost cells beyond is taken from the coarse grid. It is interpolated linearly in space and between
+ * \f$t_n\f$ and \f$t_{n+1}\f$ in time. Inside this layer, the fine fields are
+ * advanced with the Yee scheme. After the last sub-step, the fine electric field
+ * replaces the coarse electric field on the coincident points inside the patch.
+ * The coarse magnetic field then follows from the coarse update.
+ *
+ * The patch is registered with the decomposition on the coarse grid. Each process
+ * refines its own part of the patch. Where the patch is cut by the boundary of the
+ * local grid, the fine ghost cells are exchanged with the process that holds the
+ * neighbouring part of the patch after each fine sub-step. Only the outer boundary
+ * of the patch is coupled to the coarse grid, so the result does not depend on the
+ * decomposition.
+ */
+class FDTD_SubgridCurrent : public Current
+{
+  public:
+    FDTD_SubgridCurrent(const Range &patch, int ratio, CurrentBlock &block);
+
+    void init();
+
+    void stepSchemeInit(double dt);
+    void stepScheme(double dt);
+
+    /**
+     * The patch does not add any current to the coarse fields
+     */
+    std::vector<schnek::GridRegistration> getComponentGrids(int) { return {}; }
+
+    bool vanishesWithFields() { return true; }
+  private:
+    /// The global range of coarse cells covered by the patch
+    Range patch;
+
+    /// The refinement ratio in space and time
+    int ratio;
+
+    /// The block that owns the patch
+    CurrentBlock &block;
+
+    /// The coarse electric and magnetic fields
+    schnek::GridRegistration E[3], B[3];
+
+    /// The registration of the patch with the decomposition of the coarse grid
+    schnek::GridRegistration patchReg;
+
+    /// True if the local grid contains a part of the patch
+    bool active;
+
+    /// The local part of the patch on the coarse grid
+    Range localPatch;
+
+    /// The inner range of the fine grid
+    Range fineRange;
+
+    /// The fine electric field points that are advanced with the Yee scheme
+    Range updateRange;
+
+    /// True where the local part of the patch touches the outer boundary of the patch
+    bool outerLo[DIMENSION], outerHi[DIMENSION];
+
+    /// The processes holding the neighbouring parts of the patch, or MPI_PROC_NULL
+    int neighbourLo[DIMENSION], neighbourHi[DIMENSION];
+
+    /// The Cartesian communicator of the decomposition
+    MPI_Comm comm;
+
+    /// The grid spacing of the fine grid
+    Vector fineDx;
+
+    /// The local coarse fields
+    Field coarseE[3], coarseB[3];
+
+    /// The coarse electric field at the start of the current coarse time step
+    Grid previousE[3];
+
+    /// The fine fields
+    Field fineE[3], fineB[3];
+
+    /// Vanishing currents for the Yee kernels on the fine grid
+    Field fineJ[3];
+
+    /// Unit stretch factors for the Yee kernels on the fine grid
+    Grid1d fineKappa[DIMENSION];
+
+    /**
+     * Interpolate a coarse field component to the fine grid point `pos`
+     *
+     * The value is interpolated linearly in time between `previous` and `coarse`,
+     * with `frac` the fraction of the coarse time step.
+     */
+    double interpolate(const Grid &previous,
+                       const Field &coarse,
+                       double frac,
+                       const Index &pos,
+                       const Stagger &stagger);
+
+    /**
+     * Set the fine electric field on the outermost layer and in the ghost cells
+     * at the outer boundary of the patch to the values interpolated from the
+     * coarse grid
+     */
+    void setBoundary(double frac);
+
+    /**
+     * Fill the fine ghost cells at the cuts through the patch from the
+     * neighbouring processes
+     */
+    void exchangeFine(Field *fields);
+
+    /**
+     * Advance the inner fine electric field by `dt`
+     */
+    void stepFineE(double dt);
+
+    /**
+     * Advance the fine magnetic field by `dt`
+     */
+    void stepFineB(double dt);
+
+    /**
+     * Copy the fine electric field to the coincident points of the coarse grid
+     */
+    void restrictE();
+
+    /**
+     * Store the coarse electric field for the time interpolation in the next step
+     */
+    void storeCoarseE();
+};
+
+#endif
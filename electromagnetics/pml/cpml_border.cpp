@@ -2,12 +2,17 @@
 
 #include "../../constants.hpp"
 #include "../../util/field_util.hpp"
+#include "../../util/parallel_iteration.hpp"
 #include "../fieldsolver.hpp"
 #include "../source/border.hpp"
 
 #include <schnek/tools/literature.hpp>
 
+#include <mpi.h>
+
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 //===============================================================
@@ -22,6 +27,7 @@ void CPMLBorder::initParameters(schnek::BlockParameters &blockPars) {
   blockPars.addParameter("aMax", &aMax, 0.0);
   blockPars.addParameter("sigmaMax", &sigmaMax, 1.0);
   blockPars.addParameter("eps", &eps, 1.0);
+  blockPars.addParameter("compact", &compact, 0);
 }
 
 
@@ -39,58 +45,20 @@ void CPMLBorder::init() {
 void CPMLBorder::initCurrents(CurrentContainer &container)
 {
   container.addCurrent(
-    std::make_shared<CPMLBorderECurrent>(thickness, east, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-  container.addCurrent(
-    std::make_shared<CPMLBorderECurrent>(thickness, west, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-#ifndef HUERTO_ONE_DIM
-  container.addCurrent(
-    std::make_shared<CPMLBorderECurrent>(thickness, north, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-  container.addCurrent(
-    std::make_shared<CPMLBorderECurrent>(thickness, south, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-#endif
-#ifdef HUERTO_THREE_DIM
-  container.addCurrent(
-    std::make_shared<CPMLBorderECurrent>(thickness, up, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-  container.addCurrent(
-    std::make_shared<CPMLBorderECurrent>(thickness, down, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
+    std::make_shared<CPMLBorderCurrent>(thickness, false, this->kappaMax, this->aMax, this->sigmaMax, eps, compact, boost::ref(*this), boost::ref(container))
   );
-#endif
-
   container.addMagCurrent(
-    std::make_shared<CPMLBorderHCurrent>(thickness, east, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
+    std::make_shared<CPMLBorderCurrent>(thickness, true, this->kappaMax, this->aMax, this->sigmaMax, eps, compact, boost::ref(*this), boost::ref(container))
   );
-  container.addMagCurrent(
-    std::make_shared<CPMLBorderHCurrent>(thickness, west, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-#ifndef HUERTO_ONE_DIM
-  container.addMagCurrent(
-    std::make_shared<CPMLBorderHCurrent>(thickness, north, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-  container.addMagCurrent(
-    std::make_shared<CPMLBorderHCurrent>(thickness, south, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-#endif
-#ifdef HUERTO_THREE_DIM
-  container.addMagCurrent(
-    std::make_shared<CPMLBorderHCurrent>(thickness, up, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-  container.addMagCurrent(
-    std::make_shared<CPMLBorderHCurrent>(thickness, down, this->kappaMax, this->aMax, this->sigmaMax, eps, boost::ref(*this))
-  );
-#endif
 
-  initCoefficients();
+  initCoefficients(container);
 
 }
 
-void CPMLBorder::initCoefficients()
+void CPMLBorder::initCoefficients(CurrentContainer &container)
 {
-  auto &decomposition = getContext().getDecomposition();
+  SimulationContext &context = getContext();
+  auto &decomposition = context.getDecomposition();
   // initialize Kappas here
 
   Range gdomain = decomposition.getGlobalRange();
@@ -127,17 +95,30 @@ void CPMLBorder::initCoefficients()
     ptrdiff_t hi_lo = ghigh[dim] - thickness + 1;
     ptrdiff_t hi_hi = ghigh[dim];
 
+    // Empty intervals on boundaries without absorbing layers
+    if (!container.isOpenBoundary(Direction(2*dim))) {
+      lo_hiE = lo_loE - 1;
+      lo_hiH = lo_loH - 1;
+    }
+    if (!container.isOpenBoundary(Direction(2*dim + 1))) {
+      hi_lo = hi_hi + 1;
+    }
+
 #ifdef HUERTO_ONE_DIM
     auto gridContext = decomposition.getGridContext({KappaEdk[dim], KappaHdk[dim]});
 #else
     auto gridContext = decomposition.getProjectedGridContext({KappaEdk[dim], KappaHdk[dim]});
 #endif
     gridContext.forEach([&](Range1d range, Grid1d &kappaEdk, Grid1d &kappaHdk) {
-      Field1dIterator::forEach(range, [=, &kappaEdk, &kappaHdk](Index1d posIndex){
+      Field1dIterator::forEach(range, [=, &context, &kappaEdk, &kappaHdk](Index1d posIndex){
         ptrdiff_t pos = posIndex[0];
 
-        kappaEdk(pos) = 1.0;
-        kappaHdk(pos) = 1.0;
+        // The layers stretch the cells of a graded grid further
+        double gradingE = context.getGrading(dim, pos, false);
+        double gradingH = context.getGrading(dim, pos, true);
+
+        kappaEdk(pos) = gradingE;
+        kappaHdk(pos) = gradingH;
 
         double x, x3;
 
@@ -145,25 +126,25 @@ void CPMLBorder::initCoefficients()
           ptrdiff_t k = pos - lo_loE;
           x = 1 - double(k)/double(thickness);
           x3 = x*x*x;
-          kappaEdk(pos) = 1 + (kappaMax - 1)*x3;
+          kappaEdk(pos) = gradingE*(1 + (kappaMax - 1)*x3);
         }  
 
         if (pos >= lo_loH && pos <= lo_hiH) {
           ptrdiff_t k = pos - lo_loH;
           x = 1 - (double(k) - 0.5)/double(thickness);
           x3 = x*x*x;
-          kappaHdk(pos) = 1 + (kappaMax - 1)*x3;
+          kappaHdk(pos) = gradingH*(1 + (kappaMax - 1)*x3);
         }
 
         if (pos >= hi_lo && pos <= hi_hi) {
           ptrdiff_t k = hi_hi - pos;
           x = 1 - double(k)/double(thickness);
           x3 = x*x*x;
-          kappaEdk(pos) = 1 + (kappaMax - 1)*x3;
+          kappaEdk(pos) = gradingE*(1 + (kappaMax - 1)*x3);
           
           double x = 1 - (double(k) - 0.5)/double(thickness);
           double x3 = x*x*x;
-          kappaHdk(pos) = 1 + (kappaMax - 1)*x3;
+          kappaHdk(pos) = gradingH*(1 + (kappaMax - 1)*x3);
         }
       });
     });
@@ -174,304 +155,585 @@ void CPMLBorder::initCoefficients()
 //==========  CPMLBorderCurrent
 //===============================================================
 
+namespace {
+
+/**
+ * Update a row of an auxiliary field
+ *
+ * The storage types of the auxiliary field and the coefficients may differ from
+ * double, but the arithmetic is always carried out in double precision.
+ */
+template<typename PsiType, typename CoeffType>
+inline void updatePsiRow(PsiType *psi, const Real *f, ptrdiff_t off,
+                         const CoeffType *b, const CoeffType *c, ptrdiff_t stride,
+                         double factor, ptrdiff_t n)
+{
+  for (ptrdiff_t k=0; k<n; ++k) {
+    double bk = b[k*stride];
+    double ck = double(c[k*stride])*factor;
+    psi[k] = bk*double(psi[k]) + ck*(f[k+off] - f[k]);
+  }
+}
 
-CPMLBorderCurrent::CPMLBorderCurrent(int thickness, Direction dir, bool isH,
-                                     double kappaMax, double aMax, double sigmaMax, double eps,
-                                     CurrentBlock &borderBlock)
-  : reverse(false), thickness(thickness), dir(dir), isH(isH), lowOffset(0), highOffset(0), zerolayer(0),
-    kappaMax(kappaMax), aMax(aMax), sigmaMax(sigmaMax), eps(eps), borderBlock(borderBlock)
+/**
+ * Add up the auxiliary fields of component `c` along a row and store the sum in the current
+ */
+template<typename PsiGrid>
+inline void sumPsiRow(Real *j, std::vector<PsiGrid> &psi, int c, const Index &pos,
+                      const bool *hasPsi, ptrdiff_t n)
 {
-  switch (dir)
-  {
-    case east:
-    case west:  dim = 0;
-                transverse1 = 1;
-                transverse2 = 2;
-                break;
-#ifndef HUERTO_ONE_DIM
-    case north:
-    case south: dim = 1;
-                transverse1 = 0;
-                transverse2 = 2;
-                break;
-#endif
-#ifdef HUERTO_THREE_DIM
-    case up:
-    case down:  dim = 2;
-                transverse1 = 0;
-                transverse2 = 1;
-                break;
-#endif
+  const typename PsiGrid::value_type *contrib[DIMENSION];
+  int numContrib = 0;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if (hasPsi[d]) contrib[numContrib++] = &psi[c*DIMENSION + d][pos];
   }
+  for (ptrdiff_t k=0; k<n; ++k) {
+    double sum = 0.0;
+    for (int m=0; m<numContrib; ++m) sum += contrib[m][k];
+    j[k] = sum;
+  }
+}
 
-//  double eta = sqrt(mu_0/eps_0);
-  sigmaMax = 10 * sigmaMax * clight / borderBlock.getContext().getDx()[dim];
+/**
+ * Shift an auxiliary field down by one cell along `dim`
+ *
+ * The top plane keeps its value and has to be set afterwards.
+ */
+template<typename PsiGrid>
+inline void shiftPsi(PsiGrid &psi, const Range &range, size_t dim)
+{
+  Index lo = range.getLo();
+  Index hi = range.getHi();
+  hi[dim] -= 1;
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{lo, hi}, [&](const Index &pos) {
+    Index next = pos;
+    ++next[dim];
+    psi[pos] = psi[next];
+  });
 }
 
-void CPMLBorderCurrent::makeCoeff()
+/**
+ * The plane `index` along `dim` of a range
+ */
+inline Range planeRange(const Range &range, size_t dim, ptrdiff_t index)
 {
-  int lowk  = borderRange.getLo(dim);
-  int highk = borderRange.getHi(dim);
+  Index lo = range.getLo();
+  Index hi = range.getHi();
+  lo[dim] = index;
+  hi[dim] = index;
+  return Range{lo, hi};
+}
 
-  switch (dir)
-  {
-    case east:
-#ifndef HUERTO_ONE_DIM
-    case north:
-#endif
-#ifdef HUERTO_THREE_DIM
-    case up:
-#endif
-      reverse = false;
-      break;
-    case west:
-#ifndef HUERTO_ONE_DIM
-    case south:
-#endif
-#ifdef HUERTO_THREE_DIM
-    case down:
-#endif
-      reverse = true;
-      break;
+/**
+ * True if two ranges have the same extent in all dimensions except `dim`
+ */
+inline bool sameTransverse(const Range &a, const Range &b, size_t dim)
+{
+  bool same = true;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if (d == dim) continue;
+    same = same && (a.getLo(d) == b.getLo(d)) && (a.getHi(d) == b.getHi(d));
   }
+  return same;
+}
 
-  auto &decomposition = borderBlock.getContext().getDecomposition();
-#ifdef HUERTO_ONE_DIM
-  bCoeff = decomposition.registerField(schnek::GridFactory<Grid1d>{});
-  cCoeff = decomposition.registerField(schnek::GridFactory<Grid1d>{});
-#else
-  bCoeff = decomposition.registerFieldProjection(schnek::GridFactory<Grid1d>{}, {dim});
-  cCoeff = decomposition.registerFieldProjection(schnek::GridFactory<Grid1d>{}, {dim});
-#endif
+/**
+ * The number of bytes allocated by a grid, including its ghost cells
+ */
+template<typename GridType>
+inline size_t gridBytes(const GridType &grid)
+{
+  size_t cells = 1;
+  for (size_t d=0; d<DIMENSION; ++d) cells *= grid.getHi(d) - grid.getLo(d) + 1;
+  return cells*sizeof(typename GridType::value_type);
+}
 
-  double offset = 0.0;
-  lowOffset = 1;
+}
 
-  if (isH)
-  {
-    offset = 0.5;
-    lowOffset = 0;
+
+CPMLBorderCurrent::CPMLBorderCurrent(int thickness, bool isH,
+                                     double kappaMax, double aMax, double sigmaMax, double eps,
+                                     bool compact, CurrentBlock &borderBlock,
+                                     CurrentContainer &container)
+  : thickness(thickness), isH(isH),
+    kappaMax(kappaMax), aMax(aMax), sigmaMax(sigmaMax), eps(eps), compact(compact),
+    borderBlock(borderBlock), container(container)
+{
+  for (size_t d=0; d<DIMENSION; ++d) {
+    absorbLo[d] = container.isOpenBoundary(Direction(2*d));
+    absorbHi[d] = container.isOpenBoundary(Direction(2*d + 1));
   }
+}
 
-#ifdef HUERTO_ONE_DIM
-  auto gridContext = decomposition.getGridContext({bCoeff, cCoeff});
-#else
-  auto gridContext = decomposition.getProjectedGridContext({bCoeff, cCoeff});
-#endif
-  gridContext.forEach([=](Range1d range, Grid1d &b_coeff, Grid1d &c_coeff) {
-    Field1dIterator::forEach(range, [=, &b_coeff, &c_coeff](Index1d posIndex){
-      ptrdiff_t pos = posIndex[0];
-      double b, c;
-      if (pos >= lowk && pos <= highk) {
-        int k = reverse ? pos - lowk : highk - pos;
-        double x = 1 - (double(k)-offset)/double(thickness);
-        double x3 = x*x*x;
-
-        double sigma = x3*sigmaMax;
-        double kappa = 1 + (kappaMax - 1)*x3;
-        double a = aMax*(1-x);
-
-        b = exp(-(sigma/kappa + a));
-        c = sigma*(b-1)/(kappa*(sigma+kappa*a));
-      } else {
-        b = 0.0;
-        c = 0.0;
-      }
+void CPMLBorderCurrent::init()
+{
+  if (isH) {
+    borderBlock.retrieveData("Ex", F[0]);
+    borderBlock.retrieveData("Ey", F[1]);
+    borderBlock.retrieveData("Ez", F[2]);
+  } else {
+    borderBlock.retrieveData("Bx", F[0]);
+    borderBlock.retrieveData("By", F[1]);
+    borderBlock.retrieveData("Bz", F[2]);
+  }
 
-      b_coeff(pos) = b;
-      c_coeff(pos) = c;
-    });
-  });
+  // The electric current uses the backward difference of B divided by mu_0,
+  // the magnetic current uses the forward difference of E
+  Vector dx = borderBlock.getContext().getDx();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    scale[d] = isH ? 1.0/dx[d] : -1.0/(mu_0*dx[d]);
+  }
+
+  makeBoxes();
+  makeCoeff();
+
+  borderBlock.getContext().registerShiftable(this);
 }
 
-//===============================================================
-//==========  CPMLBorderECurrent
-//===============================================================
+void CPMLBorderCurrent::makeBoxes()
+{
+  auto &decomposition = borderBlock.getContext().getDecomposition();
+  Range gdomain = decomposition.getGlobalRange();
 
+  // Split each dimension into intervals that are either inside or outside the
+  // absorbing layer. The electric layer at the lower boundary starts one cell in.
+  struct Interval { ptrdiff_t lo, hi; bool layer; };
+  std::vector<Interval> intervals[DIMENSION];
+  for (size_t d=0; d<DIMENSION; ++d) {
+    ptrdiff_t glow = gdomain.getLo(d);
+    ptrdiff_t ghigh = gdomain.getHi(d);
+    ptrdiff_t layerLo = glow + (isH ? 0 : 1);
+    ptrdiff_t layerHi = ghigh - thickness + 1;
+    if (layerLo + thickness > layerHi) {
+      throw std::runtime_error("CPMLBorder: the absorbing layers on opposite sides overlap");
+    }
+    for (Interval interval: {Interval{glow, layerLo - 1, false},
+                             Interval{layerLo, layerLo + thickness - 1, absorbLo[d]},
+                             Interval{layerLo + thickness, layerHi - 1, false},
+                             Interval{layerHi, ghigh, absorbHi[d]}}) {
+      if (interval.lo <= interval.hi) intervals[d].push_back(interval);
+    }
+  }
 
-CPMLBorderECurrent::CPMLBorderECurrent(int thickness,
-                                       Direction dir,
-                                       double kappaMax,
-                                       double aMax,
-                                       double sigmaMax,
-                                       double eps,
-                                       CurrentBlock &borderBlock)
-  : CPMLBorderCurrent(thickness,dir,false,kappaMax,aMax,sigmaMax,eps,borderBlock),
-    dx(0)
-{}
+  // Loop over all combinations of intervals
+  size_t numBoxes = 1;
+  for (size_t d=0; d<DIMENSION; ++d) numBoxes *= intervals[d].size();
+
+  boxes.clear();
+  boxes.reserve(numBoxes);
+  for (size_t n=0; n<numBoxes; ++n) {
+    Box box;
+    Index lo, hi;
+    bool inLayer = false;
+    size_t rest = n;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      const Interval &interval = intervals[d][rest % intervals[d].size()];
+      rest /= intervals[d].size();
+      lo[d] = interval.lo;
+      hi[d] = interval.hi;
+      box.active[d] = interval.layer;
+      inLayer = inLayer || interval.layer;
+    }
+    if (!inLayer) continue;
+    box.range = Range{lo, hi};
+
+    for (int c=0; c<3; ++c) {
+      int contributions = 0;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        box.hasPsi[c][d] = box.active[d] && (int(d) != c);
+        if (box.hasPsi[c][d]) ++contributions;
+      }
+      box.hasJ[c] = (contributions > 0);
+      box.compactPsi[c] = compact && (contributions > 1);
+      box.psiInJ[c] = (contributions == 1);
+      if (box.hasJ[c]) {
+        box.J[c] = decomposition.registerField(schnek::GridFactory<Grid>{}, box.range);
+        setField<Grid>(decomposition, box.J[c], 0.0);
+      }
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (!box.hasPsi[c][d]) continue;
+        if (box.psiInJ[c]) {
+          box.psi[c][d] = box.J[c];
+        } else if (box.compactPsi[c]) {
+          box.psi[c][d] = decomposition.registerField(schnek::GridFactory<CompactGrid>{}, box.range);
+          setField<CompactGrid>(decomposition, box.psi[c][d], 0.0f);
+        } else {
+          box.psi[c][d] = decomposition.registerField(schnek::GridFactory<Grid>{}, box.range);
+          setField<Grid>(decomposition, box.psi[c][d], 0.0);
+        }
+      }
+    }
+    boxes.push_back(box);
+  }
 
-void CPMLBorderECurrent::init()
-{
-  Index blow, bhigh;
-  getBorderExtent(dir, thickness, 1, blow, bhigh, false, borderBlock.getContext(), false);
+  decomposition.getGridContext({F[0]}).forEach([&](Range range, Field &) {
+    localDomain = range;
+  });
+
+  // Keep references to the local grids of the boxes
+  localBoxes.clear();
+  for (const Box &box: boxes) {
+    LocalBox local;
+    local.box = &box;
+    bool found = false;
+    for (int c=0; c<3; ++c) {
+      if (box.hasJ[c]) {
+        decomposition.getGridContext({box.J[c]}).forEach([&](Range range, Grid &grid) {
+          local.range = range;
+          local.J.push_back(grid);
+          found = true;
+        });
+      } else {
+        local.J.push_back(Grid());
+      }
+    }
+    for (int c=0; c<3; ++c) {
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (box.hasPsi[c][d] && box.compactPsi[c]) {
+          decomposition.getGridContext({box.psi[c][d]}).forEach([&](Range, CompactGrid &grid) {
+            local.psiCompact.push_back(grid);
+          });
+          local.psi.push_back(Grid());
+        } else if (box.hasPsi[c][d]) {
+          decomposition.getGridContext({box.psi[c][d]}).forEach([&](Range, Grid &grid) {
+            local.psi.push_back(grid);
+          });
+          local.psiCompact.push_back(CompactGrid());
+        } else {
+          local.psi.push_back(Grid());
+          local.psiCompact.push_back(CompactGrid());
+        }
+      }
+    }
+
+    bool empty = !found || (local.J.size() != 3)
+        || (local.psi.size() != 3*DIMENSION) || (local.psiCompact.size() != 3*DIMENSION);
+    for (size_t d=0; d<DIMENSION; ++d) {
+      empty = empty || (local.range.getLo(d) > local.range.getHi(d));
+    }
+    if (!empty) localBoxes.push_back(local);
+  }
+}
 
+void CPMLBorderCurrent::makeCoeff()
+{
   auto &decomposition = borderBlock.getContext().getDecomposition();
-  borderRange = Range{blow, bhigh};
-  Jx = decomposition.registerField(schnek::GridFactory<Grid>{}, borderRange);
-  Jy = decomposition.registerField(schnek::GridFactory<Grid>{}, borderRange);
-  Jz = decomposition.registerField(schnek::GridFactory<Grid>{}, borderRange);
+  Range gdomain = decomposition.getGlobalRange();
+  Vector dx = borderBlock.getContext().getDx();
 
-  setField<Grid>(decomposition, Jx, 0.0);
-  setField<Grid>(decomposition, Jy, 0.0);
-  setField<Grid>(decomposition, Jz, 0.0);
+  double offset = isH ? 0.5 : 0.0;
 
-  switch (dir)
-  {
-    case east:
-    case west:
-      Psi[0] = Jy;
-      Psi[1] = Jz;
-      borderBlock.retrieveData("By", B[0]);
-      borderBlock.retrieveData("Bz", B[1]);
-      borderBlock.retrieveData("Bx", B[2]);
-
-      dx = borderBlock.getContext().getDx()[0];
-      break;
-#ifndef HUERTO_ONE_DIM
-    case north:
-    case south:
-      Psi[0] = Jz;
-      Psi[1] = Jx;
-      borderBlock.retrieveData("Bz", B[0]);
-      borderBlock.retrieveData("Bx", B[1]);
-      borderBlock.retrieveData("By", B[2]);
-
-      dx = borderBlock.getContext().getDx()[1];
-      break;
+  // Register and fill the coefficient lines using either Grid1d or CompactGrid1d
+  auto fillLines = [&](auto factory, auto &bLines, auto &cLines) {
+    typedef typename std::decay_t<decltype(bLines)>::value_type LineGrid;
+    bLines.clear();
+    cLines.clear();
+    for (size_t dim=0; dim<DIMENSION; ++dim) {
+#ifdef HUERTO_ONE_DIM
+      bCoeff[dim] = decomposition.registerField(factory);
+      cCoeff[dim] = decomposition.registerField(factory);
+#else
+      bCoeff[dim] = decomposition.registerFieldProjection(factory, {dim});
+      cCoeff[dim] = decomposition.registerFieldProjection(factory, {dim});
 #endif
-#ifdef HUERTO_THREE_DIM
-    case up:
-    case down:
-      Psi[0] = Jx;
-      Psi[1] = Jy;
-      borderBlock.retrieveData("Bx", B[0]);
-      borderBlock.retrieveData("By", B[1]);
-      borderBlock.retrieveData("Bz", B[2]);
-
-      dx = borderBlock.getContext().getDx()[2];
-      break;
+
+      ptrdiff_t lowLo = gdomain.getLo(dim) + (isH ? 0 : 1);
+      ptrdiff_t lowHi = lowLo + thickness - 1;
+      ptrdiff_t highLo = gdomain.getHi(dim) - thickness + 1;
+      ptrdiff_t highHi = gdomain.getHi(dim);
+
+//    double eta = sqrt(mu_0/eps_0);
+      double sigmaMaxDim = 10 * sigmaMax * clight / dx[dim];
+
+#ifdef HUERTO_ONE_DIM
+      auto gridContext = decomposition.getGridContext({bCoeff[dim], cCoeff[dim]});
+#else
+      auto gridContext = decomposition.getProjectedGridContext({bCoeff[dim], cCoeff[dim]});
 #endif
+      gridContext.forEach([&](Range1d range, LineGrid &b_coeff, LineGrid &c_coeff) {
+        Field1dIterator::forEach(range, [=, &b_coeff, &c_coeff](Index1d posIndex){
+          ptrdiff_t pos = posIndex[0];
+          double b, c;
+          if ((absorbLo[dim] && pos >= lowLo && pos <= lowHi) || (absorbHi[dim] && pos >= highLo && pos <= highHi)) {
+            int k = (pos <= lowHi) ? pos - lowLo : highHi - pos;
+            double x = 1 - (double(k)-offset)/double(thickness);
+            double x3 = x*x*x;
+
+            double sigma = x3*sigmaMaxDim;
+            double kappa = 1 + (kappaMax - 1)*x3;
+            double a = aMax*(1-x);
+
+            b = exp(-(sigma/kappa + a));
+            c = sigma*(b-1)/(kappa*(sigma+kappa*a));
+          } else {
+            b = 0.0;
+            c = 0.0;
+          }
+
+          b_coeff(pos) = b;
+          c_coeff(pos) = c;
+        });
+        bLines.push_back(b_coeff);
+        cLines.push_back(c_coeff);
+      });
+    }
+
+    if ((bLines.size() != DIMENSION) || (cLines.size() != DIMENSION)) {
+      throw std::runtime_error("CPMLBorder: expected exactly one local coefficient line per dimension");
+    }
+  };
+
+  if (compact) {
+    fillLines(schnek::GridFactory<CompactGrid1d>{}, bLineCompact, cLineCompact);
+  } else {
+    fillLines(schnek::GridFactory<Grid1d>{}, bLine, cLine);
   }
+}
 
-  makeCoeff();
+size_t CPMLBorderCurrent::planeSize(const Range &range, size_t dim)
+{
+  size_t size = 3*DIMENSION;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if (d != dim) size *= range.getHi(d) - range.getLo(d) + 1;
+  }
+  return size;
 }
 
-void CPMLBorderECurrent::stepSchemeInit(double /* dt */)
-{}
+void CPMLBorderCurrent::readPlane(LocalBox &local, size_t dim, ptrdiff_t index, double *buffer)
+{
+  const Box &box = *local.box;
+  Range plane = planeRange(local.range, dim, index);
+  size_t n = 0;
+  for (int c=0; c<3; ++c) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      size_t p = c*DIMENSION + d;
+      schnek::RangeCIterationPolicy<DIMENSION>::forEach(plane, [&](const Index &pos) {
+        if (!box.hasPsi[c][d]) {
+          buffer[n++] = 0.0;
+        } else if (box.compactPsi[c]) {
+          buffer[n++] = local.psiCompact[p][pos];
+        } else {
+          buffer[n++] = local.psi[p][pos];
+        }
+      });
+    }
+  }
+}
 
-void CPMLBorderECurrent::stepScheme(double /* dt */)
+void CPMLBorderCurrent::writePlane(LocalBox &local, size_t dim, ptrdiff_t index, const double *buffer)
 {
-  auto gridContext = borderBlock.getContext().getDecomposition().getGridContext({Psi[0], Psi[1], B[0], B[1], bCoeff, cCoeff});
-  gridContext.forEach([&](Range range, Grid &psi0, Grid &psi1, Field &B0, Field &B1, Grid1d &b_coeff, Grid1d &c_coeff) {
-    FieldIterator::forEach(range, [=, &psi0, &psi1](Index ind) {
-        int j = ind[dim];
-        Index indm{ind};
-        --indm[dim];
-
-        psi0[ind]
-          = b_coeff(j)*psi0[ind]
-            + c_coeff(j)*(B1[ind]-B1[indm])/(mu_0*dx);
-        psi1[ind]
-          = b_coeff(j)*psi1[ind]
-            - c_coeff(j)*(B0[ind]-B0[indm])/(mu_0*dx);
-    });
-  });
+  const Box &box = *local.box;
+  Range plane = planeRange(local.range, dim, index);
+  size_t n = 0;
+  for (int c=0; c<3; ++c) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      size_t p = c*DIMENSION + d;
+      schnek::RangeCIterationPolicy<DIMENSION>::forEach(plane, [&](const Index &pos) {
+        if (!box.hasPsi[c][d]) {
+          ++n;
+        } else if (box.compactPsi[c]) {
+          local.psiCompact[p][pos] = buffer[n++];
+        } else {
+          local.psi[p][pos] = buffer[n++];
+        }
+      });
+    }
+  }
 }
 
+void CPMLBorderCurrent::shiftWindow(size_t dim)
+{
+  auto &decomposition = borderBlock.getContext().getDecomposition();
+  Range gdomain = decomposition.getGlobalRange();
+  MPI_Comm comm = decomposition.getComm();
+
+  // The lowest planes of the local boxes before the shift. Those on the lower
+  // edge of the local grid are sent to the neighbour below.
+  std::vector<std::vector<double>> bottom(localBoxes.size());
+  std::vector<double> sendBuffer;
+  for (size_t b=0; b<localBoxes.size(); ++b) {
+    LocalBox &local = localBoxes[b];
+    bottom[b].resize(planeSize(local.range, dim));
+    readPlane(local, dim, local.range.getLo(dim), bottom[b].data());
+    if (local.range.getLo(dim) == localDomain.getLo(dim)) {
+      sendBuffer.insert(sendBuffer.end(), bottom[b].begin(), bottom[b].end());
+    }
+  }
 
-//===============================================================
-//==========  CPMLBorderHCurrent
-//===============================================================
+  // The neighbour above sends the planes of the boxes that cover the next plane
+  // beyond the local grid, in the order of the boxes
+  ptrdiff_t next = localDomain.getHi(dim) + 1;
+  std::vector<const Box*> upperBoxes;
+  std::vector<size_t> upperOffsets;
+  size_t recvCount = 0;
+  if (next <= gdomain.getHi(dim)) {
+    for (const Box &box: boxes) {
+      if ((box.range.getLo(dim) > next) || (box.range.getHi(dim) < next)) continue;
+      Index lo = box.range.getLo();
+      Index hi = box.range.getHi();
+      bool empty = false;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        lo[d] = std::max(lo[d], localDomain.getLo(d));
+        hi[d] = std::min(hi[d], localDomain.getHi(d));
+        empty = empty || (lo[d] > hi[d]);
+      }
+      if (empty) continue;
+      upperBoxes.push_back(&box);
+      upperOffsets.push_back(recvCount);
+      recvCount += planeSize(Range{lo, hi}, dim);
+    }
+  }
 
-CPMLBorderHCurrent::CPMLBorderHCurrent(int thickness,
-                                       Direction dir,
-                                       double kappaMax,
-                                       double aMax,
-                                       double sigmaMax,
-                                       double eps,
-                                       CurrentBlock &borderBlock)
-  : CPMLBorderCurrent(thickness,dir,true,kappaMax,aMax,sigmaMax,eps,borderBlock),
-    dx(0)
-{}
-
-void CPMLBorderHCurrent::init()
-{
-  Index blow, bhigh;
-  getBorderExtent(dir, thickness, 1, blow, bhigh, true, borderBlock.getContext(), false);
+  // Planes are never passed around the periodic boundary
+  int lower, upper;
+  MPI_Cart_shift(comm, dim, 1, &lower, &upper);
+  if (localDomain.getLo(dim) == gdomain.getLo(dim)) lower = MPI_PROC_NULL;
+  if (localDomain.getHi(dim) == gdomain.getHi(dim)) upper = MPI_PROC_NULL;
+
+  std::vector<double> recvBuffer(recvCount);
+  MPI_Sendrecv(sendBuffer.data(), sendBuffer.size(), MPI_DOUBLE, lower, 0,
+               recvBuffer.data(), recvCount, MPI_DOUBLE, upper, 0,
+               comm, MPI_STATUS_IGNORE);
+
+  for (size_t b=0; b<localBoxes.size(); ++b) {
+    LocalBox &local = localBoxes[b];
+    const Box &box = *local.box;
+    for (int c=0; c<3; ++c) {
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (!box.hasPsi[c][d]) continue;
+        if (box.compactPsi[c]) {
+          shiftPsi(local.psiCompact[c*DIMENSION + d], local.range, dim);
+        } else {
+          shiftPsi(local.psi[c*DIMENSION + d], local.range, dim);
+        }
+      }
+    }
+
+    // The top plane comes from the box above, on this process or on the
+    // neighbour. It is cleared if there is no such box.
+    ptrdiff_t top = local.range.getHi(dim);
+    std::vector<double> plane(planeSize(local.range, dim), 0.0);
+    if (top < localDomain.getHi(dim)) {
+      for (size_t a=0; a<localBoxes.size(); ++a) {
+        if ((localBoxes[a].range.getLo(dim) == top + 1) && sameTransverse(localBoxes[a].box->range, box.range, dim)) {
+          plane = bottom[a];
+        }
+      }
+    } else {
+      for (size_t u=0; u<upperBoxes.size(); ++u) {
+        if (sameTransverse(upperBoxes[u]->range, box.range, dim)) {
+          std::copy(recvBuffer.begin() + upperOffsets[u],
+                    recvBuffer.begin() + upperOffsets[u] + plane.size(),
+                    plane.begin());
+        }
+      }
+    }
+    writePlane(local, dim, top, plane.data());
+  }
+}
 
-  auto &decomposition = borderBlock.getContext().getDecomposition();
-  borderRange = Range{blow, bhigh};
-  Jx = decomposition.registerField(schnek::GridFactory<Grid>{}, borderRange);
-  Jy = decomposition.registerField(schnek::GridFactory<Grid>{}, borderRange);
-  Jz = decomposition.registerField(schnek::GridFactory<Grid>{}, borderRange);
-  
-  setField<Grid>(decomposition, Jx, 0.0);
-  setField<Grid>(decomposition, Jy, 0.0);
-  setField<Grid>(decomposition, Jz, 0.0);
-
-  switch (dir)
-  {
-    case east:
-    case west:
-      Psi[0] = Jy;
-      Psi[1] = Jz;
-      borderBlock.retrieveData("Ey", E[0]);
-      borderBlock.retrieveData("Ez", E[1]);
-      borderBlock.retrieveData("Ex", E[2]);
-
-      dx = borderBlock.getContext().getDx()[0];
-      break;
-#ifndef HUERTO_ONE_DIM
-    case north:
-    case south:
-      Psi[0] = Jz;
-      Psi[1] = Jx;
-      borderBlock.retrieveData("Ez", E[0]);
-      borderBlock.retrieveData("Ex", E[1]);
-      borderBlock.retrieveData("Ey", E[2]);
-
-      dx = borderBlock.getContext().getDx()[1];
-      break;
-#endif
-#ifdef HUERTO_THREE_DIM
-    case up:
-    case down:
-      Psi[0] = Jx;
-      Psi[1] = Jy;
-      borderBlock.retrieveData("Ex", E[0]);
-      borderBlock.retrieveData("Ey", E[1]);
-      borderBlock.retrieveData("Ez", E[2]);
-
-      dx = borderBlock.getContext().getDx()[2];
-      break;
-#endif
+std::vector<schnek::GridRegistration> CPMLBorderCurrent::getComponentGrids(int component)
+{
+  std::vector<schnek::GridRegistration> grids;
+  for (const Box &box: boxes) {
+    if (box.hasJ[component]) grids.push_back(box.J[component]);
   }
+  return grids;
+}
 
-  makeCoeff();
+size_t CPMLBorderCurrent::getStorageSize()
+{
+  size_t bytes = 0;
+  for (const LocalBox &local: localBoxes) {
+    const Box &box = *local.box;
+    for (int c=0; c<3; ++c) {
+      if (box.hasJ[c]) bytes += gridBytes(local.J[c]);
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (!box.hasPsi[c][d] || box.psiInJ[c]) continue;
+        size_t p = c*DIMENSION + d;
+        bytes += box.compactPsi[c] ? gridBytes(local.psiCompact[p]) : gridBytes(local.psi[p]);
+      }
+    }
+  }
+  return bytes;
+}
 
+void CPMLBorderCurrent::updateRows(LocalBox &local, const Range &range, Field fields[3])
+{
+  const size_t last = DIMENSION - 1;
+  const Box &box = *local.box;
+  ptrdiff_t n = range.getHi(last) - range.getLo(last) + 1;
+  if (n <= 0) return;
+
+  const int shift = isH ? 1 : -1;
+  Index rowHi = range.getHi();
+  rowHi[last] = range.getLo(last);
+
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{range.getLo(), rowHi}, [&](const Index &pos) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      if (!box.active[d]) continue;
+
+      // The coefficients only change along the row if the layer normal is the innermost dimension
+      ptrdiff_t stride = (d == last) ? 1 : 0;
+
+      // The components perpendicular to the layer normal
+      int t1 = (d + 1) % 3;
+      int t2 = (d + 2) % 3;
+
+      // psi_t1 is driven by the difference of F_t2 and psi_t2 by minus the difference of F_t1
+      for (int sign: {1, -1}) {
+        int c = (sign > 0) ? t1 : t2;
+        int t = (sign > 0) ? t2 : t1;
+        if (!box.hasPsi[c][d]) continue;
+
+        Index posShift = pos;
+        posShift[d] += shift;
+        const Real *f = &fields[t][pos];
+        ptrdiff_t off = &fields[t][posShift] - f;
+        double factor = sign*scale[d];
+
+        size_t p = c*DIMENSION + d;
+        if (box.compactPsi[c]) {
+          updatePsiRow(&local.psiCompact[p][pos], f, off,
+                       &bLineCompact[d](pos[d]), &cLineCompact[d](pos[d]), stride, factor, n);
+        } else if (compact) {
+          updatePsiRow(&local.psi[p][pos], f, off,
+                       &bLineCompact[d](pos[d]), &cLineCompact[d](pos[d]), stride, factor, n);
+        } else {
+          updatePsiRow(&local.psi[p][pos], f, off, &bLine[d](pos[d]), &cLine[d](pos[d]), stride, factor, n);
+        }
+      }
+    }
+
+    // Sum the auxiliary fields unless a single one is stored in the current
+    for (int c=0; c<3; ++c) {
+      if (!box.hasJ[c] || box.psiInJ[c]) continue;
+      Real *j = &local.J[c][pos];
+      if (box.compactPsi[c]) {
+        sumPsiRow(j, local.psiCompact, c, pos, box.hasPsi[c], n);
+      } else {
+        sumPsiRow(j, local.psi, c, pos, box.hasPsi[c], n);
+      }
+    }
+  });
 }
 
-void CPMLBorderHCurrent::stepSchemeInit(double dt)
+void CPMLBorderCurrent::stepSchemeInit(double dt)
 {
-  stepScheme(0.5*dt);
+  if (isH) stepScheme(0.5*dt);
 }
 
-void CPMLBorderHCurrent::stepScheme(double /* dt */)
+void CPMLBorderCurrent::stepScheme(double /* dt */)
 {
-  auto gridContext = borderBlock.getContext().getDecomposition().getGridContext({Psi[0], Psi[1], E[0], E[1], bCoeff, cCoeff});
-  gridContext.forEach([&](Range range, Grid &psi0, Grid &psi1, Field &E0, Field &E1, Grid1d &b_coeff, Grid1d &c_coeff) {
-    FieldIterator::forEach(range, [=, &psi0, &psi1](Index ind) {
-        int j = ind[dim];
-        Index indp(ind);
-        ++indp[dim];
-
-        psi0[ind]
-          = b_coeff(j)*psi0[ind]
-            + c_coeff(j)*(E1[indp]-E1[ind])/dx;
-
-        psi1[ind]
-          = b_coeff(j)*psi1[ind]
-            - c_coeff(j)*(E0[indp]-E0[ind])/dx;
-    });
+  auto gridContext = borderBlock.getContext().getDecomposition().getGridContext({F[0], F[1], F[2]});
+  gridContext.forEach([&](Range /* range */, Field &f0, Field &f1, Field &f2) {
+    Field fields[3] = {f0, f1, f2};
+    BlockTaskList tasks;
+    for (LocalBox &local: localBoxes) {
+      tasks.add(local.range, [this, &local, &fields](const Range &range) {
+        updateRows(local, range, fields);
+      });
+    }
+    tasks.run(container.isThreaded());
   });
 }
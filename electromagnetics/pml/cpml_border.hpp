@@ -3,6 +3,9 @@
 
 #include "../../types.hpp"
 #include "../current.hpp"
+#include "../../simulation/simulation_context.hpp"
+
+#include <vector>
 
 class CPMLBorder : public CurrentBlock
 {
@@ -19,103 +22,178 @@ class CPMLBorder : public CurrentBlock
     void init();
   private:
 
-    void initCoefficients();
+    void initCoefficients(CurrentContainer &container);
 
     int thickness;
     double kappaMax;
     double aMax;
     double sigmaMax;
     double eps;
+    int compact;
 };
 
-class CPMLBorderCurrent : public Current
+/**
+ * The CPML currents on all faces of the simulation domain for one field type
+ *
+ * The region covered by the absorbing layers is split into disjoint boxes, i.e.
+ * the faces, edges, and corners of the domain. Each box stores the auxiliary
+ * fields \f$\psi\f$ of all the layers that overlap it. A single pass over the
+ * rows of a box updates all of these and adds them up to the current. Where only
+ * one layer contributes to a current component, the auxiliary field is stored
+ * directly in the current grid.
+ *
+ * In compact mode, the coefficient lines and the auxiliary fields of the edges
+ * and corners, where several layers contribute, are kept in single precision.
+ * On the faces the auxiliary field stays in the current grid, which needs less
+ * memory than a separate single precision field. The update itself is still
+ * carried out in double precision.
+ *
+ * When the window moves, the auxiliary fields are shifted with the electromagnetic
+ * fields. The absorbing layers and their coefficients stay at the boundaries of the
+ * window. The plane that moves into the upper end of a local box is taken from the
+ * box above it, which may lie on the neighbouring process. It is only cleared where
+ * the auxiliary field does not continue, e.g. at the leading edge of the window.
+ */
+class CPMLBorderCurrent : public Current, public WindowShiftable
 {
   public:
     CPMLBorderCurrent(int thickness,
-                      Direction dir,
                       bool isH,
                       double kappaMax,
                       double aMax,
                       double sigmaMax,
                       double eps,
-                      CurrentBlock &borderBlock);
-  protected:
-    bool reverse;
-    int thickness;
+                      bool compact,
+                      CurrentBlock &borderBlock,
+                      CurrentContainer &container);
 
-    size_t dim;
-    int transverse1, transverse2;
+    void init();
 
-    Direction dir;
-    bool isH;
-    int lowOffset;
-    int highOffset;
+    void stepSchemeInit(double dt);
+    void stepScheme(double dt);
+
+    std::vector<schnek::GridRegistration> getComponentGrids(int component);
+
+    bool vanishesWithFields() { return true; }
 
-    int zerolayer;
+    void shiftWindow(size_t dim) override;
+
+    /**
+     * The number of bytes of the local current and auxiliary field grids
+     */
+    size_t getStorageSize();
+  private:
+    /// Single precision storage for the auxiliary fields in compact mode
+    typedef schnek::Grid<float, DIMENSION, HuertoGridChecker> CompactGrid;
+    typedef schnek::Grid<float, 1, HuertoGridChecker> CompactGrid1d;
+
+    /**
+     * A box of the border region in which the same layers overlap
+     */
+    struct Box
+    {
+        /// The global range of the box
+        Range range;
+
+        /// True for the dimensions whose absorbing layer covers the box
+        bool active[DIMENSION];
+
+        /// The current components, only registered if non-zero
+        schnek::GridRegistration J[3];
+        bool hasJ[3];
+
+        /// The auxiliary fields for each current component and layer
+        schnek::GridRegistration psi[3][DIMENSION];
+        bool hasPsi[3][DIMENSION];
+
+        /// True if the auxiliary fields of a component are stored as CompactGrid;
+        /// only used if more than one layer contributes
+        bool compactPsi[3];
+
+        /// True if the single auxiliary field of a component is the current grid itself
+        bool psiInJ[3];
+    };
+
+    /**
+     * The local grids of a box
+     *
+     * The auxiliary field of component `c` and layer `d` is stored in `psi[c*DIMENSION + d]`
+     * or, if it is compact, in `psiCompact[c*DIMENSION + d]`.
+     */
+    struct LocalBox
+    {
+        const Box *box;
+        Range range;
+        std::vector<Grid> J;
+        std::vector<Grid> psi;
+        std::vector<CompactGrid> psiCompact;
+    };
+
+    int thickness;
+    bool isH;
 
     double kappaMax;
     double aMax;
     double sigmaMax;
     double eps;
+    bool compact;
 
-    Range borderRange;
+    /// True if there is an absorbing layer at the lower or upper boundary of a dimension
+    bool absorbLo[DIMENSION];
+    bool absorbHi[DIMENSION];
 
-    /// 1D grid containing the coefficients
-    CPMLBorder::GridLineRegistration bCoeff;
-    CPMLBorder::GridLineRegistration cCoeff;
+    std::vector<Box> boxes;
+    std::vector<LocalBox> localBoxes;
 
-    CurrentBlock &borderBlock;
+    /// The inner range of the local grid
+    Range localDomain;
 
-    void makeCoeff();
-};
+    /// The fields whose curl is corrected, B for the electric and E for the magnetic current
+    schnek::GridRegistration F[3];
 
-class CPMLBorderECurrent : public CPMLBorderCurrent
-{
-  public:
-    CPMLBorderECurrent(int thickness,
-                       Direction dir,
-                       double kappaMax,
-                       double aMax,
-                       double sigmaMax,
-                       double eps,
-                       CurrentBlock &borderBlock);
+    /// 1D grids containing the coefficients for each dimension
+    CPMLBorder::GridLineRegistration bCoeff[DIMENSION];
+    CPMLBorder::GridLineRegistration cCoeff[DIMENSION];
 
-    void init();
+    std::vector<Grid1d> bLine;
+    std::vector<Grid1d> cLine;
+    std::vector<CompactGrid1d> bLineCompact;
+    std::vector<CompactGrid1d> cLineCompact;
 
-    void stepSchemeInit(double dt);
-    void stepScheme(double dt);
-  protected:
+    /// The factor multiplying the finite difference of the field in each dimension
+    double scale[DIMENSION];
 
-    // The B-field components
-    schnek::GridRegistration B[3];
-    
-    // The components of the Psi grid
-    schnek::GridRegistration Psi[2];
-    double dx;
-};
+    CurrentBlock &borderBlock;
 
-class CPMLBorderHCurrent : public CPMLBorderCurrent
-{
-  public:
-    CPMLBorderHCurrent(int thickness,
-                       Direction dir,
-                       double kappaMax,
-                       double aMax,
-                       double sigmaMax,
-                       double eps,
-                       CurrentBlock &borderBlock);
+    /// The field solver holding the current; decides whether the update is threaded
+    CurrentContainer &container;
 
-    void init();
+    void makeBoxes();
+    void makeCoeff();
 
-    void stepSchemeInit(double dt);
-    void stepScheme(double dt);
-  protected:
-    // The E-field components
-    schnek::GridRegistration E[3];
-    // The components of the Psi grid
-    schnek::GridRegistration Psi[2];
-    double dx;
+    /**
+     * The number of values of all auxiliary fields on a plane of `range` perpendicular to `dim`
+     */
+    static size_t planeSize(const Range &range, size_t dim);
+
+    /**
+     * Copy the auxiliary fields on the plane `index` along `dim` to a buffer
+     *
+     * Each component and layer takes up one plane of the buffer. The fields that
+     * are not stored in the box give zeros.
+     */
+    void readPlane(LocalBox &local, size_t dim, ptrdiff_t index, double *buffer);
+
+    /**
+     * Set the auxiliary fields on the plane `index` along `dim` from a buffer
+     * filled by readPlane()
+     */
+    void writePlane(LocalBox &local, size_t dim, ptrdiff_t index, const double *buffer);
+
+    /**
+     * Update the auxiliary fields and the current on a range of a box
+     */
+    void updateRows(LocalBox &local, const Range &range, Field fields[3]);
 };
 
-
 #endif
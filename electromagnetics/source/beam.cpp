@@ -9,9 +9,32 @@
 
 #include "../../maths/vector/vector.hpp"
 
+#include <cmath>
+#include <iostream>
+#include <limits>
 
 #ifndef HUERTO_ONE_DIM
 
+namespace {
+
+/**
+ * The range of grid indices at which the currents evaluate the source function
+ *
+ * This is the range of the current sheet extended by one grid cell.
+ */
+Range getProfileRange(const Grid &J)
+{
+  Index lo = J.getLo();
+  Index hi = J.getHi();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    --lo[d];
+    ++hi[d];
+  }
+  return Range{lo, hi};
+}
+
+} // namespace
+
 //===============================================================
 //==========  Gaussian Beam Source
 //===============================================================
@@ -70,7 +93,7 @@ void GaussBeamSource::initParameters(schnek::BlockParameters &blockPars) {
 }
 
 GaussBeamSourceEFunc::GaussBeamSourceEFunc(Direction dir, SimulationContext &context)
-  : dir(dir), context(context)
+  : dir(dir), phaseTime(std::numeric_limits<double>::quiet_NaN()), context(context)
 {}
 
 void GaussBeamSourceEFunc::setParam(Vector k,
@@ -117,31 +140,52 @@ void GaussBeamSourceEFunc::setParam(Vector k,
   om = clight*kn/sqrt(eps);
   zr = kn*kn*waist*waist/2.0;
 
-  dx = context.getDx();
 }
 
 
+void GaussBeamSourceEFunc::initSourceFunc(Grid &Jx, Grid & /* Jy */, Grid & /* Jz */)
+{
 #ifdef HUERTO_TWO_DIM
-Vector3d GaussBeamSourceEFunc::getHField(int i, int j, double time)
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1]);
+  });
+#endif
+
+#ifdef HUERTO_THREE_DIM
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1], pos[2]);
+  });
+#endif
+}
+
+void GaussBeamSourceEFunc::setTime(double time)
 {
-  // The current time in s
-  double realtime = time - 0.5*dt;
+  phaseTime = time;
+  phase = om*(time - 0.5*dt);
+  cosPhase = cos(phase);
+  sinPhase = sin(phase);
+}
 
+#ifdef HUERTO_TWO_DIM
+BeamProfile GaussBeamSourceEFunc::getProfile(int i, int j)
+{
   // The current position relative to the origin in m
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
 
   // The normalised position along the beam axis
-  Vector3d zA(k[0]*x + k[1]*(y+0.5*dx[1]),
-              k[0]*(x+0.5*dx[0]) + k[1]*y,
-              k[0]*(x+0.5*dx[0]) + k[1]*(y+0.5*dx[1]));
+  Vector3d zA(k[0]*x + k[1]*yh,
+              k[0]*xh + k[1]*y,
+              k[0]*xh + k[1]*yh);
 
   // The position perpendicular to the beam axis in physical units
-  Vector3d pA(kperp[0]*x + kperp[1]*(y+0.5*dx[1]),
-              kperp[0]*(x+0.5*dx[0]) + kperp[1]*y,
-              kperp[0]*(x+0.5*dx[0]) + kperp[1]*(y+0.5*dx[1]));
+  Vector3d pA(kperp[0]*x + kperp[1]*yh,
+              kperp[0]*xh + kperp[1]*y,
+              kperp[0]*xh + kperp[1]*yh);
 
-  Vector3d h;
+  BeamProfile profile;
   for (int d=0; d<3; ++d) {
     // z is normalised to the wavelength because k is the wavevector in 1/m
     double z = zA[d];
@@ -155,47 +199,45 @@ Vector3d GaussBeamSourceEFunc::getHField(int i, int j, double time)
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
-
-    double zenv = (z + offset)/rise;
-    double env = (zenv>0) ? exp(-zenv*zenv) : 1.0;
+    double amp = sqrt(waist/w)*exp( -std::pow( r/w, 2*superGaussian) );
 
-    double amp = sqrt(waist/w)*env*exp( -std::pow( r/w, 2*superGaussian) );
-
-    h[d] = amp*(H[d]*sin(z + ph) + Hp[d]*cos(z + ph));
-
-//    if (j == 1000 && i>1000) {
-//      std::cout << "getHField " << i << ":" << d << " " << z << " " << r << " " << w << " | "
-//              << Rinv << " "  << ph << " "  << zenv << " "  << env << " | "  << amp << " " << h[d] << std::endl;
-//    }
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
   }
 
-  return h;
+  return profile;
+}
+
+Vector3d GaussBeamSourceEFunc::getHField(int i, int j, double time)
+{
+  return getHField(lookupProfile(Index(i, j)), time);
 }
 #endif
 
 #ifdef HUERTO_THREE_DIM
-Vector3d GaussBeamSourceEFunc::getHField(int i, int j, int l, double time)
+BeamProfile GaussBeamSourceEFunc::getProfile(int i, int j, int l)
 {
-  double realtime = time - 0.5*dt;
-
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
-  double z = l*dx[2] - origin[2];
-
-  Vector3d zA(k[0]*x + k[1]*(y+0.5*dx[1]) + k[2]*(z+0.5*dx[2]),
-              k[0]*(x+0.5*dx[0]) + k[1]*y + k[2]*(z+0.5*dx[2]),
-              k[0]*(x+0.5*dx[0]) + k[1]*(y+0.5*dx[1]) + k[2]*z);
-
-  Vector3d pA(kperpA[0]*x + kperpA[1]*(y+0.5*dx[1]) + kperpA[2]*(z+0.5*dx[2]),
-              kperpA[0]*(x+0.5*dx[0]) + kperpA[1]*y + kperpA[2]*(z+0.5*dx[2]),
-              kperpA[0]*(x+0.5*dx[0]) + kperpA[1]*(y+0.5*dx[1]) + kperpA[2]*z);
-
-  Vector3d pB(kperpB[0]*x + kperpB[1]*(y+0.5*dx[1]) + kperpB[2]*(z+0.5*dx[2]),
-              kperpB[0]*(x+0.5*dx[0]) + kperpB[1]*y + kperpB[2]*(z+0.5*dx[2]),
-              kperpB[0]*(x+0.5*dx[0]) + kperpB[1]*(y+0.5*dx[1]) + kperpB[2]*z);
-
-  Vector3d h;
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+  double z = context.getPosition(2, l) - origin[2];
+  double zh = context.getPosition(2, l + 0.5) - origin[2];
+
+  Vector3d zA(k[0]*x + k[1]*yh + k[2]*zh,
+              k[0]*xh + k[1]*y + k[2]*zh,
+              k[0]*xh + k[1]*yh + k[2]*z);
+
+  Vector3d pA(kperpA[0]*x + kperpA[1]*yh + kperpA[2]*zh,
+              kperpA[0]*xh + kperpA[1]*y + kperpA[2]*zh,
+              kperpA[0]*xh + kperpA[1]*yh + kperpA[2]*z);
+
+  Vector3d pB(kperpB[0]*x + kperpB[1]*yh + kperpB[2]*zh,
+              kperpB[0]*xh + kperpB[1]*y + kperpB[2]*zh,
+              kperpB[0]*xh + kperpB[1]*yh + kperpB[2]*z);
+
+  BeamProfile profile;
   for (int d=0; d<3; ++d)
   {
     // z is normalised to the wavelength because k is the wavevector in 1/m
@@ -209,23 +251,93 @@ Vector3d GaussBeamSourceEFunc::getHField(int i, int j, int l, double time)
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
+    double amp = sqrt(waist/w)*exp( -std::pow( r/w, 2*superGaussian) );
+
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
+  }
+
+  return profile;
+}
+
+Vector3d GaussBeamSourceEFunc::getHField(int i, int j, int l, double time)
+{
+  return getHField(lookupProfile(Index(i, j, l)), time);
+}
+#endif
+
+BeamProfile GaussBeamSourceEFunc::lookupProfile(const Index &pos)
+{
+  if (profiles.contains(pos)) return profiles.get(pos);
+#ifdef HUERTO_TWO_DIM
+  return getProfile(pos[0], pos[1]);
+#endif
+#ifdef HUERTO_THREE_DIM
+  return getProfile(pos[0], pos[1], pos[2]);
+#endif
+}
+
+inline double GaussBeamSourceEFunc::getHComponent(int c, double z, double re, double im) const
+{
+  double zenv = (z - phase + offset)/rise;
+  double env = (zenv>0) ? exp(-zenv*zenv) : 1.0;
+
+  // The rotated phasor gives amp*sin(z + ph - phase) and amp*cos(z + ph - phase)
+  double s = im*cosPhase - re*sinPhase;
+  double cs = re*cosPhase + im*sinPhase;
 
-    double zenv = (z + offset)/rise;
-    double env = (zenv>0) ? exp(-zenv*zenv) : 1.0;
+  return env*(H[c]*s + Hp[c]*cs);
+}
 
-    double amp = sqrt(waist/w)*env*exp( -std::pow( r/w, 2*superGaussian) );
+Vector3d GaussBeamSourceEFunc::getHField(const BeamProfile &profile, double time)
+{
+  if (time != phaseTime) setTime(time);
 
-    h[d] = amp*(H[d]*sin(z + ph) + Hp[d]*cos(z + ph));
+  Vector3d h;
+  for (int d=0; d<3; ++d) {
+    h[d] = getHComponent(d, profile.z[d], profile.re[d], profile.im[d]);
   }
 
   return h;
 }
-#endif
+
+void GaussBeamSourceEFunc::getHFieldRow(const Index &start,
+                                        int axis,
+                                        int count,
+                                        double time,
+                                        double *hx,
+                                        double *hy,
+                                        double *hz)
+{
+  double *h[3] = {hx, hy, hz};
+
+  if (!profiles.contains(start, axis, count)) {
+    Index pos = start;
+    for (int n=0; n<count; ++n, ++pos[axis]) {
+      Vector3d value = getHField(lookupProfile(pos), time);
+      for (int d=0; d<3; ++d) h[d][n] = value[d];
+    }
+    return;
+  }
+
+  if (time != phaseTime) setTime(time);
+
+  ptrdiff_t stride = profiles.getStride(axis);
+  for (int d=0; d<3; ++d) {
+    const double *z = profiles.getZ(d, start);
+    const double *re = profiles.getRe(d, start);
+    const double *im = profiles.getIm(d, start);
+    double *out = h[d];
+    for (int n=0; n<count; ++n) {
+      out[n] = getHComponent(d, z[n*stride], re[n*stride], im[n*stride]);
+    }
+  }
+}
 
 
 GaussBeamSourceHFunc::GaussBeamSourceHFunc(Direction /* dir */, SimulationContext &context)
-  : context(context)
+  : phaseTime(std::numeric_limits<double>::quiet_NaN()), context(context)
 {}
 
 void GaussBeamSourceHFunc::setParam(Vector k,
@@ -269,75 +381,105 @@ void GaussBeamSourceHFunc::setParam(Vector k,
   om = clight*kn/sqrt(eps);
   zr = kn*kn*waist*waist/2.0;
 
-  dx = context.getDx();
 }
 
+void GaussBeamSourceHFunc::initSourceFunc(Grid &Jx, Grid & /* Jy */, Grid & /* Jz */)
+{
 #ifdef HUERTO_TWO_DIM
-Vector3d GaussBeamSourceHFunc::getEField(int i, int j, double time) {
-  double realtime = time;
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1]);
+  });
+#endif
 
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
+#ifdef HUERTO_THREE_DIM
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1], pos[2]);
+  });
+#endif
+}
 
-  Vector3d zA(k[0]*(x+0.5*dx[0]) + k[1]*y,
-              k[0]*x + k[1]*(y+0.5*dx[1]),
+void GaussBeamSourceHFunc::setTime(double time)
+{
+  phaseTime = time;
+  phase = om*(time);
+  cosPhase = cos(phase);
+  sinPhase = sin(phase);
+}
+
+#ifdef HUERTO_TWO_DIM
+BeamProfile GaussBeamSourceHFunc::getProfile(int i, int j)
+{
+  // The current position relative to the origin in m
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+
+  // The normalised position along the beam axis
+  Vector3d zA(k[0]*xh + k[1]*y,
+              k[0]*x + k[1]*yh,
               k[0]*x + k[1]*y);
 
-  Vector3d pA(kperp[0]*(x+0.5*dx[0]) + kperp[1]*y,
-              kperp[0]*x + kperp[1]*(y+0.5*dx[1]),
+  // The position perpendicular to the beam axis in physical units
+  Vector3d pA(kperp[0]*xh + kperp[1]*y,
+              kperp[0]*x + kperp[1]*yh,
               kperp[0]*x + kperp[1]*y);
 
-  Vector3d e;
+  BeamProfile profile;
   for (int d=0; d<3; ++d) {
     // z is normalised to the wavelength because k is the wavevector in 1/m
     double z = zA[d];
 
     // r is NOT normalised because kperp has been normalised to length 1
     double r = pA[d];
+
+    // The current beam width away from the focal point in m
     double w = waist*sqrt(1 + z*z/(zr*zr));
+
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
-
-    double zenv = (z + offset)/rise;
-    double env = (zenv>0) ? exp(-zenv*zenv) : 1.0;
+    double amp = sqrt(waist/w)*exp( -std::pow( r/w, 2*superGaussian) );
 
-    double amp = sqrt(waist/w)*env*exp( - std::pow( r/w, 2*superGaussian));
-    e[d] = amp*(E[d]*sin(z + ph) + Ep[d]*cos(z + ph));
-
-//    if (j == 1000 && i>1000) {
-//      std::cout << "getEField " << i << ":" << d << " " << z << " " << r << " " << w << " | "
-//              << Rinv << " "  << ph << " "  << zenv << " "  << env << " | "  << amp << " " << e[d] << std::endl;
-//    }
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
   }
 
-  return e;
+  return profile;
+}
+
+Vector3d GaussBeamSourceHFunc::getEField(int i, int j, double time)
+{
+  return getEField(lookupProfile(Index(i, j)), time);
 }
 #endif
 
 #ifdef HUERTO_THREE_DIM
-Vector3d GaussBeamSourceHFunc::getEField(int i, int j, int l, double time) {
-  double realtime = time;
-
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
-  double z = l*dx[2] - origin[2];
-
-  Vector3d zA(k[0]*(x+0.5*dx[0]) + k[1]*y + k[2]*z,
-              k[0]*x + k[1]*(y+0.5*dx[1]) + k[2]*z,
-              k[0]*x + k[1]*y + k[2]*(z+0.5*dx[2]));
-
-  Vector3d pA(kperpA[0]*(x+0.5*dx[0]) + kperpA[1]*y + kperpA[2]*z,
-              kperpA[0]*x + kperpA[1]*(y+0.5*dx[1]) + kperpA[2]*z,
-              kperpA[0]*x + kperpA[1]*y + kperpA[2]*(z+0.5*dx[2]));
-
-  Vector3d pB(kperpB[0]*(x+0.5*dx[0]) + kperpB[1]*y + kperpB[2]*z,
-              kperpB[0]*x + kperpB[1]*(y+0.5*dx[1]) + kperpB[2]*z,
-              kperpB[0]*x + kperpB[1]*y + kperpB[2]*(z+0.5*dx[2]));
-
-  Vector3d e;
-  for (int d=0; d<3; ++d) {
+BeamProfile GaussBeamSourceHFunc::getProfile(int i, int j, int l)
+{
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+  double z = context.getPosition(2, l) - origin[2];
+  double zh = context.getPosition(2, l + 0.5) - origin[2];
+
+  Vector3d zA(k[0]*xh + k[1]*y + k[2]*z,
+              k[0]*x + k[1]*yh + k[2]*z,
+              k[0]*x + k[1]*y + k[2]*zh);
+
+  Vector3d pA(kperpA[0]*xh + kperpA[1]*y + kperpA[2]*z,
+              kperpA[0]*x + kperpA[1]*yh + kperpA[2]*z,
+              kperpA[0]*x + kperpA[1]*y + kperpA[2]*zh);
+
+  Vector3d pB(kperpB[0]*xh + kperpB[1]*y + kperpB[2]*z,
+              kperpB[0]*x + kperpB[1]*yh + kperpB[2]*z,
+              kperpB[0]*x + kperpB[1]*y + kperpB[2]*zh);
+
+  BeamProfile profile;
+  for (int d=0; d<3; ++d)
+  {
     // z is normalised to the wavelength because k is the wavevector in 1/m
     double z = zA[d];
     // r is NOT normalised because kperp has been normalised to length 1
@@ -349,18 +491,89 @@ Vector3d GaussBeamSourceHFunc::getEField(int i, int j, int l, double time) {
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
+    double amp = sqrt(waist/w)*exp( -std::pow( r/w, 2*superGaussian) );
+
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
+  }
+
+  return profile;
+}
+
+Vector3d GaussBeamSourceHFunc::getEField(int i, int j, int l, double time)
+{
+  return getEField(lookupProfile(Index(i, j, l)), time);
+}
+#endif
+
+BeamProfile GaussBeamSourceHFunc::lookupProfile(const Index &pos)
+{
+  if (profiles.contains(pos)) return profiles.get(pos);
+#ifdef HUERTO_TWO_DIM
+  return getProfile(pos[0], pos[1]);
+#endif
+#ifdef HUERTO_THREE_DIM
+  return getProfile(pos[0], pos[1], pos[2]);
+#endif
+}
+
+inline double GaussBeamSourceHFunc::getEComponent(int c, double z, double re, double im) const
+{
+  double zenv = (z - phase + offset)/rise;
+  double env = (zenv>0) ? exp(-zenv*zenv) : 1.0;
+
+  // The rotated phasor gives amp*sin(z + ph - phase) and amp*cos(z + ph - phase)
+  double s = im*cosPhase - re*sinPhase;
+  double cs = re*cosPhase + im*sinPhase;
+
+  return env*(E[c]*s + Ep[c]*cs);
+}
 
-    double zenv = (z + offset)/rise;
-    double env = (zenv>0) ? exp(-zenv*zenv) : 1.0;
+Vector3d GaussBeamSourceHFunc::getEField(const BeamProfile &profile, double time)
+{
+  if (time != phaseTime) setTime(time);
 
-    double amp = sqrt(waist/w)*env*exp( - std::pow( r/w, 2*superGaussian));
-    e[d] = amp*(E[d]*sin(z + ph) + Ep[d]*cos(z + ph));
+  Vector3d e;
+  for (int d=0; d<3; ++d) {
+    e[d] = getEComponent(d, profile.z[d], profile.re[d], profile.im[d]);
   }
 
   return e;
 }
-#endif
+
+void GaussBeamSourceHFunc::getEFieldRow(const Index &start,
+                                        int axis,
+                                        int count,
+                                        double time,
+                                        double *ex,
+                                        double *ey,
+                                        double *ez)
+{
+  double *e[3] = {ex, ey, ez};
+
+  if (!profiles.contains(start, axis, count)) {
+    Index pos = start;
+    for (int n=0; n<count; ++n, ++pos[axis]) {
+      Vector3d value = getEField(lookupProfile(pos), time);
+      for (int d=0; d<3; ++d) e[d][n] = value[d];
+    }
+    return;
+  }
+
+  if (time != phaseTime) setTime(time);
+
+  ptrdiff_t stride = profiles.getStride(axis);
+  for (int d=0; d<3; ++d) {
+    const double *z = profiles.getZ(d, start);
+    const double *re = profiles.getRe(d, start);
+    const double *im = profiles.getIm(d, start);
+    double *out = e[d];
+    for (int n=0; n<count; ++n) {
+      out[n] = getEComponent(d, z[n*stride], re[n*stride], im[n*stride]);
+    }
+  }
+}
 
 
 
@@ -425,7 +638,7 @@ void GaussPulseSource::initParameters(schnek::BlockParameters &blockPars)
 
 
 GaussPulseSourceEFunc::GaussPulseSourceEFunc(Direction /* dir */, SimulationContext &context)
-  : context(context)
+  : phaseTime(std::numeric_limits<double>::quiet_NaN()), context(context)
 {}
 
 void GaussPulseSourceEFunc::setParam(
@@ -467,32 +680,52 @@ void GaussPulseSourceEFunc::setParam(
   om = clight*kn/sqrt(eps);
   zr = kn*kn*waist*waist/2.0;
 
-  dx = context.getDx();
 }
 
 
+void GaussPulseSourceEFunc::initSourceFunc(Grid &Jx, Grid & /* Jy */, Grid & /* Jz */)
+{
 #ifdef HUERTO_TWO_DIM
-Vector3d GaussPulseSourceEFunc::getHField(int i, int j, double time)
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1]);
+  });
+#endif
+
+#ifdef HUERTO_THREE_DIM
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1], pos[2]);
+  });
+#endif
+}
+
+void GaussPulseSourceEFunc::setTime(double time)
 {
-  // The current time in s
-  double realtime = time - 0.5*dt;
+  phaseTime = time;
+  phase = om*(time - 0.5*dt);
+  cosPhase = cos(phase);
+  sinPhase = sin(phase);
+}
 
+#ifdef HUERTO_TWO_DIM
+BeamProfile GaussPulseSourceEFunc::getProfile(int i, int j)
+{
   // The current position relative to the origin in m
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
 
   // The normalised position along the beam axis
-  Vector3d zA(k[0]*x + k[1]*(y+0.5*dx[1]),
-              k[0]*(x+0.5*dx[0]) + k[1]*y,
-              k[0]*(x+0.5*dx[0]) + k[1]*(y+0.5*dx[1]));
+  Vector3d zA(k[0]*x + k[1]*yh,
+              k[0]*xh + k[1]*y,
+              k[0]*xh + k[1]*yh);
 
   // The position perpendicular to the beam axis in physical units
-  Vector3d pA(kperp[0]*x + kperp[1]*(y+0.5*dx[1]),
-              kperp[0]*(x+0.5*dx[0]) + kperp[1]*y,
-              kperp[0]*(x+0.5*dx[0]) + kperp[1]*(y+0.5*dx[1]));
-
+  Vector3d pA(kperp[0]*x + kperp[1]*yh,
+              kperp[0]*xh + kperp[1]*y,
+              kperp[0]*xh + kperp[1]*yh);
 
-  Vector3d h;
+  BeamProfile profile;
   for (int d=0; d<3; ++d) {
     // z is normalised to the wavelength because k is the wavevector in 1/m
     double z = zA[d];
@@ -506,40 +739,45 @@ Vector3d GaussPulseSourceEFunc::getHField(int i, int j, double time)
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
-
-    double zenv = (z + offset)/length;
+    double amp = sqrt(waist/w)*exp(-r*r/(w*w));
 
-    double amp = H[d]*sqrt(waist/w)*exp(-zenv*zenv - r*r/(w*w));
-    h[d] = amp*sin(z + ph);
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
   }
 
-  return h;
+  return profile;
+}
+
+Vector3d GaussPulseSourceEFunc::getHField(int i, int j, double time)
+{
+  return getHField(lookupProfile(Index(i, j)), time);
 }
 #endif
 
 #ifdef HUERTO_THREE_DIM
-Vector3d GaussPulseSourceEFunc::getHField(int i, int j, int l, double time)
+BeamProfile GaussPulseSourceEFunc::getProfile(int i, int j, int l)
 {
-  double realtime = time - 0.5*dt;
-
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
-  double z = l*dx[2] - origin[2];
-
-  Vector3d zA(k[0]*x + k[1]*(y+0.5*dx[1]) + k[2]*(z+0.5*dx[2]),
-              k[0]*(x+0.5*dx[0]) + k[1]*y + k[2]*(z+0.5*dx[2]),
-              k[0]*(x+0.5*dx[0]) + k[1]*(y+0.5*dx[1]) + k[2]*z);
-
-  Vector3d pA(kperpA[0]*x + kperpA[1]*(y+0.5*dx[1]) + kperpA[2]*(z+0.5*dx[2]),
-              kperpA[0]*(x+0.5*dx[0]) + kperpA[1]*y + kperpA[2]*(z+0.5*dx[2]),
-              kperpA[0]*(x+0.5*dx[0]) + kperpA[1]*(y+0.5*dx[1]) + kperpA[2]*z);
-
-  Vector3d pB(kperpB[0]*x + kperpB[1]*(y+0.5*dx[1]) + kperpB[2]*(z+0.5*dx[2]),
-              kperpB[0]*(x+0.5*dx[0]) + kperpB[1]*y + kperpB[2]*(z+0.5*dx[2]),
-              kperpB[0]*(x+0.5*dx[0]) + kperpB[1]*(y+0.5*dx[1]) + kperpB[2]*z);
-
-  Vector3d h;
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+  double z = context.getPosition(2, l) - origin[2];
+  double zh = context.getPosition(2, l + 0.5) - origin[2];
+
+  Vector3d zA(k[0]*x + k[1]*yh + k[2]*zh,
+              k[0]*xh + k[1]*y + k[2]*zh,
+              k[0]*xh + k[1]*yh + k[2]*z);
+
+  Vector3d pA(kperpA[0]*x + kperpA[1]*yh + kperpA[2]*zh,
+              kperpA[0]*xh + kperpA[1]*y + kperpA[2]*zh,
+              kperpA[0]*xh + kperpA[1]*yh + kperpA[2]*z);
+
+  Vector3d pB(kperpB[0]*x + kperpB[1]*yh + kperpB[2]*zh,
+              kperpB[0]*xh + kperpB[1]*y + kperpB[2]*zh,
+              kperpB[0]*xh + kperpB[1]*yh + kperpB[2]*z);
+
+  BeamProfile profile;
   for (int d=0; d<3; ++d)
   {
     // z is normalised to the wavelength because k is the wavevector in 1/m
@@ -553,20 +791,90 @@ Vector3d GaussPulseSourceEFunc::getHField(int i, int j, int l, double time)
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
+    double amp = sqrt(waist/w)*exp(-r*r/(w*w));
 
-    double zenv = (z + offset)/length;
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
+  }
+
+  return profile;
+}
 
-    double amp = H[d]*sqrt(waist/w)*exp(-zenv*zenv - r*r/(w*w));
-    h[d] = amp*sin(z + ph);
+Vector3d GaussPulseSourceEFunc::getHField(int i, int j, int l, double time)
+{
+  return getHField(lookupProfile(Index(i, j, l)), time);
+}
+#endif
+
+BeamProfile GaussPulseSourceEFunc::lookupProfile(const Index &pos)
+{
+  if (profiles.contains(pos)) return profiles.get(pos);
+#ifdef HUERTO_TWO_DIM
+  return getProfile(pos[0], pos[1]);
+#endif
+#ifdef HUERTO_THREE_DIM
+  return getProfile(pos[0], pos[1], pos[2]);
+#endif
+}
+
+inline double GaussPulseSourceEFunc::getHComponent(int c, double z, double re, double im) const
+{
+  double zenv = (z - phase + offset)/length;
+
+  // The rotated phasor gives amp*sin(z + ph - phase)
+  double s = im*cosPhase - re*sinPhase;
+
+  return H[c]*exp(-zenv*zenv)*s;
+}
+
+Vector3d GaussPulseSourceEFunc::getHField(const BeamProfile &profile, double time)
+{
+  if (time != phaseTime) setTime(time);
+
+  Vector3d h;
+  for (int d=0; d<3; ++d) {
+    h[d] = getHComponent(d, profile.z[d], profile.re[d], profile.im[d]);
   }
 
   return h;
 }
-#endif
+
+void GaussPulseSourceEFunc::getHFieldRow(const Index &start,
+                                         int axis,
+                                         int count,
+                                         double time,
+                                         double *hx,
+                                         double *hy,
+                                         double *hz)
+{
+  double *h[3] = {hx, hy, hz};
+
+  if (!profiles.contains(start, axis, count)) {
+    Index pos = start;
+    for (int n=0; n<count; ++n, ++pos[axis]) {
+      Vector3d value = getHField(lookupProfile(pos), time);
+      for (int d=0; d<3; ++d) h[d][n] = value[d];
+    }
+    return;
+  }
+
+  if (time != phaseTime) setTime(time);
+
+  ptrdiff_t stride = profiles.getStride(axis);
+  for (int d=0; d<3; ++d) {
+    const double *z = profiles.getZ(d, start);
+    const double *re = profiles.getRe(d, start);
+    const double *im = profiles.getIm(d, start);
+    double *out = h[d];
+    for (int n=0; n<count; ++n) {
+      out[n] = getHComponent(d, z[n*stride], re[n*stride], im[n*stride]);
+    }
+  }
+}
 
 GaussPulseSourceHFunc::GaussPulseSourceHFunc(Direction /* dir */, SimulationContext &context)
-  : context(context)
+  : phaseTime(std::numeric_limits<double>::quiet_NaN()), context(context)
 {}
 
 void GaussPulseSourceHFunc::setParam(Vector k, Vector origin, Vector3d E, double waist, double length, double offset, double eps)
@@ -599,87 +907,105 @@ void GaussPulseSourceHFunc::setParam(Vector k, Vector origin, Vector3d E, double
   om = clight*kn/sqrt(eps);
   zr = kn*kn*waist*waist/2.0;
 
-  dx = context.getDx();
 }
 
+void GaussPulseSourceHFunc::initSourceFunc(Grid &Jx, Grid & /* Jy */, Grid & /* Jz */)
+{
 #ifdef HUERTO_TWO_DIM
-Vector3d GaussPulseSourceHFunc::getEField(int i, int j, double time)
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1]);
+  });
+#endif
+
+#ifdef HUERTO_THREE_DIM
+  profiles.fill(getProfileRange(Jx), [this](const Index &pos) {
+    return getProfile(pos[0], pos[1], pos[2]);
+  });
+#endif
+}
+
+void GaussPulseSourceHFunc::setTime(double time)
 {
-  double realtime = time;
+  phaseTime = time;
+  phase = om*(time);
+  cosPhase = cos(phase);
+  sinPhase = sin(phase);
+}
 
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
+#ifdef HUERTO_TWO_DIM
+BeamProfile GaussPulseSourceHFunc::getProfile(int i, int j)
+{
+  // The current position relative to the origin in m
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
 
-  Vector3d zA(k[0]*(x+0.5*dx[0]) + k[1]*y,
-              k[0]*x + k[1]*(y+0.5*dx[1]),
+  // The normalised position along the beam axis
+  Vector3d zA(k[0]*xh + k[1]*y,
+              k[0]*x + k[1]*yh,
               k[0]*x + k[1]*y);
 
-  Vector3d pA(kperp[0]*(x+0.5*dx[0]) + kperp[1]*y,
-              kperp[0]*x + kperp[1]*(y+0.5*dx[1]),
+  // The position perpendicular to the beam axis in physical units
+  Vector3d pA(kperp[0]*xh + kperp[1]*y,
+              kperp[0]*x + kperp[1]*yh,
               kperp[0]*x + kperp[1]*y);
 
-  Vector3d e;
+  BeamProfile profile;
   for (int d=0; d<3; ++d) {
     // z is normalised to the wavelength because k is the wavevector in 1/m
     double z = zA[d];
 
     // r is NOT normalised because kperp has been normalised to length 1
     double r = pA[d];
+
+    // The current beam width away from the focal point in m
     double w = waist*sqrt(1 + z*z/(zr*zr));
+
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
-
-    double zenv = (z + offset)/length;
-
-    double amp = E[d]*sqrt(waist/w)*exp(-zenv*zenv - r*r/(w*w));
-    e[d] = amp*sin(z + ph);
-
-    // @TODO
-    // simplify Gaussian and plane wave sources and allow arbitrary temporal profiles
-    // e.g. Sin squared
-    //
-    // if (fabs(zenv)>1.0)
-    // {
-    //   e[d] = 0.0;
-    // }
-    // else
-    // {
-    //   double c = cos(M_PI_2*zenv);
-    //   double amp = E[d]* c*c;
-    //   e[d] = amp*sin(z + ph);
-    // }
-    //
-    // or custom profile specified in setup file
+    double amp = sqrt(waist/w)*exp(-r*r/(w*w));
+
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
   }
 
-  return e;
+  return profile;
+}
+
+Vector3d GaussPulseSourceHFunc::getEField(int i, int j, double time)
+{
+  return getEField(lookupProfile(Index(i, j)), time);
 }
 #endif
 
 #ifdef HUERTO_THREE_DIM
-Vector3d GaussPulseSourceHFunc::getEField(int i, int j, int l, double time) {
-  double realtime = time;
-
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
-  double z = l*dx[2] - origin[2];
-
-  Vector3d zA(k[0]*(x+0.5*dx[0]) + k[1]*y + k[2]*z,
-              k[0]*x + k[1]*(y+0.5*dx[1]) + k[2]*z,
-              k[0]*x + k[1]*y + k[2]*(z+0.5*dx[2]));
-
-  Vector3d pA(kperpA[0]*(x+0.5*dx[0]) + kperpA[1]*y + kperpA[2]*z,
-              kperpA[0]*x + kperpA[1]*(y+0.5*dx[1]) + kperpA[2]*z,
-              kperpA[0]*x + kperpA[1]*y + kperpA[2]*(z+0.5*dx[2]));
-
-  Vector3d pB(kperpB[0]*(x+0.5*dx[0]) + kperpB[1]*y + kperpB[2]*z,
-              kperpB[0]*x + kperpB[1]*(y+0.5*dx[1]) + kperpB[2]*z,
-              kperpB[0]*x + kperpB[1]*y + kperpB[2]*(z+0.5*dx[2]));
-
-  Vector3d e;
-  for (int d=0; d<3; ++d) {
+BeamProfile GaussPulseSourceHFunc::getProfile(int i, int j, int l)
+{
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+  double z = context.getPosition(2, l) - origin[2];
+  double zh = context.getPosition(2, l + 0.5) - origin[2];
+
+  Vector3d zA(k[0]*xh + k[1]*y + k[2]*z,
+              k[0]*x + k[1]*yh + k[2]*z,
+              k[0]*x + k[1]*y + k[2]*zh);
+
+  Vector3d pA(kperpA[0]*xh + kperpA[1]*y + kperpA[2]*z,
+              kperpA[0]*x + kperpA[1]*yh + kperpA[2]*z,
+              kperpA[0]*x + kperpA[1]*y + kperpA[2]*zh);
+
+  Vector3d pB(kperpB[0]*xh + kperpB[1]*y + kperpB[2]*z,
+              kperpB[0]*x + kperpB[1]*yh + kperpB[2]*z,
+              kperpB[0]*x + kperpB[1]*y + kperpB[2]*zh);
+
+  BeamProfile profile;
+  for (int d=0; d<3; ++d)
+  {
     // z is normalised to the wavelength because k is the wavevector in 1/m
     double z = zA[d];
     // r is NOT normalised because kperp has been normalised to length 1
@@ -691,16 +1017,92 @@ Vector3d GaussPulseSourceHFunc::getEField(int i, int j, int l, double time) {
     double Rinv = z / (z*z + zr*zr);
     double ph = 0.5*kn*kn*r*r*Rinv;
 
-    z -= om*realtime;
+    double amp = sqrt(waist/w)*exp(-r*r/(w*w));
+
+    profile.z[d] = z;
+    profile.re[d] = amp*cos(z + ph);
+    profile.im[d] = amp*sin(z + ph);
+  }
+
+  return profile;
+}
+
+Vector3d GaussPulseSourceHFunc::getEField(int i, int j, int l, double time)
+{
+  return getEField(lookupProfile(Index(i, j, l)), time);
+}
+#endif
+
+BeamProfile GaussPulseSourceHFunc::lookupProfile(const Index &pos)
+{
+  if (profiles.contains(pos)) return profiles.get(pos);
+#ifdef HUERTO_TWO_DIM
+  return getProfile(pos[0], pos[1]);
+#endif
+#ifdef HUERTO_THREE_DIM
+  return getProfile(pos[0], pos[1], pos[2]);
+#endif
+}
+
+inline double GaussPulseSourceHFunc::getEComponent(int c, double z, double re, double im) const
+{
+  double zenv = (z - phase + offset)/length;
 
-    double zenv = (z + offset)/length;
+  // The rotated phasor gives amp*sin(z + ph - phase)
+  double s = im*cosPhase - re*sinPhase;
 
-    double amp = E[d]*sqrt(waist/w)*exp(-zenv*zenv - r*r/(w*w));
-    e[d] = amp*sin(z + ph);
+  // @TODO
+  // simplify Gaussian and plane wave sources and allow arbitrary temporal profiles
+  // e.g. Sin squared
+  //
+  // or custom profile specified in setup file
+
+  return E[c]*exp(-zenv*zenv)*s;
+}
+
+Vector3d GaussPulseSourceHFunc::getEField(const BeamProfile &profile, double time)
+{
+  if (time != phaseTime) setTime(time);
+
+  Vector3d e;
+  for (int d=0; d<3; ++d) {
+    e[d] = getEComponent(d, profile.z[d], profile.re[d], profile.im[d]);
   }
 
   return e;
 }
-#endif
+
+void GaussPulseSourceHFunc::getEFieldRow(const Index &start,
+                                         int axis,
+                                         int count,
+                                         double time,
+                                         double *ex,
+                                         double *ey,
+                                         double *ez)
+{
+  double *e[3] = {ex, ey, ez};
+
+  if (!profiles.contains(start, axis, count)) {
+    Index pos = start;
+    for (int n=0; n<count; ++n, ++pos[axis]) {
+      Vector3d value = getEField(lookupProfile(pos), time);
+      for (int d=0; d<3; ++d) e[d][n] = value[d];
+    }
+    return;
+  }
+
+  if (time != phaseTime) setTime(time);
+
+  ptrdiff_t stride = profiles.getStride(axis);
+  for (int d=0; d<3; ++d) {
+    const double *z = profiles.getZ(d, start);
+    const double *re = profiles.getRe(d, start);
+    const double *im = profiles.getIm(d, start);
+    double *out = e[d];
+    for (int n=0; n<count; ++n) {
+      out[n] = getEComponent(d, z[n*stride], re[n*stride], im[n*stride]);
+    }
+  }
+}
 
 #endif // not HUERTO_ONE_DIM
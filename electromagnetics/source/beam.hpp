@@ -10,11 +10,148 @@
 
 #include "incsource.hpp"
 
+#include <vector>
+
+#ifndef HUERTO_ONE_DIM
+
 //===============================================================
-//==========  Gaussian Beam Source
+//==========  Beam Profile Cache
 //===============================================================
 
-#ifndef HUERTO_ONE_DIM
+/**
+ * The time-independent part of a Gaussian beam at a single grid point
+ *
+ * For each field component, this holds the position along the beam axis and the
+ * complex amplitude of the beam. The complex amplitude includes the beam waist,
+ * the transverse profile, the Gouy phase, and the curvature of the wave fronts.
+ */
+struct BeamProfile
+{
+    /// The position along the beam axis normalised to the inverse wavenumber
+    double z[3];
+
+    /// The real part of the complex amplitude, `amp*cos(z + ph)`
+    double re[3];
+
+    /// The imaginary part of the complex amplitude, `amp*sin(z + ph)`
+    double im[3];
+};
+
+/**
+ * The beam profiles on the grid points of an injection plane
+ *
+ * The profiles are calculated once when the source is initialised. In each
+ * time step, the field is then obtained by rotating the complex amplitude and
+ * multiplying it with the temporal envelope. Grid points outside the cache, for
+ * example after the MovingWindow has been shifted, are evaluated directly.
+ *
+ * The values are stored as separate arrays for each quantity and component so
+ * that rows of grid points can be evaluated in vectorisable loops.
+ */
+class BeamProfileCache
+{
+  public:
+    /**
+     * Calculate the profiles for all grid indices in `range`
+     *
+     * `func` is called with each grid index and should return the BeamProfile
+     * at that index.
+     */
+    template<class Func>
+    void fill(const Range &range, Func func)
+    {
+      this->range = range;
+      size_t size = 1;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        size *= range.getHi(d) - range.getLo(d) + 1;
+      }
+      for (int c=0; c<3; ++c) {
+        z[c].resize(size);
+        re[c].resize(size);
+        im[c].resize(size);
+      }
+      schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos) {
+        BeamProfile profile = func(pos);
+        size_t index = offset(pos);
+        for (int c=0; c<3; ++c) {
+          z[c][index] = profile.z[c];
+          re[c][index] = profile.re[c];
+          im[c][index] = profile.im[c];
+        }
+      });
+    }
+
+    /**
+     * Returns true if `count` grid points starting at `start` along `axis` are cached
+     */
+    bool contains(const Index &start, int axis = 0, int count = 1) const
+    {
+      if (z[0].empty() || !range.inside(start)) return false;
+      return start[axis] + count - 1 <= range.getHi(axis);
+    }
+
+    /**
+     * The cached profile at a grid index
+     */
+    BeamProfile get(const Index &pos) const
+    {
+      BeamProfile profile;
+      size_t index = offset(pos);
+      for (int c=0; c<3; ++c) {
+        profile.z[c] = z[c][index];
+        profile.re[c] = re[c][index];
+        profile.im[c] = im[c][index];
+      }
+      return profile;
+    }
+
+    /**
+     * The distance in memory between neighbouring grid points along `axis`
+     */
+    ptrdiff_t getStride(int axis) const
+    {
+      ptrdiff_t stride = 1;
+      for (int d=DIMENSION-1; d>axis; --d) {
+        stride *= range.getHi(d) - range.getLo(d) + 1;
+      }
+      return stride;
+    }
+
+    /// Pointer to the position along the beam axis of component `c` at a grid index
+    const double *getZ(int c, const Index &pos) const { return z[c].data() + offset(pos); }
+
+    /// Pointer to the real part of the amplitude of component `c` at a grid index
+    const double *getRe(int c, const Index &pos) const { return re[c].data() + offset(pos); }
+
+    /// Pointer to the imaginary part of the amplitude of component `c` at a grid index
+    const double *getIm(int c, const Index &pos) const { return im[c].data() + offset(pos); }
+
+  private:
+    size_t offset(const Index &pos) const
+    {
+      size_t index = 0;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        index = index*(range.getHi(d) - range.getLo(d) + 1) + (pos[d] - range.getLo(d));
+      }
+      return index;
+    }
+
+    /// The range of grid indices covered by the cache
+    Range range;
+
+    /// The positions along the beam axis, stored in row-major order
+    std::vector<double> z[3];
+
+    /// The real parts of the complex amplitudes, stored in row-major order
+    std::vector<double> re[3];
+
+    /// The imaginary parts of the complex amplitudes, stored in row-major order
+    std::vector<double> im[3];
+};
+
+//===============================================================
+//==========  Gaussian Beam Source
+//===============================================================
 
 class GaussBeamSource : public IncidentSource
 {
@@ -85,10 +222,47 @@ class GaussBeamSourceEFunc
     Vector3d getHField(int i, int j, int k, double time);
 #endif
 
-    void initSourceFunc(Grid&, Grid&, Grid&) {}
-    void setTime(double) {}
+    /**
+     * Calculate the magnetic field for `count` grid points starting at `start` along `axis`
+     *
+     * This is the batched evaluation used by IncidentSourceECurrent.
+     */
+    void getHFieldRow(const Index &start,
+                      int axis,
+                      int count,
+                      double time,
+                      double *hx,
+                      double *hy,
+                      double *hz);
+
+    /**
+     * Calculate the beam profile on the grid points of the injection plane
+     */
+    void initSourceFunc(Grid &Jx, Grid &Jy, Grid &Jz);
+
+    /**
+     * Calculate the phase of the beam at the given time
+     */
+    void setTime(double time);
 
   private:
+#ifdef HUERTO_TWO_DIM
+    BeamProfile getProfile(int i, int j);
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    BeamProfile getProfile(int i, int j, int k);
+#endif
+
+    /// The beam profile at a grid point, taken from the cache if possible
+    BeamProfile lookupProfile(const Index &pos);
+
+    /// Obtain the field from the beam profile at a grid point
+    Vector3d getHField(const BeamProfile &profile, double time);
+
+    /// Obtain a field component from the position along the beam axis and the complex amplitude
+    double getHComponent(int c, double z, double re, double im) const;
+
     /// The wavevector in 1/m
     Vector k;
 
@@ -150,10 +324,19 @@ class GaussBeamSourceEFunc
     /// Multiplaction coefficient for the exponent in the transverse Gaussian profile (default 1)
     int superGaussian;
 
-    /// The grid spacing in m
-    Vector dx;
-
     Direction dir;
+
+    /// The time for which #phase has been calculated
+    double phaseTime;
+
+    /// The phase of the oscillation at #phaseTime
+    double phase;
+    double cosPhase;
+    double sinPhase;
+
+    /// The beam profile on the injection plane
+    BeamProfileCache profiles;
+
     SimulationContext &context;
 };
 
@@ -179,10 +362,47 @@ class GaussBeamSourceHFunc
     Vector3d getEField(int i, int j, int k, double time);
 #endif
 
-    void initSourceFunc(Grid&, Grid&, Grid&) {}
-    void setTime(double) {}
+    /**
+     * Calculate the electric field for `count` grid points starting at `start` along `axis`
+     *
+     * This is the batched evaluation used by IncidentSourceHCurrent.
+     */
+    void getEFieldRow(const Index &start,
+                      int axis,
+                      int count,
+                      double time,
+                      double *ex,
+                      double *ey,
+                      double *ez);
+
+    /**
+     * Calculate the beam profile on the grid points of the injection plane
+     */
+    void initSourceFunc(Grid &Jx, Grid &Jy, Grid &Jz);
+
+    /**
+     * Calculate the phase of the beam at the given time
+     */
+    void setTime(double time);
 
   private:
+#ifdef HUERTO_TWO_DIM
+    BeamProfile getProfile(int i, int j);
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    BeamProfile getProfile(int i, int j, int k);
+#endif
+
+    /// The beam profile at a grid point, taken from the cache if possible
+    BeamProfile lookupProfile(const Index &pos);
+
+    /// Obtain the field from the beam profile at a grid point
+    Vector3d getEField(const BeamProfile &profile, double time);
+
+    /// Obtain a field component from the position along the beam axis and the complex amplitude
+    double getEComponent(int c, double z, double re, double im) const;
+
     /// The wavevector in 1/m
     Vector k;
 
@@ -230,8 +450,16 @@ class GaussBeamSourceHFunc
     /// Multiplaction coefficient for the exponent in the transverse Gaussian profile (default 1)
     int superGaussian;
 
-    /// The grid spacing in m
-    Vector dx;
+    /// The time for which #phase has been calculated
+    double phaseTime;
+
+    /// The phase of the oscillation at #phaseTime
+    double phase;
+    double cosPhase;
+    double sinPhase;
+
+    /// The beam profile on the injection plane
+    BeamProfileCache profiles;
 
     SimulationContext &context;
 };
@@ -276,10 +504,47 @@ class GaussPulseSourceEFunc
     Vector3d getHField(int i, int j, int k, double time);
 #endif
 
-    void initSourceFunc(Grid&, Grid&, Grid&) {}
-    void setTime(double) {}
+    /**
+     * Calculate the magnetic field for `count` grid points starting at `start` along `axis`
+     *
+     * This is the batched evaluation used by IncidentSourceECurrent.
+     */
+    void getHFieldRow(const Index &start,
+                      int axis,
+                      int count,
+                      double time,
+                      double *hx,
+                      double *hy,
+                      double *hz);
+
+    /**
+     * Calculate the beam profile on the grid points of the injection plane
+     */
+    void initSourceFunc(Grid &Jx, Grid &Jy, Grid &Jz);
+
+    /**
+     * Calculate the phase of the beam at the given time
+     */
+    void setTime(double time);
 
   private:
+#ifdef HUERTO_TWO_DIM
+    BeamProfile getProfile(int i, int j);
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    BeamProfile getProfile(int i, int j, int k);
+#endif
+
+    /// The beam profile at a grid point, taken from the cache if possible
+    BeamProfile lookupProfile(const Index &pos);
+
+    /// Obtain the field from the beam profile at a grid point
+    Vector3d getHField(const BeamProfile &profile, double time);
+
+    /// Obtain a field component from the position along the beam axis and the complex amplitude
+    double getHComponent(int c, double z, double re, double im) const;
+
     Vector k;
 #ifdef HUERTO_TWO_DIM
     /// A unit vector perpendicular to the wavevector
@@ -304,7 +569,16 @@ class GaussPulseSourceEFunc
     double offset;
     double eps;
 
-    Vector dx;
+    /// The time for which #phase has been calculated
+    double phaseTime;
+
+    /// The phase of the oscillation at #phaseTime
+    double phase;
+    double cosPhase;
+    double sinPhase;
+
+    /// The beam profile on the injection plane
+    BeamProfileCache profiles;
 
     SimulationContext &context;
 };
@@ -323,10 +597,47 @@ class GaussPulseSourceHFunc
     Vector3d getEField(int i, int j, int k, double time);
 #endif
 
-    void initSourceFunc(Grid&, Grid&, Grid&) {}
-    void setTime(double) {}
+    /**
+     * Calculate the electric field for `count` grid points starting at `start` along `axis`
+     *
+     * This is the batched evaluation used by IncidentSourceHCurrent.
+     */
+    void getEFieldRow(const Index &start,
+                      int axis,
+                      int count,
+                      double time,
+                      double *ex,
+                      double *ey,
+                      double *ez);
+
+    /**
+     * Calculate the beam profile on the grid points of the injection plane
+     */
+    void initSourceFunc(Grid &Jx, Grid &Jy, Grid &Jz);
+
+    /**
+     * Calculate the phase of the beam at the given time
+     */
+    void setTime(double time);
 
   private:
+#ifdef HUERTO_TWO_DIM
+    BeamProfile getProfile(int i, int j);
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    BeamProfile getProfile(int i, int j, int k);
+#endif
+
+    /// The beam profile at a grid point, taken from the cache if possible
+    BeamProfile lookupProfile(const Index &pos);
+
+    /// Obtain the field from the beam profile at a grid point
+    Vector3d getEField(const BeamProfile &profile, double time);
+
+    /// Obtain a field component from the position along the beam axis and the complex amplitude
+    double getEComponent(int c, double z, double re, double im) const;
+
     Vector k;
 #ifdef HUERTO_TWO_DIM
     /// A unit vector perpendicular to the wavevector
@@ -350,7 +661,16 @@ class GaussPulseSourceHFunc
     double offset;
     double eps;
 
-    Vector dx;
+    /// The time for which #phase has been calculated
+    double phaseTime;
+
+    /// The phase of the oscillation at #phaseTime
+    double phase;
+    double cosPhase;
+    double sinPhase;
+
+    /// The beam profile on the injection plane
+    BeamProfileCache profiles;
 
     SimulationContext &context;
 };
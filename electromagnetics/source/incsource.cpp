@@ -8,6 +8,7 @@
 #include "incsource.hpp"
 
 #include "../fieldsolver.hpp"
+#include "../../util/field_util.hpp"
 
 #include <vector>
 #include <sstream>
@@ -63,7 +64,7 @@ void IncidentSource::initParameters(schnek::BlockParameters &blockPars) {
 //===============================================================
 
 IncidentSourceCurrent::IncidentSourceCurrent(int distance, Direction dir, bool isH, SimulationContext &context)
-  : distance(distance), dir(dir), isH(isH), context(context)
+  : distance(distance), dir(dir), isH(isH), active(false), context(context)
 {
   lowOffset = 0;
   highOffset = 0;
@@ -77,8 +78,6 @@ IncidentSourceCurrent::IncidentSourceCurrent(int distance, Direction dir, bool i
     case west:  dim = 0;
                 transverse1 = 1;
                 transverse2 = 2;
-                JT[0] = Jy;
-                JT[1] = Jz;
                 dN = dx[0];
                 break;
 #ifndef HUERTO_ONE_DIM
@@ -86,8 +85,6 @@ IncidentSourceCurrent::IncidentSourceCurrent(int distance, Direction dir, bool i
     case south: dim = 1;
                 transverse1 = 2;
                 transverse2 = 0;
-                JT[0] = Jz;
-                JT[1] = Jx;
                 dN = dx[1];
                 break;
 #endif
@@ -96,8 +93,6 @@ IncidentSourceCurrent::IncidentSourceCurrent(int distance, Direction dir, bool i
     case down:  dim = 2;
                 transverse1 = 0;
                 transverse2 = 1;
-                JT[0] = Jx;
-                JT[1] = Jy;
                 dN = dx[2];
                 break;
 #endif
@@ -116,3 +111,33 @@ IncidentSourceCurrent::IncidentSourceCurrent(int distance, Direction dir, bool i
 #endif
 }
 
+bool IncidentSourceCurrent::initSheet(const Index &blow, const Index &bhigh)
+{
+  auto &decomposition = context.getDecomposition();
+  Range range{blow, bhigh};
+
+  Jx = decomposition.registerField(schnek::GridFactory<Grid>{}, range);
+  Jy = decomposition.registerField(schnek::GridFactory<Grid>{}, range);
+  Jz = decomposition.registerField(schnek::GridFactory<Grid>{}, range);
+
+  setField<Grid>(decomposition, Jx, 0.0);
+  setField<Grid>(decomposition, Jy, 0.0);
+  setField<Grid>(decomposition, Jz, 0.0);
+
+  active = false;
+  decomposition.getGridContext({Jx, Jy, Jz}).forEach([&](Range local, Grid &jx, Grid &jy, Grid &jz) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      if (local.getLo(d) > local.getHi(d)) return;
+    }
+    localJ[0] = jx;
+    localJ[1] = jy;
+    localJ[2] = jz;
+    active = true;
+  });
+
+  if (!active) return false;
+
+  JT[0] = localJ[transverse1];
+  JT[1] = localJ[transverse2];
+  return true;
+}
@@ -11,6 +11,9 @@
 #include "../../types.hpp"
 #include "../current.hpp"
 
+#include <type_traits>
+#include <vector>
+
 class IncidentSourceCurrent;
 
 //===============================================================
@@ -22,6 +25,10 @@ class IncidentSourceCurrent;
  *
  * Sources for time-dependent electromagnetic fields are represented by
  * transverse currents on the boundary.
+ *
+ * With a MovingWindow, the current sheets stay at the boundary of the window.
+ * The source functions are evaluated in the frame of the initial window, so that
+ * the injected wave stays consistent with the fields inside the window.
  */
 class IncidentSource : public CurrentBlock {
   public:
@@ -70,7 +77,8 @@ class IncidentSource : public CurrentBlock {
  * An incident source current
  *
  * Incident source currents are intended to be used with #IncidentSource current
- * blocks. They define a transverse current on a boundary plane.
+ * blocks. They define a transverse current on a boundary plane. Processes whose
+ * local domain does not touch the plane skip the current entirely.
  */
 class IncidentSourceCurrent : public Current {
   public:
@@ -133,11 +141,20 @@ class IncidentSourceCurrent : public Current {
     double dt;
 
     /**
-     * References to the transverse components of the current from #Current.Jx,
-     * #Current.Jy, and #Current.Jz
+     * The local grids of the components of the current
+     */
+    Grid localJ[3];
+
+    /**
+     * References to the local grids of the transverse components of the current
      */
     Grid JT[2];
 
+    /**
+     * True if the current sheet intersects the local domain of this process
+     */
+    bool active;
+
     /**
      * The grid spacing in the direction normal to the injection plane
      */
@@ -147,6 +164,16 @@ class IncidentSourceCurrent : public Current {
      * The simulation context
      */
     SimulationContext &context;
+
+    /**
+     * Register the components of the current with the decomposition
+     *
+     * The current sheet covers the range from `blow` to `bhigh` of the global
+     * grid. Like the CPML currents, each process only allocates the part of the
+     * sheet that lies inside its local domain. Returns false and leaves #active
+     * unset if the sheet does not intersect the local domain.
+     */
+    bool initSheet(const Index &blow, const Index &bhigh);
 };
 
 /**
@@ -156,6 +183,12 @@ class IncidentSourceCurrent : public Current {
  * value of the **magnetic field**. `SourceFunc` must expose a method
  * `getHField` to obtain this field and a method `initSourceFunc` to initialise
  * the source function.
+ *
+ * `SourceFunc` can optionally expose a batched method
+ * `getHFieldRow(const Index &start, int axis, int count, double time, double *hx, double *hy, double *hz)`
+ * that fills the field components of `count` grid points, starting at `start`
+ * and running along `axis`. If this method exists, the current sheet is filled
+ * row by row. Otherwise `getHField` is called for each grid point.
  */
 template<class SourceFunc>
 class IncidentSourceECurrent : public IncidentSourceCurrent, public SourceFunc {
@@ -174,6 +207,21 @@ class IncidentSourceECurrent : public IncidentSourceCurrent, public SourceFunc {
     void init();
     void stepSchemeInit(double dt);
     void stepScheme(double dt);
+  private:
+    /**
+     * Fill the current sheet by evaluating the source function at each grid point
+     */
+    void fillSheet(std::false_type, const Index &off, double factor, double Time);
+
+    /**
+     * Fill the current sheet by evaluating the source function row by row
+     */
+    void fillSheet(std::true_type, const Index &off, double factor, double Time);
+
+    /**
+     * The field components of a single row, used by the batched evaluation
+     */
+    std::vector<double> rowBuffer[3];
 };
 
 /**
@@ -183,6 +231,12 @@ class IncidentSourceECurrent : public IncidentSourceCurrent, public SourceFunc {
  * value of the **electric field**. `SourceFunc` must expose a method
  * `getEField` to obtain this field and a method `initSourceFunc` to initialise
  * the source function.
+ *
+ * `SourceFunc` can optionally expose a batched method
+ * `getEFieldRow(const Index &start, int axis, int count, double time, double *ex, double *ey, double *ez)`
+ * that fills the field components of `count` grid points, starting at `start`
+ * and running along `axis`. If this method exists, the current sheet is filled
+ * row by row. Otherwise `getEField` is called for each grid point.
  */
 template<class SourceFunc>
 class IncidentSourceHCurrent : public IncidentSourceCurrent, public SourceFunc {
@@ -202,6 +256,21 @@ class IncidentSourceHCurrent : public IncidentSourceCurrent, public SourceFunc {
 
     void stepSchemeInit(double dt);
     void stepScheme(double dt);
+  private:
+    /**
+     * Fill the current sheet by evaluating the source function at each grid point
+     */
+    void fillSheet(std::false_type, const Index &off, double factor, double Time);
+
+    /**
+     * Fill the current sheet by evaluating the source function row by row
+     */
+    void fillSheet(std::true_type, const Index &off, double factor, double Time);
+
+    /**
+     * The field components of a single row, used by the batched evaluation
+     */
+    std::vector<double> rowBuffer[3];
 };
 
 template<class FieldFunc>
@@ -221,6 +290,23 @@ class GenericIncidentSourceESource : public FieldFunc {
     Vector3d getHField(int i, int j, int k, double time);
 #endif
 
+    /**
+     * Calculate the magnetic field for `count` grid points starting at `start` along `axis`
+     *
+     * The field only depends on the phase \f$k\cdot x - \omega t\f$. The field
+     * function is only evaluated for phases that differ from the previous grid
+     * point of the row and from the same grid point of the previous row. For
+     * normal incidence, this means that it is evaluated once per component and
+     * time step.
+     */
+    void getHFieldRow(const Index &start,
+                      int axis,
+                      int count,
+                      double time,
+                      double *hx,
+                      double *hy,
+                      double *hz);
+
   private:
     Vector k;
     Vector3d H;
@@ -228,7 +314,13 @@ class GenericIncidentSourceESource : public FieldFunc {
     double dt;
     double om;
     Vector origin;
-    Vector dx;
+
+    /// The phases of the last row evaluated for each component
+    std::vector<double> linePhase[3];
+
+    /// The field values of the last row evaluated for each component
+    std::vector<double> lineValue[3];
+
     SimulationContext &context;
 };
 
@@ -249,6 +341,19 @@ class GenericIncidentSourceHSource : public FieldFunc {
     Vector3d getEField(int i, int j, int k, double time);
 #endif
 
+    /**
+     * Calculate the electric field for `count` grid points starting at `start` along `axis`
+     *
+     * See GenericIncidentSourceESource::getHFieldRow()
+     */
+    void getEFieldRow(const Index &start,
+                      int axis,
+                      int count,
+                      double time,
+                      double *ex,
+                      double *ey,
+                      double *ez);
+
   private:
     Vector k;
     Vector3d E;
@@ -256,7 +361,13 @@ class GenericIncidentSourceHSource : public FieldFunc {
     double dt;
     double om;
     Vector origin;
-    Vector dx;
+
+    /// The phases of the last row evaluated for each component
+    std::vector<double> linePhase[3];
+
+    /// The field values of the last row evaluated for each component
+    std::vector<double> lineValue[3];
+
     SimulationContext &context;
 };
 
@@ -9,7 +9,66 @@
 #include "../../maths/vector/vector.hpp"
 #include "../../constants.hpp"
 
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace huerto_detail {
+
+  // Templates checking for the existence of the batched field evaluation on the
+  // source function, see knp_scheme_has_flux_record in knp_scheme.t
+  template<typename, typename T>
+  struct incsource_has_h_field_row {
+    static_assert(
+      std::integral_constant<T, false>::value,
+      "Second template parameter needs to be of function type.");
+  };
+
+  template<typename C, typename Ret, typename... Args>
+  struct incsource_has_h_field_row<C, Ret(Args...)> {
+    private:
+      template<typename T>
+      static constexpr auto check(T*)
+        -> typename std::is_same<
+            decltype( std::declval<T>().getHFieldRow( std::declval<Args>()... ) ),
+            Ret
+        >::type;
+
+      template<typename>
+      static constexpr std::false_type check(...);
+
+    public:
+      typedef decltype(check<C>(0)) type;
+      static constexpr bool value = type::value;
+  };
+
+  template<typename, typename T>
+  struct incsource_has_e_field_row {
+    static_assert(
+      std::integral_constant<T, false>::value,
+      "Second template parameter needs to be of function type.");
+  };
+
+  template<typename C, typename Ret, typename... Args>
+  struct incsource_has_e_field_row<C, Ret(Args...)> {
+    private:
+      template<typename T>
+      static constexpr auto check(T*)
+        -> typename std::is_same<
+            decltype( std::declval<T>().getEFieldRow( std::declval<Args>()... ) ),
+            Ret
+        >::type;
+
+      template<typename>
+      static constexpr std::false_type check(...);
+
+    public:
+      typedef decltype(check<C>(0)) type;
+      static constexpr bool value = type::value;
+  };
+
+}
 
 //===============================================================
 //==========  IncidentSourceECurrent
@@ -29,24 +88,13 @@ void IncidentSourceECurrent<SourceFunc>::init() {
     return;
   }
 
-  Jx.resize(blow, bhigh);
-  Jy.resize(blow, bhigh);
-  Jz.resize(blow, bhigh);
-
-  Jx = 0.0;
-  Jy = 0.0;
-  Jz = 0.0;
-
-  Grid allJ[3];
-  allJ[0] = Jx;
-  allJ[1] = Jy;
-  allJ[2] = Jz;
+  // The currents are divided by the width of the grid cell they are applied to
+  dN = dx[IncidentSourceCurrent::dim]*context.getGrading(IncidentSourceCurrent::dim, blow[IncidentSourceCurrent::dim], false);
 
-  JT[0] = allJ[IncidentSourceCurrent::transverse1];
-  JT[1] = allJ[IncidentSourceCurrent::transverse2];
+  // Only the part of the sheet inside the local domain is allocated
+  if (!initSheet(blow, bhigh)) return;
 
-  if ((Jx.getSize() > 0) && (Jy.getSize() > 0) && (Jz.getSize() > 0))
-     this->initSourceFunc(Jx, Jy, Jz);
+  this->initSourceFunc(localJ[0], localJ[1], localJ[2]);
 }
 
 template<class SourceFunc>
@@ -58,30 +106,40 @@ void IncidentSourceECurrent<SourceFunc>::stepSchemeInit(double dt)
 template<class SourceFunc>
 void IncidentSourceECurrent<SourceFunc>::stepScheme(double /* dt */)
 {
-  Grid &J0 = JT[0];
-  Grid &J1 = JT[1];
-
-  Index low  = J0.getLo();
-  Index high = J0.getHi();
-
-  Index ind, indn;
+  if (!active) return;
 
   double Time = context.getTime();
   this->setTime(Time);
 
-#ifdef HUERTO_ONE_DIM
-  int off[1] = {0};
-#endif
-#ifdef HUERTO_TWO_DIM
-  int off[2] = {0, 0};
-#endif
-#ifdef HUERTO_THREE_DIM
-  int off[3] = {0, 0, 0};
-#endif
+  Index off;
+  for (size_t d=0; d<DIMENSION; ++d) off[d] = 0;
 
   off[IncidentSourceCurrent::dim] = reverse?0:-1;
   double factor = reverse?1:-1;
 
+  // The source functions are evaluated in the frame of the initial window
+  const Index &shift = context.getWindowShift();
+  for (size_t d=0; d<DIMENSION; ++d) off[d] += shift[d];
+
+  typedef typename huerto_detail::incsource_has_h_field_row<
+      SourceFunc,
+      void(Index, int, int, double, double*, double*, double*)
+  >::type field_row;
+
+  fillSheet(field_row(), off, factor, Time);
+}
+
+template<class SourceFunc>
+void IncidentSourceECurrent<SourceFunc>::fillSheet(std::false_type, const Index &off, double factor, double Time)
+{
+  Grid &J0 = JT[0];
+  Grid &J1 = JT[1];
+
+  Index low  = J0.getLo();
+  Index high = J0.getHi();
+
+  Index ind;
+
 #ifdef HUERTO_ONE_DIM
   for (ind[0]=low[0]; ind[0]<=high[0]; ++ind[0])
   {
@@ -125,6 +183,47 @@ void IncidentSourceECurrent<SourceFunc>::stepScheme(double /* dt */)
 #endif
 }
 
+template<class SourceFunc>
+void IncidentSourceECurrent<SourceFunc>::fillSheet(std::true_type, const Index &off, double factor, double Time)
+{
+  Grid &J0 = JT[0];
+  Grid &J1 = JT[1];
+
+  // The rows run along the last axis that lies in the injection plane
+#ifdef HUERTO_ONE_DIM
+  int axis = 0;
+#else
+  int axis = (IncidentSourceCurrent::dim == DIMENSION-1) ? DIMENSION-2 : DIMENSION-1;
+#endif
+
+  Index low  = J0.getLo();
+  Index high = J0.getHi();
+
+  int count = high[axis] - low[axis] + 1;
+  if (count <= 0) return;
+
+  for (int c=0; c<3; ++c) rowBuffer[c].resize(count);
+
+  Index rowHigh = high;
+  rowHigh[axis] = low[axis];
+
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{low, rowHigh}, [&](const Index &row) {
+    Index start;
+    for (size_t d=0; d<DIMENSION; ++d) start[d] = row[d] + off[d];
+
+    this->getHFieldRow(start, axis, count, Time, rowBuffer[0].data(), rowBuffer[1].data(), rowBuffer[2].data());
+
+    const double *h1 = rowBuffer[IncidentSourceCurrent::transverse1].data();
+    const double *h2 = rowBuffer[IncidentSourceCurrent::transverse2].data();
+
+    Index ind = row;
+    for (int n=0; n<count; ++n, ++ind[axis]) {
+      J0[ind] = -factor*h2[n]/dN;
+      J1[ind] = factor*h1[n]/dN;
+    }
+  });
+}
+
 
 //===============================================================
 //==========  IncidentSourceHCurrent
@@ -143,23 +242,13 @@ void IncidentSourceHCurrent<SourceFunc>::init()
 
   if (!getBorderExtent(IncidentSourceCurrent::dir, 1, distance, blow, bhigh, true, context)) return;
 
-  Jx.resize(blow, bhigh);
-  Jy.resize(blow, bhigh);
-  Jz.resize(blow, bhigh);
-
-  Jx = 0.0;
-  Jy = 0.0;
-  Jz = 0.0;
-
-  Grid allJ[3];
-  allJ[0] = Jx;
-  allJ[1] = Jy;
-  allJ[2] = Jz;
+  // The currents are divided by the width of the grid cell they are applied to
+  dN = dx[IncidentSourceCurrent::dim]*context.getGrading(IncidentSourceCurrent::dim, blow[IncidentSourceCurrent::dim], true);
 
-  JT[0] = allJ[IncidentSourceCurrent::transverse1];
-  JT[1] = allJ[IncidentSourceCurrent::transverse2];
+  // Only the part of the sheet inside the local domain is allocated
+  if (!initSheet(blow, bhigh)) return;
 
-  this->initSourceFunc(Jx, Jy, Jz);
+  this->initSourceFunc(localJ[0], localJ[1], localJ[2]);
 }
 
 template<class SourceFunc>
@@ -171,30 +260,40 @@ void IncidentSourceHCurrent<SourceFunc>::stepSchemeInit(double dt)
 template<class SourceFunc>
 void IncidentSourceHCurrent<SourceFunc>::stepScheme(double /* dt */)
 {
-  Grid &J0 = JT[0];
-  Grid &J1 = JT[1];
-
-  Index low  = J0.getLo();
-  Index high = J0.getHi();
-
-  Index ind, indn;
+  if (!active) return;
 
   double Time = context.getTime();
   this->setTime(Time);
 
-#ifdef HUERTO_ONE_DIM
-  int off[1] = {0};
-#endif
-#ifdef HUERTO_TWO_DIM
-  int off[2] = {0, 0};
-#endif
-#ifdef HUERTO_THREE_DIM
-  int off[3] = {0, 0, 0};
-#endif
+  Index off;
+  for (size_t d=0; d<DIMENSION; ++d) off[d] = 0;
 
   off[IncidentSourceCurrent::dim] = reverse?0:1;
   double factor = reverse?1:-1;
 
+  // The source functions are evaluated in the frame of the initial window
+  const Index &shift = context.getWindowShift();
+  for (size_t d=0; d<DIMENSION; ++d) off[d] += shift[d];
+
+  typedef typename huerto_detail::incsource_has_e_field_row<
+      SourceFunc,
+      void(Index, int, int, double, double*, double*, double*)
+  >::type field_row;
+
+  fillSheet(field_row(), off, factor, Time);
+}
+
+template<class SourceFunc>
+void IncidentSourceHCurrent<SourceFunc>::fillSheet(std::false_type, const Index &off, double factor, double Time)
+{
+  Grid &J0 = JT[0];
+  Grid &J1 = JT[1];
+
+  Index low  = J0.getLo();
+  Index high = J0.getHi();
+
+  Index ind;
+
 #ifdef HUERTO_ONE_DIM
   for (ind[0]=low[0]; ind[0]<=high[0]; ++ind[0])
   {
@@ -238,6 +337,47 @@ void IncidentSourceHCurrent<SourceFunc>::stepScheme(double /* dt */)
 #endif
 }
 
+template<class SourceFunc>
+void IncidentSourceHCurrent<SourceFunc>::fillSheet(std::true_type, const Index &off, double factor, double Time)
+{
+  Grid &J0 = JT[0];
+  Grid &J1 = JT[1];
+
+  // The rows run along the last axis that lies in the injection plane
+#ifdef HUERTO_ONE_DIM
+  int axis = 0;
+#else
+  int axis = (IncidentSourceCurrent::dim == DIMENSION-1) ? DIMENSION-2 : DIMENSION-1;
+#endif
+
+  Index low  = J0.getLo();
+  Index high = J0.getHi();
+
+  int count = high[axis] - low[axis] + 1;
+  if (count <= 0) return;
+
+  for (int c=0; c<3; ++c) rowBuffer[c].resize(count);
+
+  Index rowHigh = high;
+  rowHigh[axis] = low[axis];
+
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{low, rowHigh}, [&](const Index &row) {
+    Index start;
+    for (size_t d=0; d<DIMENSION; ++d) start[d] = row[d] + off[d];
+
+    this->getEFieldRow(start, axis, count, Time, rowBuffer[0].data(), rowBuffer[1].data(), rowBuffer[2].data());
+
+    const double *e1 = rowBuffer[IncidentSourceCurrent::transverse1].data();
+    const double *e2 = rowBuffer[IncidentSourceCurrent::transverse2].data();
+
+    Index ind = row;
+    for (int n=0; n<count; ++n, ++ind[axis]) {
+      J0[ind] = -factor*e2[n]/dN;
+      J1[ind] = factor*e1[n]/dN;
+    }
+  });
+}
+
 //===============================================================
 //==========  GenericIncidentSourceESource
 //===============================================================
@@ -260,7 +400,6 @@ void GenericIncidentSourceESource<FieldFunc>::setGenericParam(
   dt = context.getDt();
   om = clight*norm(k)/sqrt(eps);
 
-  dx = context.getDx();
 }
 
 #ifdef HUERTO_ONE_DIM
@@ -269,11 +408,12 @@ Vector3d GenericIncidentSourceESource<FieldFunc>::getHField(int i, double time)
 {
   double realtime = time - 0.5*dt;
 
-  double x = i*dx[0] - origin[0];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
 
   double posx = k[0]*x - om*realtime;
-  double posy = k[0]*(x+0.5*dx[0]) - om*realtime;
-  double posz = k[0]*(x+0.5*dx[0]) - om*realtime;
+  double posy = k[0]*xh - om*realtime;
+  double posz = k[0]*xh - om*realtime;
 
   double hx = this->fieldFunc(posx, H[0]);
   double hy = this->fieldFunc(posy, H[1]);
@@ -288,12 +428,14 @@ template<class FieldFunc>
 Vector3d GenericIncidentSourceESource<FieldFunc>::getHField(int i, int j, double time) {
   double realtime = time - 0.5*dt;
 
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
 
-  double posx = k[0]*x + k[1]*(y+0.5*dx[1]) - om*realtime;
-  double posy = k[0]*(x+0.5*dx[0]) + k[1]*y - om*realtime;
-  double posz = k[0]*(x+0.5*dx[0]) + k[1]*(y+0.5*dx[1]) - om*realtime;
+  double posx = k[0]*x + k[1]*yh - om*realtime;
+  double posy = k[0]*xh + k[1]*y - om*realtime;
+  double posz = k[0]*xh + k[1]*yh - om*realtime;
 
   double hx = this->fieldFunc(posx, H[0]);
   double hy = this->fieldFunc(posy, H[1]);
@@ -309,13 +451,16 @@ Vector3d GenericIncidentSourceESource<FieldFunc>::getHField(int i, int j, int l,
 {
   double realtime = time - 0.5*dt;
 
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
-  double z = l*dx[2] - origin[2];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+  double z = context.getPosition(2, l) - origin[2];
+  double zh = context.getPosition(2, l + 0.5) - origin[2];
 
-  double posx = k[0]*x + k[1]*(y+0.5*dx[1]) + k[2]*(z+0.5*dx[2]) - om*realtime;
-  double posy = k[0]*(x+0.5*dx[0]) + k[1]*y + k[2]*(z+0.5*dx[2]) - om*realtime;
-  double posz = k[0]*(x+0.5*dx[0]) + k[1]*(y+0.5*dx[1]) + k[2]*z - om*realtime;
+  double posx = k[0]*x + k[1]*yh + k[2]*zh - om*realtime;
+  double posy = k[0]*xh + k[1]*y + k[2]*zh - om*realtime;
+  double posz = k[0]*xh + k[1]*yh + k[2]*z - om*realtime;
 
   double hx = this->fieldFunc(posx, H[0]);
   double hy = this->fieldFunc(posy, H[1]);
@@ -325,6 +470,53 @@ Vector3d GenericIncidentSourceESource<FieldFunc>::getHField(int i, int j, int l,
 }
 #endif
 
+template<class FieldFunc>
+void GenericIncidentSourceESource<FieldFunc>::getHFieldRow(const Index &start,
+                                                           int axis,
+                                                           int count,
+                                                           double time,
+                                                           double *hx,
+                                                           double *hy,
+                                                           double *hz)
+{
+  double realtime = time - 0.5*dt;
+  double *h[3] = {hx, hy, hz};
+
+  for (int c=0; c<3; ++c) {
+    std::vector<double> &phase = linePhase[c];
+    std::vector<double> &value = lineValue[c];
+    if (int(phase.size()) != count) {
+      phase.assign(count, std::numeric_limits<double>::quiet_NaN());
+      value.assign(count, 0.0);
+    }
+
+    // The positions of the staggered grid points relative to the origin
+    Vector x;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      double shift = (int(d) == c) ? 0.0 : 0.5;
+      x[d] = context.getPosition(d, start[d] + shift) - origin[d];
+    }
+    double shift = (axis == c) ? 0.0 : 0.5;
+
+    double *out = h[c];
+    for (int n=0; n<count; ++n) {
+      x[axis] = context.getPosition(axis, start[axis] + n + shift) - origin[axis];
+
+      // The terms are added in the same order as in getHField(), so that both
+      // give the same phase
+      double pos = 0.0;
+      for (size_t d=0; d<DIMENSION; ++d) pos += k[d]*x[d];
+      pos -= om*realtime;
+
+      if (pos != phase[n]) {
+        phase[n] = pos;
+        value[n] = (n > 0 && pos == phase[n-1]) ? value[n-1] : this->fieldFunc(pos, H[c]);
+      }
+      out[n] = value[n];
+    }
+  }
+}
+
 
 //===============================================================
 //==========  GenericIncidentSourceHSource
@@ -349,7 +541,6 @@ void GenericIncidentSourceHSource<FieldFunc>::setGenericParam(
   dt = context.getDt();
   om = clight*norm(k)/sqrt(eps);
 
-  dx = context.getDx();
 }
 
 
@@ -359,9 +550,10 @@ Vector3d GenericIncidentSourceHSource<FieldFunc>::getEField(int i, double time)
 {
   double realtime = time;
 
-  double x = i*dx[0] - origin[0];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
 
-  double posx = k[0]*(x+0.5*dx[0]) - om*realtime;
+  double posx = k[0]*xh - om*realtime;
   double posy = k[0]*x - om*realtime;
   double posz = k[0]*x - om*realtime;
 
@@ -378,11 +570,13 @@ template<class FieldFunc>
 Vector3d GenericIncidentSourceHSource<FieldFunc>::getEField(int i, int j, double time) {
   double realtime = time;
 
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
 
-  double posx = k[0]*(x+0.5*dx[0]) + k[1]*y - om*realtime;
-  double posy = k[0]*x + k[1]*(y+0.5*dx[1]) - om*realtime;
+  double posx = k[0]*xh + k[1]*y - om*realtime;
+  double posy = k[0]*x + k[1]*yh - om*realtime;
   double posz = k[0]*x + k[1]*y - om*realtime;
 
   double ex = this->fieldFunc(posx, E[0]);
@@ -398,13 +592,16 @@ template<class FieldFunc>
 Vector3d GenericIncidentSourceHSource<FieldFunc>::getEField(int i, int j, int l, double time) {
   double realtime = time;
 
-  double x = i*dx[0] - origin[0];
-  double y = j*dx[1] - origin[1];
-  double z = l*dx[2] - origin[2];
+  double x = context.getPosition(0, i) - origin[0];
+  double xh = context.getPosition(0, i + 0.5) - origin[0];
+  double y = context.getPosition(1, j) - origin[1];
+  double yh = context.getPosition(1, j + 0.5) - origin[1];
+  double z = context.getPosition(2, l) - origin[2];
+  double zh = context.getPosition(2, l + 0.5) - origin[2];
 
-  double posx = k[0]*(x+0.5*dx[0]) + k[1]*y + k[2]*z - om*realtime;
-  double posy = k[0]*x + k[1]*(y+0.5*dx[1]) + k[2]*z - om*realtime;
-  double posz = k[0]*x + k[1]*y + k[2]*(z+0.5*dx[2]) - om*realtime;
+  double posx = k[0]*xh + k[1]*y + k[2]*z - om*realtime;
+  double posy = k[0]*x + k[1]*yh + k[2]*z - om*realtime;
+  double posz = k[0]*x + k[1]*y + k[2]*zh - om*realtime;
 
   double ex = this->fieldFunc(posx, E[0]);
   double ey = this->fieldFunc(posy, E[1]);
@@ -413,3 +610,50 @@ Vector3d GenericIncidentSourceHSource<FieldFunc>::getEField(int i, int j, int l,
   return Vector3d(ex, ey, ez);
 }
 #endif
+
+template<class FieldFunc>
+void GenericIncidentSourceHSource<FieldFunc>::getEFieldRow(const Index &start,
+                                                           int axis,
+                                                           int count,
+                                                           double time,
+                                                           double *ex,
+                                                           double *ey,
+                                                           double *ez)
+{
+  double realtime = time;
+  double *e[3] = {ex, ey, ez};
+
+  for (int c=0; c<3; ++c) {
+    std::vector<double> &phase = linePhase[c];
+    std::vector<double> &value = lineValue[c];
+    if (int(phase.size()) != count) {
+      phase.assign(count, std::numeric_limits<double>::quiet_NaN());
+      value.assign(count, 0.0);
+    }
+
+    // The positions of the staggered grid points relative to the origin
+    Vector x;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      double shift = (int(d) == c) ? 0.5 : 0.0;
+      x[d] = context.getPosition(d, start[d] + shift) - origin[d];
+    }
+    double shift = (axis == c) ? 0.5 : 0.0;
+
+    double *out = e[c];
+    for (int n=0; n<count; ++n) {
+      x[axis] = context.getPosition(axis, start[axis] + n + shift) - origin[axis];
+
+      // The terms are added in the same order as in getEField(), so that both
+      // give the same phase
+      double pos = 0.0;
+      for (size_t d=0; d<DIMENSION; ++d) pos += k[d]*x[d];
+      pos -= om*realtime;
+
+      if (pos != phase[n]) {
+        phase[n] = pos;
+        value[n] = (n > 0 && pos == phase[n-1]) ? value[n-1] : this->fieldFunc(pos, E[c]);
+      }
+      out[n] = value[n];
+    }
+  }
+}
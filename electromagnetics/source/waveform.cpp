@@ -0,0 +1,280 @@
+/*
+ * waveform.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "waveform.hpp"
+
+#include "../../constants.hpp"
+#include "../../maths/vector/vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+//===============================================================
+//==========  Waveform Source
+//===============================================================
+
+bool WaveformSource::needCurrent(Direction dir)
+{
+  int dim = static_cast<int>(dir)/2;
+  bool pos = (static_cast<int>(dir) % 2) == 1;
+  return pos ? k[dim] <= 0.0 : k[dim] >= 0.0;
+}
+
+pCurrent WaveformSource::makeECurrent(int distance, Direction dir)
+{
+  WaveformParameters param{k, origin, eps, file, columns, interval, start, dr, window};
+
+  typedef IncidentSourceECurrent<WaveformSourceEFunc> CurrentType;
+  CurrentType *cur = new CurrentType(distance, dir, getContext());
+  cur->setParam(param, H / mu_0, false);
+  return pCurrent(cur);
+}
+
+pCurrent WaveformSource::makeHCurrent(int distance, Direction dir)
+{
+  Vector3d k3(0.0, 0.0, 0.0);
+  for (size_t d=0; d<DIMENSION; ++d) k3[d] = k[d];
+
+  Vector3d E = cross(k3, H);
+
+  double bmag = norm(H);
+  double factor = -clight*bmag/norm(E);
+
+  E *= factor/sqrt(eps);
+
+  WaveformParameters param{k, origin, eps, file, columns, interval, start, dr, window};
+
+  typedef IncidentSourceHCurrent<WaveformSourceHFunc> CurrentType;
+  CurrentType *cur = new CurrentType(distance, dir, getContext());
+  cur->setParam(param, E, true);
+  return pCurrent(cur);
+}
+
+void WaveformSource::initParameters(schnek::BlockParameters &blockPars)
+{
+  IncidentSource::initParameters(blockPars);
+
+  blockPars.addArrayParameter("k", this->k, 0.0);
+  blockPars.addArrayParameter("origin", this->origin, 0.0);
+
+  blockPars.addArrayParameter("H", this->H, 0.0);
+
+  blockPars.addParameter("eps", &this->eps, 1.0);
+  blockPars.addParameter("file", &this->file);
+  blockPars.addParameter("columns", &this->columns, 1);
+  blockPars.addParameter("interval", &this->interval, 1e-16);
+  blockPars.addParameter("start", &this->start, 0.0);
+  blockPars.addParameter("dr", &this->dr, 1e-6);
+  blockPars.addParameter("window", &this->window, 4096);
+}
+
+//===============================================================
+//==========  WaveformSourceFunc
+//===============================================================
+
+WaveformSourceFunc::WaveformSourceFunc(Direction /* dir */, SimulationContext &context)
+  : dt(0), electric(false), speed(clight), axisMin(0), axisMax(0), context(context)
+{}
+
+void WaveformSourceFunc::setParam(const WaveformParameters &param, Vector3d F, bool electric)
+{
+  if (norm(param.k) == 0.0) {
+    throw std::runtime_error("WaveformSource: the direction of propagation k must not vanish");
+  }
+  if (param.columns < 1 || param.window < 2) {
+    throw std::runtime_error("WaveformSource: columns must be positive and window must be at least 2");
+  }
+  if (param.interval <= 0.0 || (param.columns > 1 && param.dr <= 0.0)) {
+    throw std::runtime_error("WaveformSource: the sample spacings interval and dr must be positive");
+  }
+
+  this->param = param;
+  this->F = F;
+  this->electric = electric;
+
+  axis = param.k / norm(param.k);
+  speed = clight/sqrt(param.eps);
+  dt = context.getDt();
+}
+
+void WaveformSourceFunc::initSourceFunc(Grid &Jx, Grid & /* Jy */, Grid & /* Jz */)
+{
+  stream.reset(new WaveformStream());
+  stream->open(param.file, param.columns, param.window);
+  if (stream->getRecords() == 0) {
+    throw std::runtime_error("WaveformSource: the file '" + param.file + "' does not contain any records");
+  }
+
+  sheetLo = Jx.getLo();
+  sheetHi = Jx.getHi();
+  findAxisRange();
+}
+
+void WaveformSourceFunc::findAxisRange()
+{
+  // The distance along the axis is linear in the position, so its extremes
+  // lie on the corners of the sheet. The staggered positions lie within one
+  // grid cell of the sheet. The fields are evaluated in the frame of the
+  // initial window, so the corners move with the window.
+  const Index &shift = context.getWindowShift();
+  axisMin = std::numeric_limits<double>::max();
+  axisMax = -std::numeric_limits<double>::max();
+  for (int corner=0; corner < (1 << DIMENSION); ++corner) {
+    double s = 0.0;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      double index = (corner & (1 << d)) ? sheetHi[d] + shift[d] + 1.5 : sheetLo[d] + shift[d] - 1.0;
+      s += axis[d]*(context.getPosition(d, index) - param.origin[d]);
+    }
+    axisMin = std::min(axisMin, s);
+    axisMax = std::max(axisMax, s);
+  }
+}
+
+size_t WaveformSourceFunc::getRecordIndex(double time)
+{
+  double u = (time - param.start)/param.interval;
+  double last = double(stream->getRecords() - 1);
+  return size_t(std::floor(std::min(std::max(u, 0.0), last)));
+}
+
+void WaveformSourceFunc::setTime(double time)
+{
+  if (!stream) return;
+
+  findAxisRange();
+
+  // The range of retarded times on the local sheet, including the half time
+  // step by which the magnetic field lags behind
+  size_t first = getRecordIndex(time - 0.5*dt - axisMax/speed);
+  size_t last = getRecordIndex(time - axisMin/speed);
+  stream->require(first, std::min(last + 1, stream->getRecords() - 1));
+}
+
+double WaveformSourceFunc::getWaveform(double time, double r)
+{
+  size_t records = stream->getRecords();
+  double u = (time - param.start)/param.interval;
+  if (u < 0.0 || u > double(records - 1)) return 0.0;
+
+  size_t n = size_t(u);
+  size_t m = std::min(n + 1, records - 1);
+  double w = u - n;
+
+  size_t col = 0;
+  size_t colNext = 0;
+  double wr = 0.0;
+  if (param.columns > 1) {
+    double v = r/param.dr;
+    if (v > param.columns - 1) return 0.0;
+    col = size_t(v);
+    colNext = std::min(col + 1, size_t(param.columns - 1));
+    wr = v - col;
+  }
+
+  // Only moves the window if the time lies outside the range set in setTime
+  stream->require(n, m);
+  const double *a = stream->getRecord(n);
+  const double *b = stream->getRecord(m);
+
+  double va = (1.0 - wr)*a[col] + wr*a[colNext];
+  double vb = (1.0 - wr)*b[col] + wr*b[colNext];
+  return (1.0 - w)*va + w*vb;
+}
+
+Vector3d WaveformSourceFunc::getField(const Index &pos, double time)
+{
+  Vector3d f(0.0, 0.0, 0.0);
+  for (int c=0; c<3; ++c) {
+    if (F[c] == 0.0) continue;
+
+    // The electric field is staggered along its own component, the magnetic
+    // field along the other axes
+    double s = 0.0;
+    double x2 = 0.0;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      double shift = ((int(d) == c) == electric) ? 0.5 : 0.0;
+      double x = context.getPosition(d, pos[d] + shift) - param.origin[d];
+      s += axis[d]*x;
+      x2 += x*x;
+    }
+    double r = sqrt(std::max(x2 - s*s, 0.0));
+
+    f[c] = F[c]*getWaveform(time - s/speed, r);
+  }
+
+  return f;
+}
+
+//===============================================================
+//==========  WaveformSourceEFunc
+//===============================================================
+
+#ifdef HUERTO_ONE_DIM
+Vector3d WaveformSourceEFunc::getHField(int i, double time)
+{
+  Index pos;
+  pos[0] = i;
+  return getField(pos, time - 0.5*dt);
+}
+#endif
+
+#ifdef HUERTO_TWO_DIM
+Vector3d WaveformSourceEFunc::getHField(int i, int j, double time)
+{
+  Index pos;
+  pos[0] = i;
+  pos[1] = j;
+  return getField(pos, time - 0.5*dt);
+}
+#endif
+
+#ifdef HUERTO_THREE_DIM
+Vector3d WaveformSourceEFunc::getHField(int i, int j, int l, double time)
+{
+  Index pos;
+  pos[0] = i;
+  pos[1] = j;
+  pos[2] = l;
+  return getField(pos, time - 0.5*dt);
+}
+#endif
+
+//===============================================================
+//==========  WaveformSourceHFunc
+//===============================================================
+
+#ifdef HUERTO_ONE_DIM
+Vector3d WaveformSourceHFunc::getEField(int i, double time)
+{
+  Index pos;
+  pos[0] = i;
+  return getField(pos, time);
+}
+#endif
+
+#ifdef HUERTO_TWO_DIM
+Vector3d WaveformSourceHFunc::getEField(int i, int j, double time)
+{
+  Index pos;
+  pos[0] = i;
+  pos[1] = j;
+  return getField(pos, time);
+}
+#endif
+
+#ifdef HUERTO_THREE_DIM
+Vector3d WaveformSourceHFunc::getEField(int i, int j, int l, double time)
+{
+  Index pos;
+  pos[0] = i;
+  pos[1] = j;
+  pos[2] = l;
+  return getField(pos, time);
+}
+#endif
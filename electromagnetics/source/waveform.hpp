@@ -0,0 +1,223 @@
+/*
+ * waveform.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_EM_SOURCE_WAVEFORM_HPP_
+#define HUERTO_EM_SOURCE_WAVEFORM_HPP_
+
+#include "incsource.hpp"
+
+#include "../../io/waveform_stream.hpp"
+
+#include <memory>
+#include <string>
+
+//===============================================================
+//==========  Waveform Source
+//===============================================================
+
+/**
+ * A source that injects a sampled waveform read from a binary file
+ *
+ * The file holds one record per time sample. The samples are spaced by
+ * `interval` seconds and the first sample is taken at the time `start`. Each
+ * record contains `columns` doubles in the native byte order. With a single
+ * column, the file is a time series and the source injects a plane wave. With
+ * more columns, the values are samples of the transverse profile at the
+ * distances `0, dr, 2*dr, ...` from the axis through `origin` along `k`.
+ *
+ * The field at a grid point is `H` times the waveform at the retarded time
+ * \f$t - \hat{k}\cdot(x - x_0)/v\f$, where \f$v\f$ is the speed of light in
+ * the medium. The waveform is interpolated linearly in time and transverse
+ * distance and vanishes outside the sampled range.
+ *
+ * The file is memory mapped and only a window of `window` records around the
+ * current simulation time is kept in memory. Only the processes whose local
+ * domain touches the injection plane open the file.
+ */
+class WaveformSource : public IncidentSource
+{
+  public:
+    ~WaveformSource() {}
+  protected:
+    pCurrent makeECurrent(int distance, Direction dir) override;
+    pCurrent makeHCurrent(int distance, Direction dir) override;
+    bool needCurrent(Direction dir) override;
+
+    void initParameters(schnek::BlockParameters &blockPars) override;
+
+    /// The direction of propagation; only the direction of the vector is used
+    Vector k;
+
+    /// The point on the axis at which the waveform is given in m
+    Vector origin;
+
+    /// The magnetic field amplitude in physical units [Tesla]
+    Vector3d H;
+
+    /// The relative permittivity (defaults to 1)
+    double eps;
+
+    /// The name of the waveform file
+    std::string file;
+
+    /// The number of values in each record of the file
+    int columns;
+
+    /// The time between two samples in s
+    double interval;
+
+    /// The time of the first sample in s
+    double start;
+
+    /// The distance between two transverse samples in m
+    double dr;
+
+    /// The number of records kept in memory
+    int window;
+};
+
+/**
+ * The parameters of a WaveformSource passed to the source functions
+ */
+struct WaveformParameters
+{
+    Vector k;
+    Vector origin;
+    double eps;
+    std::string file;
+    int columns;
+    double interval;
+    double start;
+    double dr;
+    int window;
+};
+
+/**
+ * Common base of the source functions of the WaveformSource
+ */
+class WaveformSourceFunc
+{
+  public:
+    WaveformSourceFunc(Direction dir, SimulationContext &context);
+
+    /**
+     * Set the parameters and the field amplitude
+     *
+     * @param electric  true if the source function provides the electric field
+     */
+    void setParam(const WaveformParameters &param, Vector3d F, bool electric);
+
+    /**
+     * Open the waveform file and find the range of distances along the axis
+     * covered by the local part of the current sheet
+     */
+    void initSourceFunc(Grid &Jx, Grid &Jy, Grid &Jz);
+
+    /**
+     * Move the window of the waveform file to the given time
+     *
+     * The range of retarded times on the local sheet is recalculated, because
+     * it changes when the simulation window moves.
+     */
+    void setTime(double time);
+
+  protected:
+    /**
+     * The field at a grid point at the given time
+     */
+    Vector3d getField(const Index &pos, double time);
+
+    /// The simulation time step in s
+    double dt;
+
+  private:
+    /**
+     * The waveform at a retarded time and transverse distance, interpolated linearly
+     */
+    double getWaveform(double time, double r);
+
+    /**
+     * Calculate #axisMin and #axisMax for the current position of the window
+     */
+    void findAxisRange();
+
+    /**
+     * The index of the record at or before the given time, clamped to the file
+     */
+    size_t getRecordIndex(double time);
+
+    WaveformParameters param;
+
+    /// The unit vector along the direction of propagation
+    Vector axis;
+
+    /// The field amplitude, normalised like the other incident sources
+    Vector3d F;
+
+    /// True if #F is the electric field
+    bool electric;
+
+    /// The speed of light in the medium in m/s
+    double speed;
+
+    /// The lowest and highest grid index of the local sheet
+    Index sheetLo, sheetHi;
+
+    /// The smallest and largest distance along the axis on the local sheet in m
+    double axisMin, axisMax;
+
+    /// The waveform file, opened if the local sheet is not empty
+    std::unique_ptr<WaveformStream> stream;
+
+    SimulationContext &context;
+};
+
+/**
+ * The source function of the electric currents of the WaveformSource
+ */
+class WaveformSourceEFunc : public WaveformSourceFunc
+{
+  public:
+    WaveformSourceEFunc(Direction dir, SimulationContext &context)
+      : WaveformSourceFunc(dir, context) {}
+
+#ifdef HUERTO_ONE_DIM
+    Vector3d getHField(int i, double time);
+#endif
+
+#ifdef HUERTO_TWO_DIM
+    Vector3d getHField(int i, int j, double time);
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    Vector3d getHField(int i, int j, int k, double time);
+#endif
+};
+
+/**
+ * The source function of the magnetic currents of the WaveformSource
+ */
+class WaveformSourceHFunc : public WaveformSourceFunc
+{
+  public:
+    WaveformSourceHFunc(Direction dir, SimulationContext &context)
+      : WaveformSourceFunc(dir, context) {}
+
+#ifdef HUERTO_ONE_DIM
+    Vector3d getEField(int i, double time);
+#endif
+
+#ifdef HUERTO_TWO_DIM
+    Vector3d getEField(int i, int j, double time);
+#endif
+
+#ifdef HUERTO_THREE_DIM
+    Vector3d getEField(int i, int j, int k, double time);
+#endif
+};
+
+#endif /* HUERTO_EM_SOURCE_WAVEFORM_HPP_ */
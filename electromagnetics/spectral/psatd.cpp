@@ -0,0 +1,372 @@
+/*
+ * psatd.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "psatd.hpp"
+
+#include "../pml/cpml_border.hpp"
+#include "../../constants.hpp"
+
+#include <schnek/grid.hpp>
+#include <schnek/tools/literature.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const Stagger eStagger[3] = {exStaggerYee, eyStaggerYee, ezStaggerYee};
+const Stagger bStagger[3] = {bxStaggerYee, byStaggerYee, bzStaggerYee};
+
+/**
+ * The coefficients \f$c_m\f$ of the staggered first derivative of order `order`
+ *
+ * See Vincenti and Vay (2016), Eq. (8).
+ */
+std::vector<double> stencilCoefficients(int order)
+{
+  int half = order/2;
+  std::vector<double> coeff(half);
+  for (int m=1; m<=half; ++m) {
+    double c = std::pow(16.0, 1 - half)
+             * std::pow(std::tgamma(order), 2)
+             / (double(2*m - 1)*double(2*m - 1)
+                * std::tgamma(half + m)*std::tgamma(half - m + 1)
+                * std::pow(std::tgamma(half), 2));
+    coeff[m-1] = (m % 2 == 1) ? c : -c;
+  }
+  return coeff;
+}
+
+} // namespace
+
+double PSATD::modifiedWaveNumber(int order, double k, double dx)
+{
+  // Together with the half cell shift, this is the spectrum of a stencil
+  // that reaches order/2 cells. The Nyquist mode needs no special treatment.
+  std::vector<double> coeff = stencilCoefficients(order);
+  double kMod = 0.0;
+  for (int m=1; m<=order/2; ++m) {
+    kMod += coeff[m-1]*2.0*std::sin(0.5*(2*m - 1)*k*dx)/dx;
+  }
+  return kMod;
+}
+
+void PSATD::initParameters(schnek::BlockParameters &blockPars)
+{
+  FieldSolver::initParameters(blockPars);
+  blockPars.addParameter("order", &this->order, 8);
+}
+
+void PSATD::init()
+{
+  SimulationEntity::init(this);
+
+  if (getContext().isGraded()) {
+    throw std::runtime_error("PSATD: the spectral solver cannot be used on a graded grid");
+  }
+  if ((order < 2) || (order % 2 != 0)) {
+    throw std::runtime_error("PSATD: the order of the stencil must be a positive even number");
+  }
+  if (getContext().getGhostCells() < order/2) {
+    throw std::runtime_error("PSATD: the spectral solver needs at least order/2 ghost cells");
+  }
+
+  retrieveData("Ex", Ex);
+  retrieveData("Ey", Ey);
+  retrieveData("Ez", Ez);
+
+  retrieveData("Bx", Bx);
+  retrieveData("By", By);
+  retrieveData("Bz", Bz);
+
+  for (pCurrentBlock current: schnek::BlockContainer<CurrentBlock>::childBlocks())
+  {
+    // The CPML currents need the stretch factors of a finite difference
+    // solver, the spectral curl would reflect the fields instead of absorbing them
+    if (dynamic_cast<CPMLBorder*>(current.get()) != nullptr) {
+      throw std::runtime_error("PSATD: CPMLBorder layers cannot be used with the spectral solver");
+    }
+    current->initCurrents(*this);
+  }
+
+  // The update reads the currents on the whole local grid
+  CurrentContainer::init(getContext(), false);
+
+  dispersionDt = 0.0;
+
+  schnek::LiteratureArticle Vay2013("Vay2013", "Vay, J.-L. and Haber, I. and Godfrey, B. B.",
+      "A domain decomposition method for pseudo-spectral electromagnetic simulations of plasmas",
+      "Journal of Computational Physics", "2013", "243", "260--268");
+
+  schnek::LiteratureArticle Vincenti2016("Vincenti2016", "Vincenti, H. and Vay, J.-L.",
+      "Detailed analysis of the effects of stencil spatial variations with arbitrary high-order "
+      "finite-difference Maxwell solver",
+      "Computer Physics Communications", "2016", "200", "147--167");
+
+  schnek::LiteratureManager::instance().addReference(
+      "Integration of electrodynamic fields uses a pseudo-spectral solver with local transforms.",
+      Vay2013);
+
+  schnek::LiteratureManager::instance().addReference(
+      "The pseudo-spectral solver uses the modified wave numbers of a finite-order stencil.",
+      Vincenti2016);
+}
+
+void PSATD::initSpectral()
+{
+  Field ex;
+  getContext().getDecomposition().getGridContext({Ex, Ey, Ez, Bx, By, Bz}).forEach([&](
+      Range /* range */,
+      Field &fex, Field &fey, Field &fez,
+      Field &fbx, Field &fby, Field &fbz) {
+    for (Field *field: {&fey, &fez, &fbx, &fby, &fbz}) {
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (field->getLo(d) != fex.getLo(d) || field->getHi(d) != fex.getHi(d)) {
+          throw std::runtime_error("PSATD: all field components must have the same extent");
+        }
+      }
+    }
+    ex = fex;
+  });
+
+  Vector dx = getContext().getDx();
+  boxLo = ex.getLo();
+  volume = 1;
+  for (int d=DIMENSION-1; d>=0; --d) {
+    boxSize[d] = ex.getHi(d) - ex.getLo(d) + 1;
+    strides[d] = volume;
+    volume *= boxSize[d];
+  }
+
+  transforms.clear();
+  for (size_t d=0; d<DIMENSION; ++d) {
+    ptrdiff_t n = boxSize[d];
+    transforms.emplace_back(n);
+    ik[d].resize(n);
+    halfShift[d].resize(n);
+    for (ptrdiff_t j=0; j<n; ++j) {
+      double k = 2.0*M_PI*double(j <= n/2 ? j : j - n)/(n*dx[d]);
+      halfShift[d][j] = std::polar(1.0, 0.5*k*dx[d]);
+      ik[d][j] = FFT::Complex(0.0, modifiedWaveNumber(order, k, dx[d]));
+    }
+  }
+
+  k2.resize(volume);
+  Index j;
+  for (size_t d=0; d<DIMENSION; ++d) j[d] = 0;
+  for (size_t idx=0; idx<volume; ++idx) {
+    k2[idx] = 0.0;
+    for (size_t d=0; d<DIMENSION; ++d) k2[idx] += std::norm(ik[d][j[d]]);
+
+    for (int d=DIMENSION-1; d>=0; --d) {
+      if (++j[d] < boxSize[d]) break;
+      j[d] = 0;
+    }
+  }
+
+  for (int c=0; c<3; ++c) {
+    spectrum[c].resize(volume);
+  }
+
+  dispersionDt = 0.0;
+}
+
+void PSATD::initDispersion(double dt)
+{
+  dispersion.resize(volume);
+  for (size_t idx=0; idx<volume; ++idx) {
+    double phase = 0.5*clight*std::sqrt(k2[idx])*dt;
+    dispersion[idx] = (phase > 0.0) ? std::sin(phase)/phase : 1.0;
+  }
+
+  dispersionDt = dt;
+}
+
+size_t PSATD::flatIndex(const Index &pos) const
+{
+  size_t idx = 0;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    idx += (pos[d] - boxLo[d])*strides[d];
+  }
+  return idx;
+}
+
+void PSATD::transform(bool forward)
+{
+  for (size_t d=0; d<DIMENSION; ++d) {
+    FFT &fft = transforms[d];
+    ptrdiff_t n = boxSize[d];
+    ptrdiff_t stride = strides[d];
+    size_t lines = volume/n;
+    for (int c=0; c<3; ++c) {
+      FFT::Complex *data = spectrum[c].data();
+      for (size_t l=0; l<lines; ++l) {
+        size_t outer = l/stride;
+        size_t inner = l%stride;
+        FFT::Complex *line = data + outer*n*stride + inner;
+        if (forward) {
+          fft.forward(line, stride);
+        } else {
+          fft.backward(line, stride);
+        }
+      }
+    }
+  }
+}
+
+void PSATD::spectralCurl(const Stagger *from, const Stagger *to)
+{
+  Index j;
+  for (size_t d=0; d<DIMENSION; ++d) j[d] = 0;
+
+  for (size_t idx=0; idx<volume; ++idx) {
+    FFT::Complex f[3];
+    for (int c=0; c<3; ++c) {
+      f[c] = spectrum[c][idx];
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (from[c][d]) f[c] *= std::conj(halfShift[d][j[d]]);
+      }
+    }
+
+    // Derivatives along the dimensions that are not simulated vanish
+    FFT::Complex k[3];
+    for (size_t d=0; d<DIMENSION; ++d) {
+      k[d] = dispersion[idx]*ik[d][j[d]];
+    }
+
+    FFT::Complex curl[3] = {
+      k[1]*f[2] - k[2]*f[1],
+      k[2]*f[0] - k[0]*f[2],
+      k[0]*f[1] - k[1]*f[0]
+    };
+
+    for (int c=0; c<3; ++c) {
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (to[c][d]) curl[c] *= halfShift[d][j[d]];
+      }
+      spectrum[c][idx] = curl[c];
+    }
+
+    for (int d=DIMENSION-1; d>=0; --d) {
+      if (++j[d] < boxSize[d]) break;
+      j[d] = 0;
+    }
+  }
+}
+
+void PSATD::stepSchemeInit(double dt)
+{
+  initSpectral();
+
+  for (pCurrent current: this->magCurrents) {
+    current->stepSchemeInit(dt);
+  }
+
+  stepB(0.5*dt);
+
+  for (pCurrent current: this->currents) {
+    current->stepSchemeInit(dt);
+  }
+}
+
+void PSATD::stepScheme(double dt)
+{
+  for (pCurrent current: this->currents) {
+    current->stepScheme(dt);
+  }
+
+  stepE(dt);
+
+  for (pCurrent current: this->magCurrents) {
+    current->stepScheme(dt);
+  }
+
+  stepB(dt);
+}
+
+void PSATD::stepE(double dt)
+{
+  if (dt != dispersionDt) initDispersion(dt);
+
+  sumCurrents();
+
+  auto &decomposition = getContext().getDecomposition();
+  std::vector<Field> sums = getLocalCurrentSums(false);
+
+  decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz}).forEach([&](
+      Range /* range */,
+      Field &ex, Field &ey, Field &ez,
+      Field &bx, Field &by, Field &bz) {
+    Field *e[3] = {&ex, &ey, &ez};
+    Field *b[3] = {&bx, &by, &bz};
+
+    for (int c=0; c<3; ++c) {
+      Field &field = *b[c];
+      std::vector<FFT::Complex> &spec = spectrum[c];
+      FieldIterator::forEach(Range{field.getLo(), field.getHi()}, [&](Index pos) {
+        spec[flatIndex(pos)] = field[pos];
+      });
+    }
+
+    transform(true);
+    spectralCurl(bStagger, eStagger);
+    transform(false);
+
+    for (int c=0; c<3; ++c) {
+      Field &field = *e[c];
+      Field &j = sums[c];
+      std::vector<FFT::Complex> &spec = spectrum[c];
+      FieldIterator::forEach(Range{field.getLo(), field.getHi()}, [&](Index pos) {
+        field[pos] += dt*(clight2*spec[flatIndex(pos)].real() - j[pos]/eps_0);
+      });
+    }
+  });
+
+  decomposition.exchange({Ex, Ey, Ez});
+}
+
+void PSATD::stepB(double dt)
+{
+  if (dt != dispersionDt) initDispersion(dt);
+
+  sumMagCurrents();
+
+  auto &decomposition = getContext().getDecomposition();
+  std::vector<Field> sums = getLocalCurrentSums(true);
+
+  decomposition.getGridContext({Ex, Ey, Ez, Bx, By, Bz}).forEach([&](
+      Range /* range */,
+      Field &ex, Field &ey, Field &ez,
+      Field &bx, Field &by, Field &bz) {
+    Field *e[3] = {&ex, &ey, &ez};
+    Field *b[3] = {&bx, &by, &bz};
+
+    for (int c=0; c<3; ++c) {
+      Field &field = *e[c];
+      std::vector<FFT::Complex> &spec = spectrum[c];
+      FieldIterator::forEach(Range{field.getLo(), field.getHi()}, [&](Index pos) {
+        spec[flatIndex(pos)] = field[pos];
+      });
+    }
+
+    transform(true);
+    spectralCurl(eStagger, bStagger);
+    transform(false);
+
+    for (int c=0; c<3; ++c) {
+      Field &field = *b[c];
+      Field &m = sums[c];
+      std::vector<FFT::Complex> &spec = spectrum[c];
+      FieldIterator::forEach(Range{field.getLo(), field.getHi()}, [&](Index pos) {
+        field[pos] += dt*(m[pos] - spec[flatIndex(pos)].real());
+      });
+    }
+  });
+
+  decomposition.exchange({Bx, By, Bz});
+}
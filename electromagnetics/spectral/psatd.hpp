@@ -0,0 +1,195 @@
+/*
+ * psatd.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+
+#ifndef HUERTO_PSATD_H
+#define HUERTO_PSATD_H
+
+#include "../fieldsolver.hpp"
+#include "../current.hpp"
+
+#include "../../maths/fft/fft.hpp"
+
+#include "../../simulation/simulation_context.hpp"
+
+#include "../../types.hpp"
+
+#include <vector>
+
+/**
+ * Pseudo-spectral field solver with an exact temporal dispersion relation
+ *
+ * The curls of the Maxwell equations are evaluated in Fourier space. The fields
+ * keep the Yee staggering in space and time so that the currents, sources, and
+ * diagnostics can be used in the same way as with FDTD_Plain. A staggered
+ * component is shifted to the grid nodes and back by a phase factor.
+ *
+ * The derivatives use the modified wave numbers of the staggered finite
+ * difference of order \f$p\f$, given by the `order` parameter,
+ *
+ * \f[
+ * \tilde{k}_d = \sum_{m=1}^{p/2} c_m
+ *   \frac{2\sin\left((2m-1)k_d\Delta x_d/2\right)}{\Delta x_d},
+ * \f]
+ *
+ * so that the curl is a stencil that reaches \f$p/2\f$ cells, see Vincenti
+ * and Vay (2016). The wave vector in the curl is then replaced by
+ *
+ * \f[
+ * \tilde{\mathbf{k}}\,
+ *   \frac{\sin(c|\tilde{\mathbf{k}}|\Delta t/2)}{c|\tilde{\mathbf{k}}|\Delta t/2},
+ * \f]
+ *
+ * where the factor is calculated for the length of each step. This makes the
+ * leapfrog scheme reproduce the dispersion relation
+ * \f$\omega = c|\tilde{\mathbf{k}}|\f$ of the spatial stencil for any time
+ * step. The scheme is stable for any time step, so that time steps beyond the
+ * Courant limit of the FDTD scheme can be used.
+ *
+ * Each process transforms its local grid including the ghost cells. The local
+ * grid is not periodic, and the transform wraps the stencil around its edges.
+ * The ghost cells act as guard cells that take up this error, see Vay et al.
+ * (2013), and are overwritten by the halo exchange after each half step. The
+ * number of ghost cells must be at least \f$p/2\f$, see
+ * SimulationContext::getGhostCells(). The dispersion factor has tails that
+ * decay exponentially with the distance and grow with the time step. For time
+ * steps well beyond the Courant limit, a few more ghost cells should be added.
+ *
+ * The currents are always summed into full-domain grids. Absorbing CPML layers
+ * and graded grids are not supported because the solver does not provide any
+ * stretch factors.
+ */
+class PSATD : public FieldSolver,
+              public CurrentContainer,
+              public schnek::BlockContainer<CurrentBlock>
+{
+  private:
+    /**
+     * The local grid of the electric field components,
+     * \f$\mathbf{E}\f$
+     */
+    schnek::GridRegistration Ex, Ey, Ez;
+
+    /**
+     * The local grid of the magnetic field components,
+     * \f$\mathbf{B}\f$
+     */
+    schnek::GridRegistration Bx, By, Bz;
+
+    /**
+     * The order of the finite difference that defines the modified wave numbers
+     */
+    int order;
+
+    /**
+     * The time step for which the dispersion factors have been calculated
+     */
+    double dispersionDt;
+
+    /**
+     * The lowest index of the local field grids, including the ghost cells
+     */
+    Index boxLo;
+
+    /**
+     * The number of grid points of the local field grids in each dimension
+     */
+    Index boxSize;
+
+    /**
+     * The distance between neighbouring points along each dimension in the
+     * flattened spectral arrays
+     */
+    Index strides;
+
+    /**
+     * The total number of points of the local field grids
+     */
+    size_t volume;
+
+    /**
+     * The Fourier transforms along each dimension
+     */
+    std::vector<FFT> transforms;
+
+    /**
+     * The factors \f$i\tilde{k}_d\f$ of the derivative along each dimension
+     */
+    std::vector<FFT::Complex> ik[DIMENSION];
+
+    /**
+     * The phase factors \f$e^{ik_d\Delta x_d/2}\f$ that shift a mode by half a
+     * grid cell
+     */
+    std::vector<FFT::Complex> halfShift[DIMENSION];
+
+    /**
+     * The squared modified wave number \f$|\tilde{\mathbf{k}}|^2\f$ of each mode
+     */
+    std::vector<double> k2;
+
+    /**
+     * The dispersion factor of each mode for the time step #dispersionDt
+     */
+    std::vector<double> dispersion;
+
+    /**
+     * The spectra of the three field components
+     */
+    std::vector<FFT::Complex> spectrum[3];
+
+    /**
+     * Set up the transforms and the modified wave numbers for the local grid
+     */
+    void initSpectral();
+
+    /**
+     * Calculate the dispersion factors for a step of length `dt`
+     */
+    void initDispersion(double dt);
+
+    /**
+     * The position of a grid point in the flattened spectral arrays
+     */
+    size_t flatIndex(const Index &pos) const;
+
+    /**
+     * Transform the three field spectra along all dimensions
+     */
+    void transform(bool forward);
+
+    /**
+     * Replace the spectra of a field with the spectra of its curl
+     *
+     * The field components are given with the staggering `from`. The components of
+     * the curl are shifted to the staggering `to`.
+     */
+    void spectralCurl(const Stagger *from, const Stagger *to);
+  protected:
+    /**
+     * Initialise the parameters available through the setup file
+     */
+    void initParameters(schnek::BlockParameters &blockPars);
+  public:
+    /**
+     * The modified wave number \f$\tilde{k}\f$ of the staggered stencil of order
+     * `order` for a mode with wave number `k` on a grid with spacing `dx`
+     *
+     * A mode of the solver oscillates with the frequency \f$c\tilde{k}\f$.
+     */
+    static double modifiedWaveNumber(int order, double k, double dx);
+
+    void init();
+
+    void stepSchemeInit(double dt);
+    void stepScheme(double dt);
+
+    void stepE(double dt);
+    void stepB(double dt);
+};
+
+#endif
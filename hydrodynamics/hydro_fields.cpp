@@ -7,12 +7,15 @@
 
 #include "hydro_fields.hpp"
 #include "../constants.hpp"
+#include "../simulation/grid_grading.hpp"
+#include "../simulation/moving_window.hpp"
 #include <schnek/grid/domainsubdivision.hpp>
 #include <schnek/tools/fieldtools.hpp>
 
 #include <boost/foreach.hpp>
 
 #include <memory>
+#include <vector>
 #include <string>
 #include <iostream>
 
@@ -50,14 +53,14 @@ void HydroFields::fillValues()
   schnek::Array<schnek::pParameter, DIMENSION> x_parameters = getContext().getXParameter();
   updater.addIndependentArray(x_parameters);
 
-  schnek::fill_field(Rho.field, x, Rho.value, updater, Rho.parameter);
+  fillGradedField(getContext(), Rho.field, x, Rho.value, updater, Rho.parameter);
 
   for (size_t i=0; i<DIMENSION; ++i)
   {
-    schnek::fill_field(M[i].field, x, M[i].value, updater, M[i].parameter);
+    fillGradedField(getContext(), M[i].field, x, M[i].value, updater, M[i].parameter);
   }
 
-  schnek::fill_field(E.field, x, E.value, updater, E.parameter);
+  fillGradedField(getContext(), E.field, x, E.value, updater, E.parameter);
 }
 
 void HydroFields::init()
@@ -79,4 +82,35 @@ void HydroFields::init()
   }
   E.field.resize(lowIn, highIn, domainSize, stagger, 2);
   fillValues();
+  getContext().registerShiftable(this);
+}
+
+void HydroFields::shiftWindow(size_t dim)
+{
+  auto &decomposition = getContext().getDecomposition();
+  schnek::pBlockVariables blockVars = getVariables();
+  schnek::pDependencyMap depMap(new schnek::DependencyMap(blockVars));
+
+  schnek::DependencyUpdater updater(depMap);
+
+  Vector &x = getContext().getX();
+  schnek::Array<schnek::pParameter, DIMENSION> x_parameters = getContext().getXParameter();
+  updater.addIndependentArray(x_parameters);
+
+  Range global = decomposition.getGlobalRange();
+
+  std::vector<InitialisedField<double>*> fields{&Rho, &E};
+  for (size_t i=0; i<DIMENSION; ++i)
+  {
+    fields.push_back(&M[i]);
+  }
+
+  for (InitialisedField<double> *f : fields)
+  {
+    decomposition.exchange({f->field});
+    decomposition.getGridContext({f->field}).forEach([&](Range& /* range */, Field &field) {
+      shiftInitialisedField(field, global, dim, getContext(), x, f->value, updater, f->parameter);
+    });
+    decomposition.exchange({f->field});
+  }
 }
@@ -23,7 +23,8 @@ class Vellamo;
  */
 class HydroFields :
         public schnek::ChildBlock<HydroFields>,
-        public SimulationEntity
+        public SimulationEntity,
+        public WindowShiftable
 {
   private:
     friend class Vellamo;
@@ -62,6 +63,14 @@ class HydroFields :
      * Initialise the simulation data
      */
     void init();
+
+    /**
+     * Shift the fields when the window moves
+     *
+     * The cells entering the window at the leading edge are filled from the
+     * expressions provided in the setup file.
+     */
+    void shiftWindow(size_t dim) override;
 };
 
 //inline void diagField(Field &f, std::string msg) {
@@ -0,0 +1,101 @@
+/*
+ * waveform_stream.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "waveform_stream.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+WaveformStream::WaveformStream()
+  : fd(-1), columns(1), records(0), windowRecords(1),
+    mapping(nullptr), mappingLength(0), window(nullptr), windowFirst(1), windowLast(0)
+{}
+
+WaveformStream::~WaveformStream()
+{
+  close();
+}
+
+void WaveformStream::open(const std::string &fileName, size_t columns, size_t windowRecords)
+{
+  close();
+
+  if (columns < 1) {
+    throw std::runtime_error("WaveformStream: the number of columns must be positive");
+  }
+
+  fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("WaveformStream: could not open '" + fileName + "': " + std::strerror(errno));
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    std::string error = std::strerror(errno);
+    close();
+    throw std::runtime_error("WaveformStream: could not read the size of '" + fileName + "': " + error);
+  }
+
+  this->columns = columns;
+  this->windowRecords = std::max(windowRecords, size_t(2));
+  records = size_t(info.st_size) / (columns*sizeof(double));
+}
+
+void WaveformStream::close()
+{
+  if (mapping != nullptr) munmap(mapping, mappingLength);
+  if (fd >= 0) ::close(fd);
+
+  fd = -1;
+  records = 0;
+  mapping = nullptr;
+  mappingLength = 0;
+  window = nullptr;
+  windowFirst = 1;
+  windowLast = 0;
+}
+
+void WaveformStream::require(size_t first, size_t last)
+{
+  if ((first > last) || (last >= records)) {
+    throw std::runtime_error("WaveformStream: the requested records are outside of the file");
+  }
+  if ((windowFirst <= first) && (last <= windowLast)) return;
+
+  if (mapping != nullptr) munmap(mapping, mappingLength);
+  mapping = nullptr;
+
+  // The records are usually requested in increasing order, so the window
+  // extends beyond the requested range
+  size_t count = std::min(std::max(windowRecords, last - first + 1), records - first);
+
+  size_t recordSize = columns*sizeof(double);
+  size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+  size_t begin = first*recordSize;
+  size_t alignedBegin = begin - begin % pageSize;
+  mappingLength = begin + count*recordSize - alignedBegin;
+
+  void *result = mmap(nullptr, mappingLength, PROT_READ, MAP_PRIVATE, fd, off_t(alignedBegin));
+  if (result == MAP_FAILED) {
+    windowFirst = 1;
+    windowLast = 0;
+    throw std::runtime_error(std::string("WaveformStream: could not map the file: ") + std::strerror(errno));
+  }
+  madvise(result, mappingLength, MADV_SEQUENTIAL);
+
+  mapping = result;
+  window = reinterpret_cast<const double*>(static_cast<const char*>(mapping) + (begin - alignedBegin));
+  windowFirst = first;
+  windowLast = first + count - 1;
+}
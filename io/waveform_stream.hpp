@@ -0,0 +1,99 @@
+/*
+ * waveform_stream.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_IO_WAVEFORM_STREAM_HPP_
+#define HUERTO_IO_WAVEFORM_STREAM_HPP_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A sequence of records read from a binary file through a sliding memory map
+ *
+ * The file contains the records one after the other. Each record holds
+ * `columns` values as doubles in the native byte order. Only a window of
+ * records is mapped into memory at any time. The window is moved when records
+ * outside of it are requested. In this way, files that are much larger than the
+ * available memory can be read.
+ */
+class WaveformStream
+{
+  public:
+    WaveformStream();
+    ~WaveformStream();
+
+    WaveformStream(const WaveformStream&) = delete;
+    WaveformStream &operator=(const WaveformStream&) = delete;
+
+    /**
+     * Open a file
+     *
+     * @param fileName       the name of the file
+     * @param columns        the number of values in each record
+     * @param windowRecords  the minimum number of records mapped at a time
+     */
+    void open(const std::string &fileName, size_t columns, size_t windowRecords);
+
+    /**
+     * Unmap the window and close the file
+     */
+    void close();
+
+    /**
+     * The number of complete records in the file
+     */
+    size_t getRecords() const { return records; }
+
+    /**
+     * The number of values in each record
+     */
+    size_t getColumns() const { return columns; }
+
+    /**
+     * Make sure that the records from `first` to `last` are mapped
+     *
+     * The window is only moved if any of the records lie outside of it.
+     */
+    void require(size_t first, size_t last);
+
+    /**
+     * The values of record `n`
+     *
+     * The record has to be inside the range passed to the last call of require().
+     */
+    const double *getRecord(size_t n) const { return window + (n - windowFirst)*columns; }
+
+  private:
+    /// The file descriptor or -1 if no file is open
+    int fd;
+
+    /// The number of values in each record
+    size_t columns;
+
+    /// The number of records in the file
+    size_t records;
+
+    /// The minimum number of records in the window
+    size_t windowRecords;
+
+    /// The start of the mapped memory, aligned to the page size
+    void *mapping;
+
+    /// The length of the mapped memory in bytes
+    size_t mappingLength;
+
+    /// The first record of the window
+    const double *window;
+
+    /// The index of the first record in the window
+    size_t windowFirst;
+
+    /// The index of the last record in the window
+    size_t windowLast;
+};
+
+#endif /* HUERTO_IO_WAVEFORM_STREAM_HPP_ */
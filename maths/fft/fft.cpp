@@ -0,0 +1,128 @@
+/*
+ * fft.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#include "fft.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+FFT::FFT(size_t n) : n(n)
+{
+  if (n == 0) {
+    throw std::runtime_error("FFT: the length of the transform must be positive");
+  }
+
+  // Bluestein's algorithm needs a cyclic convolution of length 2n-1 or longer
+  bool powerOfTwo = (n & (n - 1)) == 0;
+  size_t minLength = powerOfTwo ? n : 2*n - 1;
+  size_t bits = 0;
+  m = 1;
+  while (m < minLength) {
+    m <<= 1;
+    ++bits;
+  }
+
+  twiddle.resize(m/2);
+  for (size_t k=0; k<m/2; ++k) {
+    twiddle[k] = std::polar(1.0, -2.0*M_PI*double(k)/double(m));
+  }
+
+  reversed.resize(m);
+  for (size_t i=0; i<m; ++i) {
+    size_t r = 0;
+    for (size_t b=0; b<bits; ++b) {
+      if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+    }
+    reversed[i] = r;
+  }
+
+  work.resize(m);
+
+  if (powerOfTwo) return;
+
+  chirp.resize(n);
+  for (size_t j=0; j<n; ++j) {
+    // Reducing j^2 modulo 2n keeps the phase accurate for long transforms
+    size_t j2 = (j*j) % (2*n);
+    chirp[j] = std::polar(1.0, -M_PI*double(j2)/double(n));
+  }
+
+  chirpSpectrum.assign(m, Complex(0.0, 0.0));
+  chirpSpectrum[0] = std::conj(chirp[0]);
+  for (size_t j=1; j<n; ++j) {
+    chirpSpectrum[j] = std::conj(chirp[j]);
+    chirpSpectrum[m - j] = std::conj(chirp[j]);
+  }
+  radix2(chirpSpectrum.data());
+}
+
+void FFT::radix2(Complex *data)
+{
+  for (size_t i=0; i<m; ++i) {
+    size_t j = reversed[i];
+    if (i < j) std::swap(data[i], data[j]);
+  }
+
+  for (size_t len=2; len<=m; len <<= 1) {
+    size_t half = len/2;
+    size_t step = m/len;
+    for (size_t start=0; start<m; start += len) {
+      for (size_t k=0; k<half; ++k) {
+        Complex t = twiddle[k*step]*data[start + k + half];
+        data[start + k + half] = data[start + k] - t;
+        data[start + k] += t;
+      }
+    }
+  }
+}
+
+void FFT::transform(Complex *data, ptrdiff_t stride)
+{
+  if (chirp.empty()) {
+    for (size_t j=0; j<n; ++j) work[j] = data[ptrdiff_t(j)*stride];
+    radix2(work.data());
+    for (size_t j=0; j<n; ++j) data[ptrdiff_t(j)*stride] = work[j];
+    return;
+  }
+
+  // Bluestein: jk = (j^2 + k^2 - (k-j)^2)/2 turns the transform into a convolution
+  // with the conjugate chirp
+  for (size_t j=0; j<n; ++j) work[j] = data[ptrdiff_t(j)*stride]*chirp[j];
+  for (size_t j=n; j<m; ++j) work[j] = Complex(0.0, 0.0);
+
+  radix2(work.data());
+  for (size_t k=0; k<m; ++k) work[k] = std::conj(work[k]*chirpSpectrum[k]);
+
+  // The inverse transform of the product, using conjugation
+  radix2(work.data());
+  double norm = 1.0/double(m);
+  for (size_t k=0; k<n; ++k) {
+    data[ptrdiff_t(k)*stride] = chirp[k]*std::conj(work[k])*norm;
+  }
+}
+
+void FFT::forward(Complex *data, ptrdiff_t stride)
+{
+  transform(data, stride);
+}
+
+void FFT::backward(Complex *data, ptrdiff_t stride)
+{
+  for (size_t j=0; j<n; ++j) {
+    Complex &value = data[ptrdiff_t(j)*stride];
+    value = std::conj(value);
+  }
+
+  transform(data, stride);
+
+  double norm = 1.0/double(n);
+  for (size_t j=0; j<n; ++j) {
+    Complex &value = data[ptrdiff_t(j)*stride];
+    value = std::conj(value)*norm;
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ * fft.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#ifndef HUERTO_MATHS_FFT_FFT_HPP_
+#define HUERTO_MATHS_FFT_FFT_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * A one-dimensional discrete Fourier transform of a fixed length
+ *
+ * The forward transform is
+ *
+ * \f[
+ * \hat{f}_k = \sum_{j=0}^{n-1} f_j e^{-2\pi i jk/n}
+ * \f]
+ *
+ * and the backward transform is normalised so that it inverts the forward
+ * transform. Lengths that are a power of two use an iterative radix-2 transform.
+ * Any other length is mapped onto a longer radix-2 transform using Bluestein's
+ * algorithm.
+ *
+ * The data can be strided so that lines along any dimension of a multi-dimensional
+ * array can be transformed in place. An FFT object holds a work buffer and must
+ * not be used by more than one thread at a time.
+ */
+class FFT
+{
+  public:
+    typedef std::complex<double> Complex;
+
+    /**
+     * Prepare the transform of length `n`
+     */
+    explicit FFT(size_t n);
+
+    /**
+     * The length of the transform
+     */
+    size_t size() const { return n; }
+
+    /**
+     * Perform the forward transform of the `n` values `data[0]`, `data[stride]`, ...
+     */
+    void forward(Complex *data, ptrdiff_t stride = 1);
+
+    /**
+     * Perform the normalised backward transform of the `n` values `data[0]`,
+     * `data[stride]`, ...
+     */
+    void backward(Complex *data, ptrdiff_t stride = 1);
+  private:
+    /// The length of the transform
+    size_t n;
+
+    /// The length of the radix-2 transform, equal to #n if this is a power of two
+    size_t m;
+
+    /// The roots of unity for the radix-2 transform
+    std::vector<Complex> twiddle;
+
+    /// The bit-reversed index of each position of the radix-2 transform
+    std::vector<size_t> reversed;
+
+    /// The chirp \f$e^{-\pi i j^2/n}\f$ of Bluestein's algorithm; empty for radix-2 lengths
+    std::vector<Complex> chirp;
+
+    /// The radix-2 transform of the conjugate chirp
+    std::vector<Complex> chirpSpectrum;
+
+    /// A contiguous buffer of length #m
+    std::vector<Complex> work;
+
+    /**
+     * The in-place forward radix-2 transform of #m contiguous values
+     */
+    void radix2(Complex *data);
+
+    /**
+     * The unnormalised forward transform of strided data
+     */
+    void transform(Complex *data, ptrdiff_t stride);
+};
+
+#endif /* HUERTO_MATHS_FFT_FFT_HPP_ */
@@ -0,0 +1,185 @@
+/*
+ * tridiagonal.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#ifndef HUERTO_MATHS_LINEAR_TRIDIAGONAL_HPP_
+#define HUERTO_MATHS_LINEAR_TRIDIAGONAL_HPP_
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * A tridiagonal system with constant coefficients
+ *
+ * Row \f$i\f$ of the system reads
+ *
+ * \f[
+ * a x_{i-1} + b x_i + c x_{i+1} = d_i,
+ * \f]
+ *
+ * where \f$x_{-1} = x_n = 0\f$. The system is solved with the Thomas algorithm.
+ * The pivots are computed once in the constructor.
+ */
+class Tridiagonal
+{
+  private:
+    /// The size of the system
+    size_t n;
+
+    /// The constant sub-diagonal coefficient
+    double lower;
+
+    /// The reciprocal pivots of the Thomas algorithm
+    std::vector<double> inverse;
+
+    /// The modified super-diagonal of the Thomas algorithm
+    std::vector<double> modified;
+  public:
+    /**
+     * Set up the system of size `n` with the coefficients `a`, `b`, and `c`
+     *
+     * The system must be diagonally dominant, \f$|b| > |a| + |c|\f$.
+     */
+    Tridiagonal(size_t n, double a, double b, double c)
+      : n(n), lower(a), inverse(n), modified(n)
+    {
+      if (n < 1) {
+        throw std::runtime_error("Tridiagonal: the system needs at least one row");
+      }
+
+      inverse[0] = 1.0/b;
+      modified[0] = c*inverse[0];
+      for (size_t i=1; i<n; ++i) {
+        inverse[i] = 1.0/(b - lower*modified[i-1]);
+        modified[i] = c*inverse[i];
+      }
+    }
+
+    /**
+     * The size of the system
+     */
+    size_t size() const { return n; }
+
+    /**
+     * Replace the right hand side `x` of length #n by the solution of the system
+     */
+    void solve(double *x) const
+    {
+      x[0] *= inverse[0];
+      for (size_t i=1; i<n; ++i) {
+        x[i] = (x[i] - lower*x[i-1])*inverse[i];
+      }
+      for (size_t i=n-1; i>0; --i) {
+        x[i-1] -= modified[i-1]*x[i];
+      }
+    }
+};
+
+/**
+ * A cyclic tridiagonal system with constant coefficients
+ *
+ * Row \f$i\f$ of the system reads
+ *
+ * \f[
+ * a x_{i-1} + b x_i + c x_{i+1} = d_i,
+ * \f]
+ *
+ * where the indices are taken modulo \f$n\f$. The system is solved with the
+ * Thomas algorithm and the Sherman-Morrison formula for the corner elements.
+ * Everything that only depends on the coefficients is computed once in the
+ * constructor, so that each solve only sweeps over the data twice.
+ */
+class CyclicTridiagonal
+{
+  private:
+    /// The size of the system
+    size_t n;
+
+    /// The constant sub-diagonal and super-diagonal coefficients
+    double lower, upper;
+
+    /// The reciprocal pivots of the Thomas algorithm
+    std::vector<double> inverse;
+
+    /// The modified super-diagonal of the Thomas algorithm
+    std::vector<double> modified;
+
+    /// The solution of the system for the correction vector of the Sherman-Morrison formula
+    std::vector<double> correction;
+
+    /// The factor \f$a/\gamma\f$ of the Sherman-Morrison formula
+    double cornerFactor;
+
+    /// The denominator of the Sherman-Morrison formula
+    double denominator;
+
+    /**
+     * Solve the non-cyclic part of the system in place
+     */
+    void thomas(double *x) const
+    {
+      x[0] *= inverse[0];
+      for (size_t i=1; i<n; ++i) {
+        x[i] = (x[i] - lower*x[i-1])*inverse[i];
+      }
+      for (size_t i=n-1; i>0; --i) {
+        x[i-1] -= modified[i-1]*x[i];
+      }
+    }
+  public:
+    /**
+     * Set up the system of size `n` with the coefficients `a`, `b`, and `c`
+     *
+     * The system must be diagonally dominant, \f$|b| > |a| + |c|\f$, and contain
+     * at least three rows.
+     */
+    CyclicTridiagonal(size_t n, double a, double b, double c)
+      : n(n), lower(a), upper(c), inverse(n), modified(n), correction(n, 0.0)
+    {
+      if (n < 3) {
+        throw std::runtime_error("CyclicTridiagonal: the system needs at least three rows");
+      }
+
+      double gamma = -b;
+      cornerFactor = a/gamma;
+
+      // The diagonal is modified in the first and last row so that the corner
+      // elements can be split off as the product of two vectors
+      double pivot = b - gamma;
+      inverse[0] = 1.0/pivot;
+      modified[0] = c*inverse[0];
+      for (size_t i=1; i<n; ++i) {
+        double diag = (i == n-1) ? b - c*a/gamma : b;
+        inverse[i] = 1.0/(diag - lower*modified[i-1]);
+        modified[i] = c*inverse[i];
+      }
+
+      correction[0] = gamma;
+      correction[n-1] = c;
+      thomas(correction.data());
+      denominator = 1.0 + correction[0] + cornerFactor*correction[n-1];
+    }
+
+    /**
+     * The size of the system
+     */
+    size_t size() const { return n; }
+
+    /**
+     * Replace the right hand side `x` of length #n by the solution of the system
+     */
+    void solve(double *x) const
+    {
+      thomas(x);
+      double factor = (x[0] + cornerFactor*x[n-1])/denominator;
+      for (size_t i=0; i<n; ++i) {
+        x[i] -= factor*correction[i];
+      }
+    }
+};
+
+#endif /* HUERTO_MATHS_LINEAR_TRIDIAGONAL_HPP_ */
@@ -0,0 +1,157 @@
+/*
+ * grid_grading.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#include "grid_grading.hpp"
+
+#include "../constants.hpp"
+
+#include <mpi.h>
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/**
+ * Write a one-dimensional dataset of doubles to an open HDF5 file
+ */
+void writeLine(hid_t file, const std::string &name, const std::vector<double> &values)
+{
+  hsize_t size = values.size();
+  hid_t space = H5Screate_simple(1, &size, nullptr);
+  hid_t dataset = H5Dcreate2(file, name.c_str(), H5T_NATIVE_DOUBLE, space,
+                             H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  herr_t status = (dataset < 0) ? -1
+      : H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+  if (dataset >= 0) H5Dclose(dataset);
+  H5Sclose(space);
+  if (status < 0) {
+    throw std::runtime_error("GridGrading: could not write the dataset '" + name + "'");
+  }
+}
+
+}
+
+void GridGrading::initParameters(schnek::BlockParameters &blockPars)
+{
+  stretchParameters = blockPars.addArrayParameter("stretch", stretch, 1.0);
+  blockPars.addParameter("coordinates", &coordinatesFile, std::string("grid_coordinates.h5"));
+}
+
+void GridGrading::preInit()
+{
+  schnek::Block::preInit();
+  SimulationEntity::init(this);
+
+  SimulationContext &context = getContext();
+  Range global = context.getDecomposition().getGlobalRange();
+  Vector dx = context.getDx();
+
+  schnek::pBlockVariables blockVars = getVariables();
+  schnek::pDependencyMap depMap(new schnek::DependencyMap(blockVars));
+  schnek::DependencyUpdater updater(depMap);
+
+  Vector &x = context.getX();
+  updater.addIndependentArray(context.getXParameter());
+
+  // Cover the ghost cells and the positions read by the staggered components
+  ptrdiff_t margin = context.getGhostCells() + 1;
+
+  for (size_t dim=0; dim<DIMENSION; ++dim) {
+    ptrdiff_t lo = global.getLo(dim) - margin;
+    ptrdiff_t hi = global.getHi(dim) + margin + 1;
+
+    updater.clearDependent();
+    updater.addDependent(stretchParameters[dim]);
+
+    // The width of each cell, evaluated at its centre on the uniform grid
+    std::vector<double> width(hi - lo);
+    minWidth[dim] = std::numeric_limits<double>::max();
+    for (ptrdiff_t i=lo; i<hi; ++i) {
+      for (size_t d=0; d<DIMENSION; ++d) x[d] = 0.0;
+      x[dim] = (i + 0.5)*dx[dim];
+      updater.update();
+      if (stretch[dim] <= 0.0) {
+        throw std::runtime_error("GridGrading: the stretch factors must be positive");
+      }
+      width[i - lo] = stretch[dim]*dx[dim];
+      if ((i >= global.getLo(dim)) && (i <= global.getHi(dim))) {
+        minWidth[dim] = std::min(minWidth[dim], width[i - lo]);
+      }
+    }
+
+    // The node at the lower boundary of the global grid keeps its position
+    std::vector<double> nodes(hi - lo + 1);
+    ptrdiff_t origin = global.getLo(dim) - lo;
+    nodes[origin] = global.getLo(dim)*dx[dim];
+    for (ptrdiff_t k=origin; k<ptrdiff_t(width.size()); ++k) {
+      nodes[k+1] = nodes[k] + width[k];
+    }
+    for (ptrdiff_t k=origin; k>0; --k) {
+      nodes[k-1] = nodes[k] - width[k-1];
+    }
+
+    context.setGridNodes(dim, lo, nodes);
+  }
+}
+
+void GridGrading::init()
+{
+  schnek::Block::init();
+
+  // The stability limit of the Yee scheme on a uniform grid of the smallest cells
+  double sum = 0.0;
+  for (size_t d=0; d<DIMENSION; ++d) sum += 1.0/(minWidth[d]*minWidth[d]);
+  double dtMax = 1.0/(clight*sqrt(sum));
+
+  double dt = getContext().getDt();
+  if (dt > dtMax) {
+    std::ostringstream message;
+    message << "GridGrading: the time step " << dt
+            << " exceeds the stability limit " << dtMax << " of the smallest grid cells";
+    throw std::runtime_error(message.str());
+  }
+
+  if (!coordinatesFile.empty()) writeCoordinates();
+}
+
+void GridGrading::writeCoordinates()
+{
+  SimulationContext &context = getContext();
+  int rank;
+  MPI_Comm_rank(context.getDecomposition().getComm(), &rank);
+  if (rank != 0) return;
+
+  hid_t file = H5Fcreate(coordinatesFile.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file < 0) {
+    throw std::runtime_error("GridGrading: could not create the file '" + coordinatesFile + "'");
+  }
+
+  Range global = context.getDecomposition().getGlobalRange();
+  const char *axes[3] = {"x", "y", "z"};
+  try {
+    for (size_t dim=0; dim<DIMENSION; ++dim) {
+      std::vector<double> nodes;
+      std::vector<double> staggered;
+      for (ptrdiff_t i=global.getLo(dim); i<=global.getHi(dim); ++i) {
+        nodes.push_back(context.getPosition(dim, i));
+        staggered.push_back(context.getPosition(dim, i + 0.5));
+      }
+      writeLine(file, axes[dim], nodes);
+      writeLine(file, std::string(axes[dim]) + "_staggered", staggered);
+    }
+  } catch (...) {
+    H5Fclose(file);
+    throw;
+  }
+  H5Fclose(file);
+}
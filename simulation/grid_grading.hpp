@@ -0,0 +1,123 @@
+/*
+ * grid_grading.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#ifndef HUERTO_SIMULATION_GRID_GRADING_HPP_
+#define HUERTO_SIMULATION_GRID_GRADING_HPP_
+
+#include "simulation_context.hpp"
+
+#include "../types.hpp"
+
+#include <schnek/tools/fieldtools.hpp>
+#include <schnek/variables/block.hpp>
+#include <schnek/variables/dependencies.hpp>
+
+#include <string>
+
+/**
+ * A non-uniform grid spacing along the axes of the simulation domain
+ *
+ * The parameters `stretchx`, `stretchy`, and `stretchz` give the width of the grid
+ * cells relative to the uniform spacing \f$dx_i\f$. They are expressions of the
+ * position `x` on the uniform grid, i.e. the grid index times \f$dx_i\f$, and are
+ * evaluated at the centre of each cell. Each expression may only depend on the
+ * component of `x` along its own axis. The lower boundary of the global grid stays
+ * in place.
+ *
+ * The physical positions of the grid nodes are stored in the SimulationContext.
+ * FDTD_Plain includes the cell widths in its stretch factors, the initial values
+ * of the fields and the incident sources are evaluated at the physical positions.
+ * The diagnostics write the fields on the index grid. The positions of the grid
+ * points of the global domain are written to the HDF5 file given by the
+ * `coordinates` parameter, which defaults to `grid_coordinates.h5`. It holds the
+ * datasets `x`, `y`, and `z` at the integer indices and `x_staggered`,
+ * `y_staggered`, and `z_staggered` half a cell above. An empty file name
+ * disables the output.
+ *
+ * The time step of the simulation has to be reduced by the smallest stretch factor
+ * to keep the scheme stable. The initialisation fails if it exceeds the stability
+ * limit of the Yee scheme on the smallest cells. The grid should be graded smoothly
+ * and should be uniform inside absorbing layers and along the direction of a
+ * MovingWindow.
+ */
+class GridGrading :
+        public schnek::Block,
+        public SimulationEntity
+{
+  private:
+    /**
+     * The relative cell widths, evaluated from the setup file
+     */
+    Vector stretch;
+
+    /**
+     * The parser parameters associated with #stretch
+     */
+    schnek::Array<schnek::pParameter, DIMENSION> stretchParameters;
+
+    /**
+     * The name of the file containing the positions of the grid points
+     */
+    std::string coordinatesFile;
+
+    /**
+     * The smallest cell width inside the global domain along each dimension
+     */
+    Vector minWidth;
+
+    /**
+     * Write the positions of the grid points to #coordinatesFile on the first process
+     */
+    void writeCoordinates();
+  protected:
+    void initParameters(schnek::BlockParameters &blockPars) override;
+
+    /**
+     * Calculate the positions of the grid nodes and store them in the context
+     *
+     * This is done before any of the blocks are initialised.
+     */
+    void preInit() override;
+
+    /**
+     * Check the time step against the smallest cells and write the positions of
+     * the grid points
+     */
+    void init() override;
+};
+
+/**
+ * Fill a field from an initial value expression at the physical grid positions
+ *
+ * On a graded grid, the expression is evaluated at the positions of the grid
+ * nodes, see GridGrading. Otherwise this is the same as `schnek::fill_field`.
+ */
+template<typename FieldType, typename ValueType>
+void fillGradedField(SimulationContext &context,
+                     FieldType &field,
+                     Vector &x,
+                     ValueType &value,
+                     schnek::DependencyUpdater &updater,
+                     schnek::pParameter parameter)
+{
+  if (!context.isGraded()) {
+    schnek::fill_field(field, x, value, updater, parameter);
+    return;
+  }
+
+  updater.clearDependent();
+  updater.addDependent(parameter);
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{field.getLo(), field.getHi()}, [&](const Index &pos) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      x[d] = context.mapPosition(d, field.indexToPosition(d, pos[d]));
+    }
+    updater.update();
+    field[pos] = value;
+  });
+}
+
+#endif /* HUERTO_SIMULATION_GRID_GRADING_HPP_ */
@@ -0,0 +1,264 @@
+/*
+ * halo_exchange.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#include "halo_exchange.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+/**
+ * The number of grid points in a range, zero if the range is empty
+ */
+size_t rangeSize(const Range &range)
+{
+  size_t size = 1;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    size *= std::max<ptrdiff_t>(0, range.getHi(d) - range.getLo(d) + 1);
+  }
+  return size;
+}
+
+/**
+ * True if two ranges share at least one grid point
+ */
+bool intersects(const Range &a, const Range &b)
+{
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if ((a.getLo(d) > b.getHi(d)) || (a.getHi(d) < b.getLo(d))) return false;
+  }
+  return true;
+}
+
+/**
+ * The rank of the process at `sign` times `offset` from the local process in
+ * the Cartesian communicator, or MPI_PROC_NULL if it lies beyond a non-periodic
+ * boundary
+ */
+int neighbourRank(MPI_Comm comm,
+                  const int *dims,
+                  const int *periods,
+                  const int *coords,
+                  const int *offset,
+                  int sign)
+{
+  int neighbour[DIMENSION];
+  for (size_t d=0; d<DIMENSION; ++d) {
+    neighbour[d] = coords[d] + sign*offset[d];
+    if ((neighbour[d] < 0) || (neighbour[d] >= dims[d])) {
+      if (!periods[d]) return MPI_PROC_NULL;
+      neighbour[d] = (neighbour[d] + dims[d]) % dims[d];
+    }
+  }
+  int rank;
+  MPI_Cart_rank(comm, neighbour, &rank);
+  return rank;
+}
+
+/**
+ * The MPI data type matching the field values
+ */
+const MPI_Datatype realType = std::is_same<Real, float>::value ? MPI_FLOAT : MPI_DOUBLE;
+
+}
+
+HaloExchange::HaloExchange(HuertoDecomposition &decomposition,
+                           std::initializer_list<schnek::GridRegistration> registrations,
+                           const std::vector<HaloFaces> &faces)
+  : comm(decomposition.getComm()), active(false), restricted(false)
+{
+  std::vector<Range> innerRanges;
+  for (schnek::GridRegistration reg: registrations) {
+    decomposition.getGridContext({reg}).forEach([&](Range range, Field &field) {
+      fields.push_back(field);
+      innerRanges.push_back(range);
+    });
+  }
+
+  if (fields.size() != registrations.size()) {
+    throw std::runtime_error("HaloExchange: expected exactly one local grid for each field");
+  }
+  if (!faces.empty() && (faces.size() != fields.size())) {
+    throw std::runtime_error("HaloExchange: expected the ghost faces for each field");
+  }
+  if (fields.empty()) return;
+
+  // The neighbours are the adjacent processes in the Cartesian communicator,
+  // including the diagonal ones that share only an edge or a corner. Along
+  // periodic dimensions, the first and last processes are neighbours across
+  // the global boundary.
+  int dims[DIMENSION], periods[DIMENSION], coords[DIMENSION];
+  MPI_Cart_get(comm, DIMENSION, dims, periods, coords);
+
+  // Each of the 3^DIMENSION - 1 offsets is one direction of travel
+  int numOffsets = 1;
+  for (size_t d=0; d<DIMENSION; ++d) numOffsets *= 3;
+
+  for (int o=0; o<numOffsets; ++o) {
+    int offset[DIMENSION];
+    bool centre = true;
+    for (size_t d=0, rest=o; d<DIMENSION; ++d, rest/=3) {
+      offset[d] = int(rest % 3) - 1;
+      if (offset[d] != 0) centre = false;
+    }
+    if (centre) continue;
+
+    Message send;
+    Message recv;
+    send.rank = neighbourRank(comm, dims, periods, coords, offset, 1);
+    recv.rank = neighbourRank(comm, dims, periods, coords, offset, -1);
+    send.wraps = false;
+    recv.wraps = false;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      if (offset[d] > 0) {
+        send.wraps = send.wraps || (coords[d] == dims[d] - 1);
+        recv.wraps = recv.wraps || (coords[d] == 0);
+      } else if (offset[d] < 0) {
+        send.wraps = send.wraps || (coords[d] == 0);
+        recv.wraps = recv.wraps || (coords[d] == dims[d] - 1);
+      }
+    }
+    send.skipped = false;
+    recv.skipped = false;
+    // The tag identifies the direction of travel so that messages from
+    // several neighbours can be told apart if they are on the same process
+    send.tag = o;
+    recv.tag = o;
+
+    size_t count = 0;
+    for (size_t f=0; f<fields.size(); ++f) {
+      const Field &field = fields[f];
+      const Range &inner = innerRanges[f];
+      Index sendLo = inner.getLo();
+      Index sendHi = inner.getHi();
+      Index recvLo = inner.getLo();
+      Index recvHi = inner.getHi();
+      // An edge or a corner is only needed if all the adjacent faces are
+      bool needed = true;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (offset[d] > 0) {
+          // Fill the lower ghost cells of the upper neighbour
+          needed = needed && (faces.empty() || faces[f].low[d]);
+          ptrdiff_t ghost = inner.getLo(d) - field.getLo(d);
+          sendLo[d] = inner.getHi(d) - ghost + 1;
+          recvLo[d] = field.getLo(d);
+          recvHi[d] = inner.getLo(d) - 1;
+        } else if (offset[d] < 0) {
+          // Fill the upper ghost cells of the lower neighbour
+          needed = needed && (faces.empty() || faces[f].high[d]);
+          ptrdiff_t ghost = field.getHi(d) - inner.getHi(d);
+          sendHi[d] = inner.getLo(d) + ghost - 1;
+          recvLo[d] = inner.getHi(d) + 1;
+          recvHi[d] = field.getHi(d);
+        }
+      }
+      if (!needed) {
+        // An empty range
+        sendHi[0] = sendLo[0] - 1;
+        recvHi[0] = recvLo[0] - 1;
+      }
+      send.ranges.push_back(Range{sendLo, sendHi});
+      recv.ranges.push_back(Range{recvLo, recvHi});
+      count += rangeSize(recv.ranges.back());
+    }
+
+    if (count == 0) continue;
+
+    send.buffer.resize(count);
+    recv.buffer.resize(count);
+
+    sends.push_back(send);
+    receives.push_back(recv);
+  }
+
+  requests.resize(sends.size() + receives.size());
+}
+
+bool HaloExchange::canSkip(const Message &message) const
+{
+  // There is no neighbour at a non-periodic boundary
+  if (message.rank == MPI_PROC_NULL) return true;
+
+  // The sender tests the inner cells it sends and the receiver the ghost cells
+  // it receives. Away from the periodic boundary, both have the same global
+  // indices, so that both processes come to the same decision.
+  if (!restricted || message.wraps) return false;
+  for (const Range &range: message.ranges) {
+    if ((rangeSize(range) > 0) && intersects(range, activeRange)) return false;
+  }
+  return true;
+}
+
+void HaloExchange::pack(Message &message)
+{
+  // The buffer is filled in order, so the iteration must be sequential
+  Real *data = message.buffer.data();
+  for (size_t f=0; f<fields.size(); ++f) {
+    if (rangeSize(message.ranges[f]) == 0) continue;
+    Field &field = fields[f];
+    schnek::RangeCIterationPolicy<DIMENSION>::forEach(message.ranges[f], [&](const Index &pos) {
+      *(data++) = field[pos];
+    });
+  }
+}
+
+void HaloExchange::unpack(Message &message)
+{
+  const Real *data = message.buffer.data();
+  for (size_t f=0; f<fields.size(); ++f) {
+    if (rangeSize(message.ranges[f]) == 0) continue;
+    Field &field = fields[f];
+    schnek::RangeCIterationPolicy<DIMENSION>::forEach(message.ranges[f], [&](const Index &pos) {
+      field[pos] = *(data++);
+    });
+  }
+}
+
+void HaloExchange::start()
+{
+  if (active) {
+    throw std::runtime_error("HaloExchange: exchange started twice");
+  }
+
+  size_t r = 0;
+  for (Message &message: receives) {
+    message.skipped = canSkip(message);
+    if (message.skipped) {
+      requests[r++] = MPI_REQUEST_NULL;
+      continue;
+    }
+    MPI_Irecv(message.buffer.data(), message.buffer.size(), realType,
+              message.rank, message.tag, comm, &requests[r++]);
+  }
+
+  for (Message &message: sends) {
+    message.skipped = canSkip(message);
+    if (message.skipped) {
+      requests[r++] = MPI_REQUEST_NULL;
+      continue;
+    }
+    pack(message);
+    MPI_Isend(message.buffer.data(), message.buffer.size(), realType,
+              message.rank, message.tag, comm, &requests[r++]);
+  }
+
+  active = true;
+}
+
+void HaloExchange::finish()
+{
+  if (!active) return;
+
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  for (Message &message: receives) {
+    if (!message.skipped) unpack(message);
+  }
+
+  active = false;
+}
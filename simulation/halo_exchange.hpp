@@ -0,0 +1,213 @@
+/*
+ * halo_exchange.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#ifndef HUERTO_SIMULATION_HALO_EXCHANGE_HPP_
+#define HUERTO_SIMULATION_HALO_EXCHANGE_HPP_
+
+#include "../types.hpp"
+
+#include <mpi.h>
+
+#include <initializer_list>
+#include <vector>
+
+/**
+ * The ghost faces of a field that are filled by a HaloExchange
+ */
+struct HaloFaces
+{
+    /**
+     * True if the ghost cells below the lower boundary in a dimension are needed
+     */
+    schnek::Array<bool, DIMENSION> low;
+
+    /**
+     * True if the ghost cells above the upper boundary in a dimension are needed
+     */
+    schnek::Array<bool, DIMENSION> high;
+
+    /**
+     * All faces in all dimensions
+     */
+    static HaloFaces all() {
+      HaloFaces faces;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        faces.low[d] = true;
+        faces.high[d] = true;
+      }
+      return faces;
+    }
+};
+
+/**
+ * A split-phase exchange of the ghost cells of a set of fields
+ *
+ * This performs the same task as `HuertoDecomposition::exchange` but splits the
+ * exchange into two parts. #start posts non-blocking sends and receives for the
+ * ghost layers. #finish waits for the messages and copies the received data into
+ * the ghost cells. Any computation that neither modifies the cells being sent nor
+ * reads the ghost cells can be carried out in between.
+ *
+ * The faces, edges, and corners of the ghost regions are exchanged, each with
+ * a separate message to the neighbour that holds the data. The exchange can
+ * therefore be used by stencils that reach diagonally, and the result does not
+ * depend on the order in which the messages arrive.
+ *
+ * For each field, the exchange can be restricted to a subset of the faces. Messages
+ * are only sent for the faces that are needed, and for the edges and corners
+ * where all adjacent faces are needed. A stencil reading only on one side then
+ * halves the communication volume.
+ *
+ * The neighbours are the processes in the Cartesian communicator of the
+ * decomposition whose coordinates differ by at most one in each dimension. Along
+ * non-periodic dimensions, the ghost cells at the global boundary are left
+ * untouched. Each process must hold exactly one local grid of every field.
+ */
+class HaloExchange
+{
+  private:
+    /**
+     * A message sent to or received from a neighbouring process
+     */
+    struct Message
+    {
+        /**
+         * The rank of the neighbour
+         */
+        int rank;
+
+        /**
+         * The tag identifying the message
+         */
+        int tag;
+
+        /**
+         * The index range of the data for each field
+         */
+        std::vector<Range> ranges;
+
+        /**
+         * The buffer holding the packed data
+         */
+        std::vector<Real> buffer;
+
+        /**
+         * True if the message crosses the periodic boundary of the global domain
+         */
+        bool wraps;
+
+        /**
+         * True if the message is skipped in the current exchange
+         */
+        bool skipped;
+    };
+
+    /**
+     * The local grids of the exchanged fields
+     */
+    std::vector<Field> fields;
+
+    /**
+     * The messages sent to the neighbours
+     */
+    std::vector<Message> sends;
+
+    /**
+     * The messages received from the neighbours
+     */
+    std::vector<Message> receives;
+
+    /**
+     * The MPI requests of the messages, receives first
+     */
+    std::vector<MPI_Request> requests;
+
+    /**
+     * The Cartesian communicator of the decomposition
+     */
+    MPI_Comm comm;
+
+    /**
+     * True between #start and #finish
+     */
+    bool active;
+
+    /**
+     * True if the exchange is restricted to #activeRange
+     */
+    bool restricted;
+
+    /**
+     * The global range outside of which the fields vanish
+     */
+    Range activeRange;
+
+    /**
+     * True if a message can be skipped because its data lies outside #activeRange
+     */
+    bool canSkip(const Message &message) const;
+
+    /**
+     * Copy the data of the fields into the message buffer
+     */
+    void pack(Message &message);
+
+    /**
+     * Copy the data from the message buffer into the fields
+     */
+    void unpack(Message &message);
+  public:
+    /**
+     * Set up the exchange of a list of fields
+     *
+     * `faces` holds the ghost faces to fill for each field. If it is empty, all
+     * faces of all fields are filled. The faces must be the same on all
+     * processes. This is a collective operation.
+     */
+    HaloExchange(HuertoDecomposition &decomposition,
+                 std::initializer_list<schnek::GridRegistration> registrations,
+                 const std::vector<HaloFaces> &faces = std::vector<HaloFaces>());
+
+    /**
+     * Post the non-blocking sends and receives
+     */
+    void start();
+
+    /**
+     * Wait for all messages to complete and fill the ghost cells
+     */
+    void finish();
+
+    /**
+     * Only exchange the data that intersects a global index range
+     *
+     * The fields must vanish outside the range on all processes, both in the
+     * inner cells and in the ghost cells. Messages whose data lies entirely
+     * outside the range are skipped by the sending and the receiving process.
+     * Messages across the periodic boundary are always sent. The range must be
+     * the same on all processes.
+     */
+    void setActiveRange(const Range &range) {
+      restricted = true;
+      activeRange = range;
+    }
+
+    /**
+     * Exchange all the data again
+     */
+    void clearActiveRange() { restricted = false; }
+
+    /**
+     * Perform a complete exchange
+     */
+    void exchange() {
+      start();
+      finish();
+    }
+};
+
+#endif /* HUERTO_SIMULATION_HALO_EXCHANGE_HPP_ */
@@ -0,0 +1,126 @@
+/*
+ * line_transpose.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#include "line_transpose.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+LineTranspose::LineTranspose(const Range &localRange, size_t dim, MPI_Comm comm)
+  : dim(dim), localRange(localRange)
+{
+  // The processes sharing the cross section differ only in their coordinate
+  // along dim and are ordered along the lines
+  int remain[DIMENSION];
+  for (size_t d=0; d<DIMENSION; ++d) remain[d] = (d == dim);
+  MPI_Cart_sub(comm, remain, &lineComm);
+  MPI_Comm_size(lineComm, &numMembers);
+  MPI_Comm_rank(lineComm, &member);
+
+  int segment = int(localRange.getHi(dim) - localRange.getLo(dim) + 1);
+  segmentLength.resize(numMembers);
+  MPI_Allgather(&segment, 1, MPI_INT, segmentLength.data(), 1, MPI_INT, lineComm);
+
+  long start = localRange.getLo(dim);
+  std::vector<long> segmentStart(numMembers);
+  MPI_Allgather(&start, 1, MPI_LONG, segmentStart.data(), 1, MPI_LONG, lineComm);
+
+  segmentOffset.resize(numMembers);
+  length = 0;
+  for (int m=0; m<numMembers; ++m) {
+    if (segmentStart[m] != segmentStart[0] + long(length)) {
+      throw std::runtime_error("LineTranspose: the local ranges do not form complete lines");
+    }
+    segmentOffset[m] = int(length);
+    length += segmentLength[m];
+  }
+
+  Index crossHi = localRange.getHi();
+  crossHi[dim] = localRange.getLo(dim);
+  crossSection = Range{localRange.getLo(), crossHi};
+
+  totalLines = 1;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    if (d != dim) totalLines *= localRange.getHi(d) - localRange.getLo(d) + 1;
+  }
+
+  firstLine.resize(numMembers + 1);
+  for (int m=0; m<=numMembers; ++m) {
+    firstLine[m] = totalLines*m/numMembers;
+  }
+
+  sendCounts.resize(numMembers);
+  sendOffsets.resize(numMembers);
+  recvCounts.resize(numMembers);
+  recvOffsets.resize(numMembers);
+  int sendTotal = 0;
+  int recvTotal = 0;
+  for (int m=0; m<numMembers; ++m) {
+    sendCounts[m] = int(firstLine[m+1] - firstLine[m])*segment;
+    recvCounts[m] = int(numLines())*segmentLength[m];
+    sendOffsets[m] = sendTotal;
+    recvOffsets[m] = recvTotal;
+    sendTotal += sendCounts[m];
+    recvTotal += recvCounts[m];
+  }
+  sendBuffer.resize(sendTotal);
+  recvBuffer.resize(recvTotal);
+}
+
+LineTranspose::~LineTranspose()
+{
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (!finalized) MPI_Comm_free(&lineComm);
+}
+
+void LineTranspose::gather(const Field &field, std::vector<double> &lines)
+{
+  // The lines of each member are consecutive in the iteration order of the cross
+  // section, so the buffer is filled in the order of the members
+  size_t k = 0;
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(crossSection, [&](const Index &base) {
+    Index pos = base;
+    for (ptrdiff_t i=localRange.getLo(dim); i<=localRange.getHi(dim); ++i) {
+      pos[dim] = i;
+      sendBuffer[k++] = field[pos];
+    }
+  });
+
+  MPI_Alltoallv(sendBuffer.data(), sendCounts.data(), sendOffsets.data(), MPI_DOUBLE,
+                recvBuffer.data(), recvCounts.data(), recvOffsets.data(), MPI_DOUBLE, lineComm);
+
+  lines.resize(numLines()*length);
+  for (int m=0; m<numMembers; ++m) {
+    for (size_t l=0; l<numLines(); ++l) {
+      const double *segment = &recvBuffer[recvOffsets[m] + l*segmentLength[m]];
+      std::copy(segment, segment + segmentLength[m], &lines[l*length + segmentOffset[m]]);
+    }
+  }
+}
+
+void LineTranspose::scatter(const std::vector<double> &lines, Field &field)
+{
+  for (int m=0; m<numMembers; ++m) {
+    for (size_t l=0; l<numLines(); ++l) {
+      const double *segment = &lines[l*length + segmentOffset[m]];
+      std::copy(segment, segment + segmentLength[m], &recvBuffer[recvOffsets[m] + l*segmentLength[m]]);
+    }
+  }
+
+  MPI_Alltoallv(recvBuffer.data(), recvCounts.data(), recvOffsets.data(), MPI_DOUBLE,
+                sendBuffer.data(), sendCounts.data(), sendOffsets.data(), MPI_DOUBLE, lineComm);
+
+  size_t k = 0;
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(crossSection, [&](const Index &base) {
+    Index pos = base;
+    for (ptrdiff_t i=localRange.getLo(dim); i<=localRange.getHi(dim); ++i) {
+      pos[dim] = i;
+      field[pos] = sendBuffer[k++];
+    }
+  });
+}
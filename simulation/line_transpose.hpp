@@ -0,0 +1,114 @@
+/*
+ * line_transpose.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#ifndef HUERTO_SIMULATION_LINE_TRANSPOSE_HPP_
+#define HUERTO_SIMULATION_LINE_TRANSPOSE_HPP_
+
+#include "../types.hpp"
+
+#include <mpi.h>
+
+#include <vector>
+
+/**
+ * Redistribute a field so that each process holds complete grid lines along one
+ * dimension
+ *
+ * The processes whose local ranges cover the same cross section perpendicular to
+ * `dim` share the grid lines along `dim`. Each line is cut into segments by the
+ * decomposition. The lines of the cross section are divided evenly between these
+ * processes. #gather sends the segments to the process that holds the line, and
+ * #scatter returns the lines to the owners of the segments. This allows
+ * operations that need the whole line, such as implicit solves, to be carried
+ * out in parallel over the lines.
+ *
+ * The processes are taken from the Cartesian communicator of the decomposition.
+ * Those sharing a cross section are the processes along `dim`. The local range
+ * is the inner range of the field, without the ghost cells. Each process must
+ * hold exactly one local grid. The constructor is a collective operation on all
+ * processes of the communicator.
+ */
+class LineTranspose
+{
+  private:
+    /// The dimension along the lines
+    size_t dim;
+
+    /// The inner range of the local grid
+    Range localRange;
+
+    /// The cross section of the local range, collapsed to a single plane along #dim
+    Range crossSection;
+
+    /// The processes sharing the cross section, ordered along #dim
+    MPI_Comm lineComm;
+
+    /// The number of processes in #lineComm
+    int numMembers;
+
+    /// The rank of this process in #lineComm
+    int member;
+
+    /// The total length of each line
+    size_t length;
+
+    /// The number of lines through the cross section
+    size_t totalLines;
+
+    /// The length of the segment of each member and its offset along the line
+    std::vector<int> segmentLength, segmentOffset;
+
+    /// The first line held by each member; the last entry is #totalLines
+    std::vector<size_t> firstLine;
+
+    /// The message sizes and offsets for the segments sent to and received from each member
+    std::vector<int> sendCounts, sendOffsets, recvCounts, recvOffsets;
+
+    /// The message buffers
+    std::vector<double> sendBuffer, recvBuffer;
+  public:
+    /**
+     * Set up the redistribution of lines along `dim` for the local range
+     *
+     * `comm` is the Cartesian communicator of the decomposition.
+     */
+    LineTranspose(const Range &localRange, size_t dim, MPI_Comm comm);
+
+    ~LineTranspose();
+
+    LineTranspose(const LineTranspose &) = delete;
+    LineTranspose &operator=(const LineTranspose &) = delete;
+
+    /**
+     * The total length of the lines
+     */
+    size_t lineLength() const { return length; }
+
+    /**
+     * The number of complete lines held by this process
+     */
+    size_t numLines() const { return firstLine[member + 1] - firstLine[member]; }
+
+    /**
+     * Collect the complete lines held by this process
+     *
+     * On return, `lines` holds #numLines lines of length #lineLength, one after the
+     * other. The lines start at the lower boundary of the global domain. This is a
+     * collective operation on the processes sharing the cross section.
+     */
+    void gather(const Field &field, std::vector<double> &lines);
+
+    /**
+     * Return the lines collected by #gather to the local ranges of the field
+     *
+     * Only the inner range of the field is written. This is a collective operation
+     * on the processes sharing the cross section.
+     */
+    void scatter(const std::vector<double> &lines, Field &field);
+};
+
+#endif /* HUERTO_SIMULATION_LINE_TRANSPOSE_HPP_ */
@@ -0,0 +1,49 @@
+/*
+ * moving_window.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#include "moving_window.hpp"
+
+#include "../constants.hpp"
+
+#include <stdexcept>
+
+void MovingWindow::initParameters(schnek::BlockParameters &blockPars)
+{
+  blockPars.addParameter("dim", &dim, 0);
+  blockPars.addParameter("speed", &speed, clight);
+  blockPars.addParameter("start", &start, 0.0);
+}
+
+void MovingWindow::init()
+{
+  schnek::Block::init();
+  SimulationEntity::init(this);
+
+  if ((dim < 0) || (dim >= DIMENSION)) {
+    throw std::runtime_error("MovingWindow: dim must refer to a dimension of the simulation");
+  }
+  if (speed < 0.0) {
+    throw std::runtime_error("MovingWindow: the window can only move in the positive direction");
+  }
+}
+
+std::string MovingWindow::getPhase()
+{
+  return "pre-diagnostic";
+}
+
+void MovingWindow::execute()
+{
+  SimulationContext &context = getContext();
+  double distance = speed*(context.getTime() - start);
+  double dx = context.getDx()[dim];
+
+  // The window only moves by whole cells
+  while (distance >= (context.getWindowShift()[dim] + 1)*dx) {
+    context.shiftWindow(dim);
+  }
+}
@@ -0,0 +1,109 @@
+/*
+ * moving_window.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *  Author: Holger Schmitz (holger@notjustphysics.com)
+ */
+
+#ifndef HUERTO_SIMULATION_MOVING_WINDOW_HPP_
+#define HUERTO_SIMULATION_MOVING_WINDOW_HPP_
+
+#include "simulation_context.hpp"
+#include "task.hpp"
+
+#include "../types.hpp"
+
+#include <schnek/variables/block.hpp>
+#include <schnek/variables/dependencies.hpp>
+
+#include <string>
+
+/**
+ * A window that moves along one axis of the simulation domain
+ *
+ * Only a window around the region of interest, such as a travelling laser pulse,
+ * is simulated. The window moves along the dimension `dim` with the velocity
+ * `speed`, starting at the time `start`. Each time the window has moved by a whole
+ * grid cell, SimulationContext::shiftWindow() is called. The fields are shifted
+ * down by one cell and the cells at the leading edge of the domain are filled from
+ * the initial value expressions.
+ *
+ * The position `x` in the setup file refers to the frame of the initial window.
+ * The grid indices always refer to the current window.
+ */
+class MovingWindow :
+        public schnek::Block,
+        public SimulationEntity,
+        public SimulationTask
+{
+  private:
+    /**
+     * The dimension along which the window moves
+     */
+    int dim;
+
+    /**
+     * The velocity of the window in m/s
+     */
+    double speed;
+
+    /**
+     * The simulation time at which the window starts moving
+     */
+    double start;
+  protected:
+    void initParameters(schnek::BlockParameters &blockPars) override;
+    void init() override;
+  public:
+    std::string getPhase() override;
+    void execute() override;
+};
+
+/**
+ * Shift the local grid of an initialised field down by one cell along `dim`
+ *
+ * All cells of the grid, including the ghost cells, are moved. This requires the
+ * ghost cells to be up to date. The cells on the upper boundary of the global
+ * range `global` are then filled from the initial value expression. The positions
+ * are taken from the grid of the `context` and offset by the distance by which the
+ * window has moved. The ghost cells have to be exchanged afterwards.
+ */
+template<typename FieldType, typename ValueType>
+void shiftInitialisedField(FieldType &field,
+                           const Range &global,
+                           size_t dim,
+                           SimulationContext &context,
+                           Vector &x,
+                           ValueType &value,
+                           schnek::DependencyUpdater &updater,
+                           schnek::pParameter parameter)
+{
+  // Moving through the grid in C order, each cell is read before it is overwritten
+  Index lo = field.getLo();
+  Index hi = field.getHi();
+  hi[dim] -= 1;
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{lo, hi}, [&](const Index &pos) {
+    Index next = pos;
+    ++next[dim];
+    field[pos] = field[next];
+  });
+
+  if (field.getInnerHi()[dim] != global.getHi(dim)) return;
+
+  lo = field.getInnerLo();
+  hi = field.getInnerHi();
+  lo[dim] = hi[dim];
+
+  Vector offset = context.getWindowOffset();
+  updater.clearDependent();
+  updater.addDependent(parameter);
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{lo, hi}, [&](const Index &pos) {
+    for (size_t d=0; d<DIMENSION; ++d) {
+      x[d] = context.mapPosition(d, field.indexToPosition(d, pos[d])) + offset[d];
+    }
+    updater.update();
+    field[pos] = value;
+  });
+}
+
+#endif /* HUERTO_SIMULATION_MOVING_WINDOW_HPP_ */
@@ -12,6 +12,30 @@
 
 #include <schnek/variables/block.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <vector>
+
+/**
+ * Interface for simulation data that follows a moving window
+ *
+ * Classes implementing this interface register themselves with the
+ * SimulationContext. They are notified each time the window moves.
+ */
+class WindowShiftable
+{
+  public:
+    virtual ~WindowShiftable() {}
+
+    /**
+     * Move the data down by one grid cell along the dimension `dim`
+     *
+     * This is called after SimulationContext::getWindowShift() has been updated.
+     */
+    virtual void shiftWindow(size_t dim) = 0;
+};
+
 /**
  * A simulation context representing a regular grid domain simulated through time
  */
@@ -82,7 +106,41 @@ class SimulationContext
      */
     std::shared_ptr<HuertoDecomposition> decomposition;
 
+    /**
+     * The number of ghost cells of the registered simulation fields
+     *
+     * This quantity is specified through the `ghostCells` parameter in the setup file
+     * and defaults to 2. Only solvers with wide stencils need more, i.e. the
+     * fourth-order stencil of FDTD_Plain and the finite-order PSATD solver. The
+     * halo is exchanged after every time step regardless of its width.
+     */
+    int ghostCells;
+
+    /**
+     * The number of grid cells by which the window has moved in each dimension
+     */
+    Index windowShift;
+
+    /**
+     * The data that is shifted when the window moves
+     */
+    std::list<WindowShiftable*> shiftables;
+
+    /**
+     * The physical positions of the grid nodes along each dimension of a graded grid
+     *
+     * The vectors are empty along dimensions with uniform grid spacing.
+     */
+    std::vector<double> gridNodes[DIMENSION];
+
+    /**
+     * The grid index of the first entry in #gridNodes
+     */
+    ptrdiff_t gridNodesLo[DIMENSION];
+
   public:
+    SimulationContext() { windowShift = 0; }
+
     /**
      * A virtual destructor to allow dynamic casts to the inherited type
      */
@@ -128,6 +186,106 @@ class SimulationContext
      */
     HuertoDecomposition &getDecomposition() { return *decomposition; };
 
+    /**
+     * Get the number of ghost cells, #ghostCells
+     */
+    int getGhostCells() { return ghostCells; }
+
+    /**
+     * Get the number of grid cells by which the window has moved, #windowShift
+     */
+    const Index &getWindowShift() { return windowShift; }
+
+    /**
+     * Get the physical distance by which the window has moved
+     *
+     * Grid positions have to be offset by this distance to obtain positions
+     * in the frame of the initial window.
+     */
+    Vector getWindowOffset() {
+      Vector offset;
+      for (size_t d=0; d<DIMENSION; ++d) offset[d] = windowShift[d]*dx[d];
+      return offset;
+    }
+
+    /**
+     * Set the physical positions of the grid nodes along the dimension `dim`
+     *
+     * The first entry of `nodes` belongs to the grid index `lo`. This turns the
+     * grid spacing along `dim` into a graded one, see GridGrading.
+     */
+    void setGridNodes(size_t dim, ptrdiff_t lo, const std::vector<double> &nodes) {
+      gridNodesLo[dim] = lo;
+      gridNodes[dim] = nodes;
+    }
+
+    /**
+     * Returns true if the grid spacing is graded along any dimension
+     */
+    bool isGraded() {
+      for (size_t d=0; d<DIMENSION; ++d) {
+        if (!gridNodes[d].empty()) return true;
+      }
+      return false;
+    }
+
+    /**
+     * Get the physical position of the grid index `index` along the dimension `dim`
+     *
+     * Half-integer indices give the positions of the staggered grid points. On a
+     * graded grid, the positions are interpolated linearly between the grid nodes.
+     * Beyond the stored nodes, the size of the outermost cell is assumed.
+     */
+    double getPosition(size_t dim, double index) {
+      const std::vector<double> &nodes = gridNodes[dim];
+      if (nodes.empty()) return index*dx[dim];
+
+      double t = index - gridNodesLo[dim];
+      ptrdiff_t last = nodes.size() - 2;
+      ptrdiff_t k = std::min<ptrdiff_t>(std::max<ptrdiff_t>(ptrdiff_t(std::floor(t)), 0), last);
+      return nodes[k] + (t - k)*(nodes[k+1] - nodes[k]);
+    }
+
+    /**
+     * Map a position on the uniform grid with spacing #dx to the physical position
+     * on the graded grid
+     */
+    double mapPosition(size_t dim, double x) {
+      return gridNodes[dim].empty() ? x : getPosition(dim, x/dx[dim]);
+    }
+
+    /**
+     * Get the width of a grid cell of the Yee scheme relative to #dx
+     *
+     * For `stagger == false`, this is the distance between the staggered points
+     * on either side of the grid node `index`. Otherwise it is the distance between
+     * the grid nodes on either side of the staggered point `index + 1/2`. The factor
+     * is exactly one on a uniform grid.
+     */
+    double getGrading(size_t dim, ptrdiff_t index, bool stagger) {
+      if (gridNodes[dim].empty()) return 1.0;
+      double width = stagger
+          ? getPosition(dim, index + 1.0) - getPosition(dim, index)
+          : getPosition(dim, index + 0.5) - getPosition(dim, index - 0.5);
+      return width/dx[dim];
+    }
+
+    /**
+     * Register data that has to be shifted when the window moves
+     */
+    void registerShiftable(WindowShiftable *shiftable) { shiftables.push_back(shiftable); }
+
+    /**
+     * Move the window by one grid cell along the dimension `dim`
+     *
+     * All the registered data is shifted down by one cell, so that the grid
+     * indices keep referring to the window. This is a collective operation.
+     */
+    void shiftWindow(size_t dim) {
+      ++windowShift[dim];
+      for (WindowShiftable *shiftable: shiftables) shiftable->shiftWindow(dim);
+    }
+
     /**
      * Initialise the global parameters exposed in the setup file
      *
@@ -136,6 +294,7 @@ class SimulationContext
      */
     void initParameters(schnek::BlockParameters &blockPars) {
       x_parameters = blockPars.addArrayParameter("", x, schnek::BlockParameters::readonly);
+      blockPars.addParameter("ghostCells", &ghostCells, 2);
     }
 
     void init() {
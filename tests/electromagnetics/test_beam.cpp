@@ -0,0 +1,140 @@
+/*
+ * test_beam.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/incident_source.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+#include "../../electromagnetics/source/beam.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#ifndef HUERTO_ONE_DIM
+
+namespace {
+
+/**
+ * The parameters of an obliquely incident Gaussian beam
+ */
+struct BeamParameters
+{
+    Vector k;
+    Vector origin;
+    Vector3d F;
+
+    BeamParameters(SimulationContext &context)
+    {
+      const double kn = 2.0*PI/8e-6;
+      Vector size = context.getSize();
+      for (size_t d=0; d<DIMENSION; ++d) {
+        k[d] = 0.0;
+        origin[d] = 0.5*size[d];
+      }
+      k[0] = kn*std::cos(0.3);
+      k[1] = kn*std::sin(0.3);
+#ifdef HUERTO_THREE_DIM
+      k[2] = 0.1*kn;
+#endif
+      F = Vector3d(0.0, 0.0, 1.0);
+    }
+
+    template<class Func>
+    void apply(Func &func)
+    {
+      func.setParam(k, origin, F, 6e-6, 10e-6, 5e-6, 1.0, 0.0, 1);
+    }
+};
+
+Vector3d directHField(GaussBeamSourceEFunc &func, const Index &pos, double time)
+{
+#ifdef HUERTO_TWO_DIM
+  return func.getHField(pos[0], pos[1], time);
+#endif
+#ifdef HUERTO_THREE_DIM
+  return func.getHField(pos[0], pos[1], pos[2], time);
+#endif
+}
+
+Vector3d directEField(GaussBeamSourceHFunc &func, const Index &pos, double time)
+{
+#ifdef HUERTO_TWO_DIM
+  return func.getEField(pos[0], pos[1], time);
+#endif
+#ifdef HUERTO_THREE_DIM
+  return func.getEField(pos[0], pos[1], pos[2], time);
+#endif
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( beam_source )
+
+/*
+ * The current sheets are filled from the cached beam profiles. They must agree
+ * with the fields of source functions that evaluate the beam directly. After the
+ * window has moved along the normal of the sheet, the sheet lies partly or
+ * completely outside the cache and the profiles are evaluated directly.
+ */
+BOOST_FIXTURE_TEST_CASE( cache_matches_direct_evaluation, EMSimulationRunner )
+{
+  const double tolerance = 10*std::numeric_limits<Real>::epsilon();
+
+  for (Direction dir: allDirections()) {
+    pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", incidentSourceSetup());
+    SimulationContext &context = *simulation;
+    BeamParameters beam(context);
+
+    typedef SheetProbe<IncidentSourceECurrent, GaussBeamSourceEFunc> ECurrent;
+    typedef SheetProbe<IncidentSourceHCurrent, GaussBeamSourceHFunc> HCurrent;
+    std::shared_ptr<ECurrent> eCurrent = std::make_shared<ECurrent>(4, dir, context);
+    std::shared_ptr<HCurrent> hCurrent = std::make_shared<HCurrent>(4, dir, context);
+    beam.apply(*eCurrent);
+    beam.apply(*hCurrent);
+    eCurrent->init();
+    hCurrent->init();
+
+    GaussBeamSourceEFunc eDirect(dir, context);
+    GaussBeamSourceHFunc hDirect(dir, context);
+    beam.apply(eDirect);
+    beam.apply(hDirect);
+
+    int dim = static_cast<int>(dir)/2;
+    simulation->run(5);
+    for (int shift: {0, 1, 3}) {
+      while (context.getWindowShift()[dim] < shift) context.shiftWindow(dim);
+      simulation->advance(2);
+
+      eCurrent->stepScheme(context.getDt());
+      hCurrent->stepScheme(context.getDt());
+
+      double maxValue;
+      double error = sheetDeviation(*eCurrent, [&](const Index &pos, double time) {
+        return directHField(eDirect, pos, time);
+      }, context.getTime(), maxValue);
+      if (eCurrent->isActive()) BOOST_CHECK_GT(maxValue, 0.0);
+      BOOST_CHECK_LE(error, tolerance*maxValue);
+
+      error = sheetDeviation(*hCurrent, [&](const Index &pos, double time) {
+        return directEField(hDirect, pos, time);
+      }, context.getTime(), maxValue);
+      if (hCurrent->isActive()) BOOST_CHECK_GT(maxValue, 0.0);
+      BOOST_CHECK_LE(error, tolerance*maxValue);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * test_cpml_border.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+#include "../../electromagnetics/pml/cpml_border.hpp"
+
+#include <mpi.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#ifdef HUERTO_TWO_DIM
+
+namespace {
+
+/**
+ * A field solver that exposes its currents
+ */
+class CurrentListFDTD : public FDTD_Plain
+{
+  public:
+    /**
+     * The number of bytes of the grids of all CPML currents on all processes
+     *
+     * This is a collective operation.
+     */
+    double cpmlStorageSize()
+    {
+      double local = 0.0;
+      for (CurrentList *list: {&currents, &magCurrents}) {
+        for (pCurrent current: *list) {
+          std::shared_ptr<CPMLBorderCurrent> cpml = std::dynamic_pointer_cast<CPMLBorderCurrent>(current);
+          if (cpml) local += cpml->getStorageSize();
+        }
+      }
+      double total;
+      MPI_Allreduce(&local, &total, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      return total;
+    }
+};
+
+/**
+ * Access to the protected factory of the test runner
+ */
+class CPMLRunner : public EMSimulationRunner
+{
+  public:
+    pTestEMSimulation create(std::string setup)
+    {
+      return createSimulation<CurrentListFDTD>("FDTD_Plain", setup,
+          [](schnek::BlockClasses &blocks) {
+            blocks.registerBlock("CPMLBorder").setClass<CPMLBorder>();
+            blocks("FDTD_Plain").addChildren("CPMLBorder");
+          });
+    }
+};
+
+CurrentListFDTD &getSolver(TestEMSimulation &simulation)
+{
+  pFieldSolver solver = simulation.schnek::BlockContainer<FieldSolver>::childBlocks().front();
+  return dynamic_cast<CurrentListFDTD&>(*solver);
+}
+
+/**
+ * A Gaussian pulse in the centre of the domain
+ */
+void fillPulse(FieldProbe &probe)
+{
+  probe.fill(2, [](const Vector &x) {
+    double rx = (x[0] - 20e-6)/3e-6;
+    double ry = (x[1] - 16e-6)/3e-6;
+    return std::exp(-rx*rx - ry*ry);
+  });
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( cpml_border )
+
+/*
+ * In compact mode the auxiliary fields of the edges are stored in single
+ * precision, while those of the faces stay in the current grid. The compact
+ * layers must therefore never need more memory than the full precision layers.
+ */
+BOOST_FIXTURE_TEST_CASE( compact_storage_size, CPMLRunner )
+{
+  pTestEMSimulation full = create("tests/electromagnetics/test_cpml_border_1.setup");
+  pTestEMSimulation compact = create("tests/electromagnetics/test_cpml_border_2.setup");
+
+  double fullBytes = getSolver(*full).cpmlStorageSize();
+  double compactBytes = getSolver(*compact).cpmlStorageSize();
+
+  BOOST_CHECK_GT(fullBytes, 0.0);
+  if (std::is_same<Real, float>::value) {
+    BOOST_CHECK_EQUAL(compactBytes, fullBytes);
+  } else {
+    BOOST_CHECK_LT(compactBytes, fullBytes);
+  }
+}
+
+/*
+ * A pulse is absorbed by the full and the compact layers in the same way, up
+ * to the rounding errors of the single precision storage
+ */
+BOOST_FIXTURE_TEST_CASE( compact_absorption, CPMLRunner )
+{
+  pTestEMSimulation full = create("tests/electromagnetics/test_cpml_border_1.setup");
+  pTestEMSimulation compact = create("tests/electromagnetics/test_cpml_border_2.setup");
+
+  fillPulse(full->getProbe());
+  fillPulse(compact->getProbe());
+  double initial = full->getProbe().sumSquares(2);
+
+  full->run(200);
+  compact->run(200);
+
+  double fullEnergy = full->getProbe().sumSquares(2);
+  double compactEnergy = compact->getProbe().sumSquares(2);
+
+  BOOST_CHECK(std::isfinite(compactEnergy));
+  BOOST_CHECK_LT(fullEnergy, 0.01*initial);
+  BOOST_CHECK_SMALL(compactEnergy - fullEnergy, 1e-4*initial);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * test_current.cpp
+ *
+ * Created on: 17 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../electromagnetics/current.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+
+#include <schnek/grid/iteration/range-iteration.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+
+#ifdef HUERTO_TWO_DIM
+
+namespace {
+
+/**
+ * A constant current with a Gaussian profile that covers the whole domain
+ *
+ * The current reports itself as a volume current if `volume` is true, so that
+ * the same current can be summed or applied directly.
+ */
+class GaussCurrent : public Current
+{
+  private:
+    SimulationContext &context;
+    bool volume;
+  public:
+    GaussCurrent(SimulationContext &context, bool volume)
+      : context(context), volume(volume) {}
+
+    void init()
+    {
+      auto &decomposition = context.getDecomposition();
+      Range global = decomposition.getGlobalRange();
+      Jx = decomposition.registerField(schnek::GridFactory<Grid>{}, global);
+      Jy = decomposition.registerField(schnek::GridFactory<Grid>{}, global);
+      Jz = decomposition.registerField(schnek::GridFactory<Grid>{}, global);
+
+      decomposition.getGridContext({Jx, Jy, Jz}).forEach([&](Range range, Grid &jx, Grid &jy, Grid &jz) {
+        schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos) {
+          double rx = (pos[0] - 16.0)/4.0;
+          double ry = (pos[1] - 16.0)/4.0;
+          jx[pos] = 0.0;
+          jy[pos] = 0.0;
+          jz[pos] = 1e3*std::exp(-rx*rx - ry*ry);
+        });
+      });
+    }
+
+    void stepSchemeInit(double) {}
+    void stepScheme(double) {}
+
+    bool isVolumeCurrent() { return volume; }
+};
+
+/**
+ * A block that adds a GaussCurrent to the field solver
+ */
+class TestCurrentBlock : public CurrentBlock
+{
+  private:
+    int volume;
+  protected:
+    void initParameters(schnek::BlockParameters &blockPars)
+    {
+      CurrentBlock::initParameters(blockPars);
+      blockPars.addParameter("volume", &volume, 0);
+    }
+  public:
+    void initCurrents(CurrentContainer &container)
+    {
+      container.addCurrent(std::make_shared<GaussCurrent>(getContext(), volume != 0));
+    }
+};
+
+/**
+ * A field solver that reports how it applies the currents
+ */
+class SparseFlagFDTD : public FDTD_Plain
+{
+  public:
+    bool isSparse() { return sparseCurrents; }
+};
+
+/**
+ * Access to the protected factory of the test runner
+ */
+class CurrentRunner : public EMSimulationRunner
+{
+  public:
+    pTestEMSimulation create(std::string setup)
+    {
+      return createSimulation<SparseFlagFDTD>("FDTD_Plain", setup,
+          [](schnek::BlockClasses &blocks) {
+            blocks.registerBlock("TestCurrent").setClass<TestCurrentBlock>();
+            blocks("FDTD_Plain").addChildren("TestCurrent");
+          });
+    }
+};
+
+SparseFlagFDTD &getSolver(TestEMSimulation &simulation)
+{
+  pFieldSolver solver = simulation.schnek::BlockContainer<FieldSolver>::childBlocks().front();
+  return dynamic_cast<SparseFlagFDTD&>(*solver);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( current )
+
+/*
+ * A volume current is summed into the full-domain grids, any other current is
+ * added directly to the fields. Both paths must give the same fields.
+ */
+BOOST_FIXTURE_TEST_CASE( volume_and_sparse_currents, CurrentRunner )
+{
+  pTestEMSimulation summed = create("tests/electromagnetics/test_current_1.setup");
+  pTestEMSimulation sparse = create("tests/electromagnetics/test_current_2.setup");
+
+  BOOST_CHECK(!getSolver(*summed).isSparse());
+  BOOST_CHECK(getSolver(*sparse).isSparse());
+
+  summed->run(20);
+  sparse->run(20);
+
+  FieldProbe &summedProbe = summed->getProbe();
+  FieldProbe &sparseProbe = sparse->getProbe();
+  double maxValue = 0.0;
+  double maxError = 0.0;
+  for (ptrdiff_t i=0; i<summed->getGridSize()[0]; ++i) {
+    for (ptrdiff_t j=0; j<summed->getGridSize()[1]; ++j) {
+      Index pos{i, j};
+      double value = summedProbe.get(2, pos);
+      maxValue = std::max(maxValue, std::fabs(value));
+      maxError = std::max(maxError, std::fabs(sparseProbe.get(2, pos) - value));
+    }
+  }
+
+  BOOST_CHECK_GT(maxValue, 0.0);
+  BOOST_CHECK_LE(maxError, 100*std::numeric_limits<Real>::epsilon()*maxValue);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
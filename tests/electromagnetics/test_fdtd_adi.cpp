@@ -0,0 +1,158 @@
+/*
+ * test_fdtd_adi.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_adi.hpp"
+#include "../../electromagnetics/pml/cpml_border.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#ifdef HUERTO_TWO_DIM
+
+namespace {
+
+/**
+ * The sum of the squares of all field components with B scaled by c
+ */
+double fieldEnergy(FieldProbe &probe)
+{
+  double energy = 0.0;
+  for (int c=0; c<3; ++c) energy += probe.sumSquares(c);
+  for (int c=3; c<6; ++c) energy += clight2*probe.sumSquares(c);
+  return energy;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( fdtd_adi )
+
+/*
+ * The time step is five times the Courant limit of the Yee scheme, at which an
+ * explicit solver grows exponentially within a few steps. The initial electric
+ * field is a superposition of periodic modes up to the Nyquist wavenumber. The
+ * sum of the squares of the fields is not conserved exactly by the ADI scheme,
+ * but it must remain bounded.
+ */
+BOOST_FIXTURE_TEST_CASE( stable_above_courant_limit, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_ADI>("FDTD_ADI",
+      "tests/electromagnetics/test_fdtd_adi_1.setup");
+  FieldProbe &probe = simulation->getProbe();
+
+  const Vector dx = simulation->getDx();
+  const double lx = 32.0*dx[0];
+  const double ly = 32.0*dx[1];
+  const int modes[5][2] = {{3, 5}, {11, 2}, {15, 13}, {7, 16}, {16, 9}};
+  for (int c=0; c<3; ++c) {
+    probe.fill(c, [&](const Vector &x) {
+      double f = 0.0;
+      for (const int *m: modes) {
+        f += std::cos(2.0*M_PI*(m[0]*x[0]/lx + 0.1*(c + 1)))
+            *std::cos(2.0*M_PI*(m[1]*x[1]/ly + 0.05*(c + 1)));
+      }
+      return f;
+    });
+  }
+
+  BOOST_CHECK_CLOSE(clight*simulation->getDt()/dx[0], 5.0/std::sqrt(2.0), 1e-4);
+
+  double initial = fieldEnergy(probe);
+  double maxEnergy = 0.0;
+  simulation->run(1);
+  for (int n=1; n<400; ++n) {
+    simulation->advance(1);
+    if (n % 20 == 0) maxEnergy = std::max(maxEnergy, fieldEnergy(probe));
+  }
+
+  // The energy oscillates between the initial value and about three times
+  // the initial value
+  BOOST_CHECK(std::isfinite(maxEnergy));
+  BOOST_CHECK_LT(maxEnergy/initial, 4.0);
+}
+
+/*
+ * A single mode of E_z with vanishing magnetic field oscillates as
+ * \f$\cos(n\theta)\f$ after \f$n\f$ steps. The phase advance per step follows
+ * from the ADI dispersion relation
+ *
+ * \f[
+ * \cos^2\frac{\theta}{2} = \frac{1}{(1 + u^2)(1 + v^2)}, \quad
+ * u = \frac{c\Delta t}{\Delta x}\sin\frac{k_x\Delta x}{2}, \quad
+ * v = \frac{c\Delta t}{\Delta y}\sin\frac{k_y\Delta y}{2}.
+ * \f]
+ *
+ * At five times the Courant limit, this differs from the exact phase advance
+ * \f$c|\mathbf{k}|\Delta t\f$ by more than ten percent.
+ */
+BOOST_FIXTURE_TEST_CASE( single_mode_dispersion, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_ADI>("FDTD_ADI",
+      "tests/electromagnetics/test_fdtd_adi_1.setup");
+  FieldProbe &probe = simulation->getProbe();
+
+  const Vector dx = simulation->getDx();
+  const double dt = simulation->getDt();
+  const double kx = 2.0*M_PI*2.0/(32.0*dx[0]);
+  const double ky = 2.0*M_PI/(32.0*dx[1]);
+  probe.fill(2, [&](const Vector &x) { return std::cos(kx*x[0] + ky*x[1]); });
+
+  double u = clight*dt/dx[0]*std::sin(0.5*kx*dx[0]);
+  double v = clight*dt/dx[1]*std::sin(0.5*ky*dx[1]);
+  double theta = 2.0*std::acos(1.0/std::sqrt((1.0 + u*u)*(1.0 + v*v)));
+  BOOST_CHECK_GT(std::fabs(theta - clight*std::sqrt(kx*kx + ky*ky)*dt), 0.1*theta);
+
+  const double tolerance = 1e4*std::numeric_limits<Real>::epsilon();
+  const int coords[3][2] = {{0, 0}, {5, 17}, {30, 9}};
+  std::vector<Index> points;
+  std::vector<double> initial;
+  for (const int *c: coords) {
+    Index pos;
+    pos[0] = c[0];
+    pos[1] = c[1];
+    points.push_back(pos);
+    initial.push_back(probe.get(2, pos));
+  }
+
+  int steps = 0;
+  simulation->run(0);
+  for (int n: {1, 7, 20}) {
+    simulation->advance(n - steps);
+    steps = n;
+    for (size_t p=0; p<points.size(); ++p) {
+      BOOST_CHECK_SMALL(probe.get(2, points[p]) - std::cos(n*theta)*initial[p], tolerance);
+    }
+  }
+}
+
+/*
+ * The solver does not provide stretch factors for CPML layers
+ */
+BOOST_FIXTURE_TEST_CASE( rejects_cpml, EMSimulationRunner )
+{
+  BOOST_CHECK_THROW(createSimulation<FDTD_ADI>("FDTD_ADI",
+      "tests/electromagnetics/test_fdtd_adi_2.setup",
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("CPMLBorder").setClass<CPMLBorder>();
+        blocks("FDTD_ADI").addChildren("CPMLBorder");
+      }), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,420 @@
+/*
+ * test_fdtd_kernels.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../../electromagnetics/fdtd/fdtd_kernels.hpp"
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+boost::random::mt19937 rGenKernels;
+
+const ptrdiff_t NCells = 37;
+const int NGhost = 2;
+
+/**
+ * The Yee staggering of component `c` of the electric or the magnetic field
+ */
+Stagger yeeStagger(size_t c, bool electric)
+{
+  Stagger stagger;
+  for (size_t d=0; d<DIMENSION; ++d) stagger[d] = ((d == c) == electric);
+  return stagger;
+}
+
+/**
+ * The stretch factors along dimension `d`
+ */
+Grid1d &kappaLine(FDTD_FieldContainer &c, size_t d)
+{
+#ifndef HUERTO_ONE_DIM
+  if (d == 1) return c.KappaDy;
+#endif
+#ifdef HUERTO_THREE_DIM
+  if (d == 2) return c.KappaDz;
+#endif
+  return c.KappaDx;
+}
+
+/**
+ * The fields E, B, and J of a container in this order
+ */
+std::vector<Field*> containerFields(FDTD_FieldContainer &c)
+{
+  return {&c.Ex, &c.Ey, &c.Ez, &c.Bx, &c.By, &c.Bz, &c.Jx, &c.Jy, &c.Jz};
+}
+
+struct FDTDKernelFixture
+{
+    FDTD_FieldContainer pointwise;
+    FDTD_FieldContainer rowwise;
+    FDTD_CoefficientLine<Real> coeffE, coeffB;
+    Range range;
+
+    /// The range including the ghost cells
+    Range fullRange;
+
+    FDTDKernelFixture()
+    {
+      Index lo, hi, innerLo, innerHi;
+      Vector domainLo, domainHi;
+      for (size_t d=0; d<DIMENSION; ++d)
+      {
+        lo[d] = -NGhost;
+        hi[d] = NCells - 1 + NGhost;
+        innerLo[d] = 0;
+        innerHi[d] = NCells - 1;
+        domainLo[d] = 0.0;
+        domainHi[d] = 1.0;
+      }
+      range = Range{innerLo, innerHi};
+      fullRange = Range{lo, hi};
+      Domain domain{domainLo, domainHi};
+
+      for (FDTD_FieldContainer *c : {&pointwise, &rowwise})
+      {
+        for (size_t d=0; d<DIMENSION; ++d) c->dx[d] = 1.0/NCells;
+        c->dt = 0.5/(clight*NCells);
+        std::vector<Field*> fields = containerFields(*c);
+        for (size_t f=0; f<9; ++f)
+        {
+          // The currents are staggered like the electric field
+          bool electric = (f < 3) || (f >= 6);
+          fields[f]->resize(lo, hi, domain, yeeStagger(f % 3, electric), NGhost);
+        }
+        for (size_t d=0; d<DIMENSION; ++d)
+        {
+          kappaLine(*c, d).resize(Grid1d::IndexType{lo[d]}, Grid1d::IndexType{hi[d]});
+        }
+      }
+
+      boost::random::uniform_real_distribution<> randValue(-1.0, 1.0);
+      boost::random::uniform_real_distribution<> randKappa(1.0, 5.0);
+
+      for (size_t d=0; d<DIMENSION; ++d)
+      {
+        for (ptrdiff_t i=lo[d]; i<=hi[d]; ++i)
+        {
+          double kappa = randKappa(rGenKernels);
+          kappaLine(pointwise, d)(i) = kappa;
+          kappaLine(rowwise, d)(i) = kappa;
+        }
+      }
+
+      updateCoefficients();
+
+      std::vector<Field*> pf = containerFields(pointwise);
+      std::vector<Field*> rf = containerFields(rowwise);
+      schnek::RangeCIterationPolicy<DIMENSION>::forEach(fullRange, [&](const Index &pos)
+      {
+        for (size_t f=0; f<9; ++f)
+        {
+          double val = randValue(rGenKernels);
+          (*pf[f])[pos] = val;
+          (*rf[f])[pos] = val;
+        }
+      });
+    }
+
+    /**
+     * Compute the coefficient lines of the row-wise kernels from the stretch
+     * factors of the innermost dimension
+     */
+    void updateCoefficients()
+    {
+      const size_t last = DIMENSION - 1;
+      coeffE = FDTD_CoefficientLine<Real>();
+      coeffB = FDTD_CoefficientLine<Real>();
+      coeffE.update(kappaLine(rowwise, last), clight2*rowwise.dt, rowwise.dx[last]);
+      coeffB.update(kappaLine(rowwise, last), rowwise.dt, rowwise.dx[last]);
+      rowwise.CoeffE = &coeffE;
+      rowwise.CoeffB = &coeffB;
+      pointwise.CoeffE = nullptr;
+      pointwise.CoeffB = nullptr;
+    }
+
+    /**
+     * Set the stretch factors to one and the currents to zero
+     */
+    void makeUniform()
+    {
+      for (FDTD_FieldContainer *c : {&pointwise, &rowwise})
+      {
+        for (size_t d=0; d<DIMENSION; ++d)
+        {
+          Grid1d &kappa = kappaLine(*c, d);
+          for (ptrdiff_t i=kappa.getLo(0); i<=kappa.getHi(0); ++i) kappa(i) = 1.0;
+        }
+        schnek::RangeCIterationPolicy<DIMENSION>::forEach(fullRange, [&](const Index &pos)
+        {
+          c->Jx[pos] = 0.0;
+          c->Jy[pos] = 0.0;
+          c->Jz[pos] = 0.0;
+        });
+      }
+      updateCoefficients();
+    }
+
+    /**
+     * Set the fields of the row-wise container from functions of the position
+     * along the first dimension
+     *
+     * The electric field is evaluated at integer positions and the magnetic
+     * field at half-integer positions along the first dimension.
+     */
+    void setProfile(std::function<Vector3d(double)> eProfile, std::function<Vector3d(double)> bProfile)
+    {
+      FDTD_FieldContainer &f = rowwise;
+      double h = f.dx[0];
+      schnek::RangeCIterationPolicy<DIMENSION>::forEach(fullRange, [&](const Index &pos)
+      {
+        Vector3d e = eProfile(pos[0]*h);
+        Vector3d b = bProfile((pos[0] + 0.5)*h);
+        f.Ex[pos] = e[0];
+        f.Ey[pos] = e[1];
+        f.Ez[pos] = e[2];
+        f.Bx[pos] = b[0];
+        f.By[pos] = b[1];
+        f.Bz[pos] = b[2];
+      });
+    }
+
+    void checkFields(const FDTD_FieldContainer &a, const FDTD_FieldContainer &b)
+    {
+      // The point-wise and row-wise kernels perform the same floating point operations
+      schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos)
+      {
+        BOOST_CHECK_EQUAL(a.Ex[pos], b.Ex[pos]);
+        BOOST_CHECK_EQUAL(a.Ey[pos], b.Ey[pos]);
+        BOOST_CHECK_EQUAL(a.Ez[pos], b.Ez[pos]);
+        BOOST_CHECK_EQUAL(a.Bx[pos], b.Bx[pos]);
+        BOOST_CHECK_EQUAL(a.By[pos], b.By[pos]);
+        BOOST_CHECK_EQUAL(a.Bz[pos], b.Bz[pos]);
+      });
+    }
+};
+
+// The single precision pulse is only followed along a line
+#ifdef HUERTO_ONE_DIM
+const ptrdiff_t NCellsPulse = 200;
+const int NStepsPulse = 200;
+
+/**
+ * A Gaussian pulse travelling through a uniform grid, stored with value type `T`
+ */
+template<typename T>
+struct FDTDPulse
+{
+    FDTD_FieldContainerT<T> fields;
+    FDTD_CoefficientLine<T> coeffE, coeffB;
+    Range range;
+
+    FDTDPulse()
+      : range{Index{0}, Index{NCellsPulse-1}}
+    {
+      Domain domain{Vector{0.0}, Vector{1.0}};
+      Index lo{-NGhost};
+      Index hi{NCellsPulse - 1 + NGhost};
+
+      fields.dx = Vector{1.0/NCellsPulse};
+      fields.dt = 0.5/(clight*NCellsPulse);
+      fields.Ex.resize(lo, hi, domain, Stagger{true}, NGhost);
+      fields.Ey.resize(lo, hi, domain, Stagger{false}, NGhost);
+      fields.Ez.resize(lo, hi, domain, Stagger{false}, NGhost);
+      fields.Bx.resize(lo, hi, domain, Stagger{false}, NGhost);
+      fields.By.resize(lo, hi, domain, Stagger{true}, NGhost);
+      fields.Bz.resize(lo, hi, domain, Stagger{true}, NGhost);
+      fields.Jx.resize(lo, hi, domain, Stagger{true}, NGhost);
+      fields.Jy.resize(lo, hi, domain, Stagger{false}, NGhost);
+      fields.Jz.resize(lo, hi, domain, Stagger{false}, NGhost);
+      fields.KappaDx.resize(Grid1d::IndexType{lo[0]}, Grid1d::IndexType{hi[0]});
+
+      for (ptrdiff_t i=lo[0]; i<=hi[0]; ++i)
+      {
+        double x = (i - 0.25*NCellsPulse)/(0.05*NCellsPulse);
+        double xb = (i + 0.5 - 0.25*NCellsPulse)/(0.05*NCellsPulse);
+        fields.KappaDx(i) = 1.0;
+        fields.Ex(i) = 0.0;
+        fields.Ey(i) = exp(-x*x);
+        fields.Ez(i) = 0.0;
+        fields.Bx(i) = 0.0;
+        fields.By(i) = 0.0;
+        fields.Bz(i) = exp(-xb*xb)/clight;
+        fields.Jx(i) = 0.0;
+        fields.Jy(i) = 0.0;
+        fields.Jz(i) = 0.0;
+      }
+
+      coeffE.update(fields.KappaDx, clight2*fields.dt, fields.dx[0]);
+      coeffB.update(fields.KappaDx, fields.dt, fields.dx[0]);
+      fields.CoeffE = &coeffE;
+      fields.CoeffB = &coeffB;
+    }
+
+    void run()
+    {
+      for (int s=0; s<NStepsPulse; ++s)
+      {
+        FDTD_StepBRows<true, false, T>{fields}(range);
+        FDTD_StepERows<true, false, T>{fields}(range);
+      }
+    }
+};
+#endif
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( fdtd_kernels )
+
+BOOST_FIXTURE_TEST_CASE( step_e_rows, FDTDKernelFixture )
+{
+  FDTD_StepE stepE{pointwise};
+  FieldIterator::forEach(range, stepE);
+
+  FDTD_StepERows<> stepERows{rowwise};
+  stepERows(range);
+
+  checkFields(pointwise, rowwise);
+}
+
+BOOST_FIXTURE_TEST_CASE( step_b_rows, FDTDKernelFixture )
+{
+  FDTD_StepB stepB{pointwise};
+  FieldIterator::forEach(range, stepB);
+
+  FDTD_StepBRows<> stepBRows{rowwise};
+  stepBRows(range);
+
+  checkFields(pointwise, rowwise);
+}
+
+BOOST_FIXTURE_TEST_CASE( step_e_rows_specialised, FDTDKernelFixture )
+{
+  makeUniform();
+  FDTD_StepE stepE{pointwise};
+  FieldIterator::forEach(range, stepE);
+
+  FDTD_StepERows<false, false> stepERows{rowwise};
+  stepERows(range);
+
+  checkFields(pointwise, rowwise);
+}
+
+BOOST_FIXTURE_TEST_CASE( step_b_rows_specialised, FDTDKernelFixture )
+{
+  makeUniform();
+  FDTD_StepB stepB{pointwise};
+  FieldIterator::forEach(range, stepB);
+
+  FDTD_StepBRows<false, false> stepBRows{rowwise};
+  stepBRows(range);
+
+  checkFields(pointwise, rowwise);
+}
+
+BOOST_FIXTURE_TEST_CASE( leapfrog_rows, FDTDKernelFixture )
+{
+  // Rounding differences would accumulate over several leapfrog steps
+  for (int s=0; s<10; ++s)
+  {
+    FDTD_StepB stepB{pointwise};
+    FieldIterator::forEach(range, stepB);
+    FDTD_StepE stepE{pointwise};
+    FieldIterator::forEach(range, stepE);
+
+    FDTD_StepBRows<>{rowwise}(range);
+    FDTD_StepERows<>{rowwise}(range);
+  }
+
+  checkFields(pointwise, rowwise);
+}
+
+BOOST_FIXTURE_TEST_CASE( step_e4_rows_cubic, FDTDKernelFixture )
+{
+  // The fourth-order difference is exact for cubic polynomials
+  makeUniform();
+  setProfile([](double) { return Vector3d(0.0, 0.0, 0.0); },
+             [](double x) { return Vector3d(0.0, x*x*x, 2.0*x*x - x); });
+
+  FDTD_FieldContainer &f = rowwise;
+  FDTD_StepE4Rows<false> stepE4Rows{f};
+  stepE4Rows(range);
+
+  const double tolerance = std::is_same<Real, float>::value ? 1e-5 : 1e-10;
+  double scale = clight2*f.dt;
+  double h = f.dx[0];
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos)
+  {
+    double x = pos[0]*h;
+    BOOST_CHECK_SMALL(f.Ey[pos]/scale + (4.0*x - 1.0), tolerance);
+    BOOST_CHECK_SMALL(f.Ez[pos]/scale - 3.0*x*x, tolerance);
+  });
+}
+
+BOOST_FIXTURE_TEST_CASE( step_b4_rows_cubic, FDTDKernelFixture )
+{
+  makeUniform();
+  setProfile([](double x) { return Vector3d(0.0, x*x*x - x, x*x); },
+             [](double) { return Vector3d(0.0, 0.0, 0.0); });
+
+  FDTD_FieldContainer &f = rowwise;
+  FDTD_StepB4Rows<false> stepB4Rows{f};
+  stepB4Rows(range);
+
+  const double tolerance = std::is_same<Real, float>::value ? 1e-5 : 1e-10;
+  double h = f.dx[0];
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos)
+  {
+    double x = (pos[0] + 0.5)*h;
+    BOOST_CHECK_SMALL(f.By[pos]/f.dt - 2.0*x, tolerance);
+    BOOST_CHECK_SMALL(f.Bz[pos]/f.dt + (3.0*x*x - 1.0), tolerance);
+  });
+}
+
+#ifdef HUERTO_ONE_DIM
+BOOST_AUTO_TEST_CASE( single_precision_pulse )
+{
+  FDTDPulse<double> pulseDouble;
+  FDTDPulse<float> pulseFloat;
+  pulseDouble.run();
+  pulseFloat.run();
+
+  double maxField = 0.0;
+  double maxError = 0.0;
+  ptrdiff_t peak = 0;
+  for (ptrdiff_t i=0; i<NCellsPulse; ++i)
+  {
+    double ey = pulseDouble.fields.Ey(i);
+    if (fabs(ey) > maxField)
+    {
+      maxField = fabs(ey);
+      peak = i;
+    }
+    maxError = std::max(maxError, fabs(ey - pulseFloat.fields.Ey(i)));
+    maxError = std::max(maxError, clight*fabs(pulseDouble.fields.Bz(i) - pulseFloat.fields.Bz(i)));
+  }
+
+  // The pulse has travelled half a cell per step
+  BOOST_CHECK_CLOSE(double(peak), 0.25*NCellsPulse + 0.5*NStepsPulse, 2.0);
+  BOOST_CHECK_SMALL(maxError/maxField, 1e-5);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
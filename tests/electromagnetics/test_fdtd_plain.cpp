@@ -0,0 +1,34 @@
+/*
+ * test_fdtd_plain.cpp
+ *
+ * Created on: 17 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( fdtd_plain )
+
+/*
+ * The fourth-order stencil is stable up to 6/7 of the Courant limit of the Yee
+ * scheme. A time step of 0.8 of the Yee limit is accepted, 0.9 is rejected.
+ */
+BOOST_FIXTURE_TEST_CASE( fourth_order_courant_limit, EMSimulationRunner )
+{
+  BOOST_CHECK_NO_THROW(createSimulation<FDTD_Plain>("FDTD_Plain",
+      "tests/electromagnetics/test_fdtd_plain_1.setup"));
+  BOOST_CHECK_THROW(createSimulation<FDTD_Plain>("FDTD_Plain",
+      "tests/electromagnetics/test_fdtd_plain_2.setup"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
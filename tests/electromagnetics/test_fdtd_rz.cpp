@@ -0,0 +1,175 @@
+/*
+ * test_fdtd_rz.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_rz.hpp"
+#include "../../electromagnetics/pml/cpml_border.hpp"
+
+#include <boost/math/special_functions/bessel.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef HUERTO_TWO_DIM
+
+namespace {
+
+// The components of the probe in the layout of FDTD_RZ
+const int EzComp = 0;
+const int ErComp = 1;
+const int EtComp = 2;
+const int BrComp = 4;
+const int BtComp = 5;
+
+/**
+ * The sum of the squares of all field components with B scaled by c
+ */
+double fieldEnergy(FieldProbe &probe)
+{
+  double energy = 0.0;
+  for (int c=0; c<3; ++c) energy += probe.sumSquares(c);
+  for (int c=3; c<6; ++c) energy += clight2*probe.sumSquares(c);
+  return energy;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( fdtd_rz )
+
+/*
+ * The standing wave Ez = J0(kr) cos(wt) of mode 0, where w is given by the
+ * dispersion relation of the Yee scheme. The field on the axis is updated from
+ * the flux of B_theta through the axis cell. The domain is large enough that
+ * the edge of the grid in r does not influence the axis during the test.
+ */
+BOOST_FIXTURE_TEST_CASE( bessel_mode_m0, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_RZ>("FDTD_RZ",
+      "tests/electromagnetics/test_fdtd_rz_1.setup");
+  FieldProbe &probe = simulation->getProbe();
+
+  const double dr = simulation->getDx()[1];
+  const double dt = simulation->getDt();
+  const double k = 2.0*M_PI/(40.0*dr);
+  const double omega = 2.0*std::asin(clight*dt/dr*std::sin(0.5*k*dr))/dt;
+  probe.fill(EzComp, [&](const Vector &x) { return boost::math::cyl_bessel_j(0, k*x[1]); });
+
+  // Two periods of the oscillation
+  const int steps = 160;
+  const ptrdiff_t offAxis = 10;
+  double maxError = 0.0;
+  simulation->run(1);
+  for (int n=1; n<=steps; ++n) {
+    if (n > 1) simulation->advance(1);
+    double phase = std::cos(omega*n*dt);
+    maxError = std::max(maxError, std::fabs(probe.get(EzComp, Index{0, 0}) - phase));
+    maxError = std::max(maxError, std::fabs(probe.get(EzComp, Index{0, offAxis})
+        - boost::math::cyl_bessel_j(0, k*offAxis*dr)*phase));
+    BOOST_CHECK_EQUAL(probe.get(EtComp, Index{0, 0}), 0.0);
+  }
+
+  // A wrong flux through the axis cell gives errors above 1e-2
+  BOOST_CHECK_SMALL(maxError, 3e-3);
+}
+
+/*
+ * A plane standing wave along z, polarised along a fixed transverse direction,
+ * is a solution of mode 1 that is uniform in r. On the axis, E_theta and B_r
+ * are updated from the limits of the terms proportional to 1/r. Starting from
+ * B = 0, the wave is an exact solution of the Yee scheme.
+ */
+BOOST_FIXTURE_TEST_CASE( plane_wave_m1, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_RZ>("FDTD_RZ",
+      "tests/electromagnetics/test_fdtd_rz_2.setup");
+  FieldProbe &probe = simulation->getProbe();
+
+  const double dz = simulation->getDx()[0];
+  const double dt = simulation->getDt();
+  const double k = 2.0*M_PI/(40.0*dz);
+  const double omega = 2.0*std::asin(clight*dt/dz*std::sin(0.5*k*dz))/dt;
+  probe.fill(ErComp, [&](const Vector &x) { return std::cos(k*x[0]); });
+  probe.fill(EtComp, [&](const Vector &x) { return -std::cos(k*x[0]); });
+
+  const int steps = 160;
+  const ptrdiff_t i = 5;
+  double maxError = 0.0;
+  simulation->run(1);
+  for (int n=1; n<=steps; ++n) {
+    if (n > 1) simulation->advance(1);
+    double expected = std::cos(k*i*dz)*std::cos(omega*n*dt);
+    for (ptrdiff_t j: {0, 3, 7}) {
+      maxError = std::max(maxError, std::fabs(probe.get(ErComp, Index{i, j}) - expected));
+      maxError = std::max(maxError, std::fabs(probe.get(EtComp, Index{i, j}) + expected));
+    }
+  }
+
+  BOOST_CHECK_SMALL(maxError, std::is_same<Real, float>::value ? 1e-4 : 1e-9);
+}
+
+/*
+ * A pulse of mode 1 leaves the domain through the absorbing layers at both ends
+ * in z. The CPMLBorder of this tree takes sigmaMax in units of 10c/dx, so the
+ * small value gives a damping of order one per time step. The layers must not
+ * stretch the radius, so kappaMax is 1. The pulse has passed through the layers
+ * after 230 steps. The remaining energy is the reflection from the layers, which
+ * is below 1e-6 of the pulse energy, and it must not grow afterwards.
+ */
+BOOST_FIXTURE_TEST_CASE( cpml_absorption, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_RZ>("FDTD_RZ",
+      "tests/electromagnetics/test_fdtd_rz_3.setup",
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("CPMLBorder").setClass<CPMLBorder>();
+        blocks("FDTD_RZ").addChildren("CPMLBorder");
+      });
+  FieldProbe &probe = simulation->getProbe();
+
+  const double dz = simulation->getDx()[0];
+  auto pulse = [&](const Vector &x) {
+    double u = (x[0] - 100.0*dz)/(8.0*dz);
+    return std::exp(-u*u);
+  };
+  probe.fill(ErComp, pulse);
+  probe.fill(EtComp, [&](const Vector &x) { return -pulse(x); });
+  probe.fill(BrComp, [&](const Vector &x) { return pulse(x)/clight; });
+  probe.fill(BtComp, [&](const Vector &x) { return pulse(x)/clight; });
+
+  double initial = fieldEnergy(probe);
+
+  simulation->run(300);
+  BOOST_CHECK_SMALL(fieldEnergy(probe)/initial, 1e-5);
+
+  simulation->advance(700);
+  BOOST_CHECK_SMALL(fieldEnergy(probe)/initial, 1e-5);
+}
+
+/*
+ * The default CPMLBorder stretches the cells of the layers, which is rejected
+ */
+BOOST_FIXTURE_TEST_CASE( cpml_rejects_stretch, EMSimulationRunner )
+{
+  BOOST_CHECK_THROW(createSimulation<FDTD_RZ>("FDTD_RZ",
+      "tests/electromagnetics/test_fdtd_rz_4.setup",
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("CPMLBorder").setClass<CPMLBorder>();
+        blocks("FDTD_RZ").addChildren("CPMLBorder");
+      }), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * test_fdtd_subgrid.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+#include "../../electromagnetics/fdtd/fdtd_subgrid.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#ifndef HUERTO_ONE_DIM
+namespace {
+
+/**
+ * The sum of the squares of all field components with B scaled by c
+ */
+double fieldEnergy(FieldProbe &probe)
+{
+  double energy = 0.0;
+  for (int c=0; c<3; ++c) energy += probe.sumSquares(c);
+  for (int c=3; c<6; ++c) energy += clight2*probe.sumSquares(c);
+  return energy;
+}
+
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( fdtd_subgrid )
+
+#ifdef HUERTO_ONE_DIM
+
+/*
+ * A Gaussian pulse passes through a refined patch. On two processes, the
+ * boundary between the local grids cuts through the patch. The cut must not
+ * reflect the pulse, so the reflection from the patch does not depend on the
+ * number of processes.
+ */
+BOOST_FIXTURE_TEST_CASE( pulse_reflection, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD",
+      "tests/electromagnetics/test_fdtd_subgrid_1.setup",
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("Subgrid").setClass<FDTD_Subgrid>();
+        blocks("FDTD").addChildren("Subgrid");
+      });
+  FieldProbe &probe = simulation->getProbe();
+
+  const double dx = simulation->getDx()[0];
+  auto pulse = [&](const Vector &x) {
+    double u = (x[0] - 40.0*dx)/(8.0*dx);
+    return std::exp(-u*u);
+  };
+  probe.fill(1, pulse);
+  probe.fill(5, [&](const Vector &x) { return pulse(x)/clight; });
+
+  // The pulse enters the patch at cell 80 and leaves it at cell 120. The part
+  // reflected at the entry and at a cut in the middle of the patch has
+  // travelled back to the region below cell 76 by then.
+  simulation->run(180);
+
+  double reflected = 0.0;
+  double peak = 0.0;
+  ptrdiff_t peakPos = 0;
+  for (ptrdiff_t i=0; i<simulation->getGridSize()[0]; ++i) {
+    double ey = probe.get(1, Index{i});
+    if (i < 76) reflected = std::max(reflected, std::fabs(ey));
+    if (ey > peak) {
+      peak = ey;
+      peakPos = i;
+    }
+  }
+
+  BOOST_CHECK_SMALL(reflected, 3e-3);
+  BOOST_CHECK_EQUAL(peakPos, 130);
+  BOOST_CHECK_CLOSE(peak, 1.0, 2.0);
+}
+#endif
+
+#ifndef HUERTO_ONE_DIM
+/*
+ * A pulse in a periodic domain crosses a refined patch many times. The coupling
+ * between the grids is not exactly energy conserving, but a late-time
+ * instability would let the energy grow without bound. The energy at the end
+ * of the run must not exceed the energy during the first crossings.
+ */
+BOOST_FIXTURE_TEST_CASE( long_run_stability, EMSimulationRunner )
+{
+#ifdef HUERTO_TWO_DIM
+  std::string setup = "tests/electromagnetics/test_fdtd_subgrid_2.setup";
+  const int steps = 4000;
+#endif
+#ifdef HUERTO_THREE_DIM
+  std::string setup = "tests/electromagnetics/test_fdtd_subgrid_3.setup";
+  const int steps = 2000;
+#endif
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD", setup,
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("Subgrid").setClass<FDTD_Subgrid>();
+        blocks("FDTD").addChildren("Subgrid");
+      });
+  FieldProbe &probe = simulation->getProbe();
+
+  // A pulse of E_z next to the patch
+  const Vector dx = simulation->getDx();
+  const Vector size = simulation->getSize();
+  probe.fill(2, [&](const Vector &x) {
+    double r2 = 0.0;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      double u = (x[d] - ((d == 0) ? 0.25 : 0.5)*size[d])/(2.0*dx[d]);
+      r2 += u*u;
+    }
+    return std::exp(-r2);
+  });
+
+  const double initial = fieldEnergy(probe);
+  double early = initial;
+  double late = 0.0;
+  simulation->run(0);
+  for (int n=0; n<steps; n += 50) {
+    simulation->advance(50);
+    double energy = fieldEnergy(probe);
+    BOOST_REQUIRE(std::isfinite(energy));
+    if (n < steps/4) early = std::max(early, energy);
+    if (n >= 3*steps/4) late = std::max(late, energy);
+  }
+
+  BOOST_CHECK_GT(late, 0.1*initial);
+  BOOST_CHECK_LT(late, 1.2*early);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,296 @@
+/*
+ * test_incsource.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/incident_source.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+#include "../../electromagnetics/source/beam.hpp"
+#include "../../electromagnetics/source/border.hpp"
+
+#include <mpi.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+
+#ifndef HUERTO_ONE_DIM
+
+namespace {
+
+typedef void RowSignature(Index, int, int, double, double*, double*, double*);
+
+static_assert(huerto_detail::incsource_has_h_field_row<GaussBeamSourceEFunc, RowSignature>::value,
+              "The beam source provides the batched evaluation of the magnetic field");
+static_assert(huerto_detail::incsource_has_e_field_row<GaussBeamSourceHFunc, RowSignature>::value,
+              "The beam source provides the batched evaluation of the electric field");
+static_assert(!huerto_detail::incsource_has_h_field_row<PointwiseSourceFunc<GaussBeamSourceEFunc>, RowSignature>::value,
+              "The wrapped source function hides the batched evaluation");
+static_assert(!huerto_detail::incsource_has_e_field_row<PointwiseSourceFunc<GaussBeamSourceHFunc>, RowSignature>::value,
+              "The wrapped source function hides the batched evaluation");
+
+/**
+ * Create and initialise an incident source current for an oblique Gaussian beam
+ */
+template<class Current>
+std::shared_ptr<Current> makeBeamCurrent(Direction dir, SimulationContext &context)
+{
+  const double kn = 2.0*PI/8e-6;
+  Vector size = context.getSize();
+  Vector k, origin;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    k[d] = 0.2*kn*d;
+    origin[d] = 0.4*size[d];
+  }
+  k[0] = kn;
+
+  std::shared_ptr<Current> current = std::make_shared<Current>(4, dir, context);
+  current->setParam(k, origin, Vector3d(0.0, 0.0, 1.0), 5e-6, 10e-6, 5e-6, 1.0, 0.5, 1);
+  current->init();
+  return current;
+}
+
+/**
+ * A sinusoidal field function that counts its evaluations
+ */
+class CountingFieldFunc
+{
+  public:
+    void initSourceFunc(Grid&, Grid&, Grid&) {}
+    void setTime(double) {}
+
+    /// The number of times #fieldFunc has been called
+    long calls = 0;
+  protected:
+    double fieldFunc(double pos, double F)
+    {
+      ++calls;
+      return F*std::sin(pos);
+    }
+};
+
+typedef GenericIncidentSourceESource<CountingFieldFunc> CountingESource;
+typedef GenericIncidentSourceHSource<CountingFieldFunc> CountingHSource;
+
+/**
+ * Create and initialise an incident source current for a plane wave
+ */
+template<class Current>
+std::shared_ptr<Current> makePlaneWaveCurrent(Direction dir, const Vector &k, SimulationContext &context)
+{
+  Vector origin;
+  for (size_t d=0; d<DIMENSION; ++d) origin[d] = 0.0;
+
+  std::shared_ptr<Current> current = std::make_shared<Current>(4, dir, context);
+  current->setGenericParam(k, Vector3d(0.3, 0.5, 1.0), origin, 1.0);
+  current->init();
+  return current;
+}
+
+/**
+ * The number of grid cells allocated for a grid
+ */
+long allocatedCells(Grid &grid)
+{
+  long cells = 1;
+  for (size_t d=0; d<DIMENSION; ++d) {
+    cells *= std::max<long>(grid.getHi(d) - grid.getLo(d) + 1, 0);
+  }
+  return cells;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( incident_source )
+
+/*
+ * The current sheets on all boundaries are filled once row by row and once
+ * point by point. Both paths evaluate the same staggered positions of the
+ * source function, so the sheets must be identical.
+ */
+BOOST_FIXTURE_TEST_CASE( row_matches_pointwise, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", incidentSourceSetup());
+  SimulationContext &context = *simulation;
+
+  typedef SheetProbe<IncidentSourceECurrent, GaussBeamSourceEFunc> ERowCurrent;
+  typedef SheetProbe<IncidentSourceECurrent, PointwiseSourceFunc<GaussBeamSourceEFunc>> EPointCurrent;
+  typedef SheetProbe<IncidentSourceHCurrent, GaussBeamSourceHFunc> HRowCurrent;
+  typedef SheetProbe<IncidentSourceHCurrent, PointwiseSourceFunc<GaussBeamSourceHFunc>> HPointCurrent;
+
+  simulation->run(10);
+  for (Direction dir: allDirections()) {
+    auto eRow = makeBeamCurrent<ERowCurrent>(dir, context);
+    auto ePoint = makeBeamCurrent<EPointCurrent>(dir, context);
+    auto hRow = makeBeamCurrent<HRowCurrent>(dir, context);
+    auto hPoint = makeBeamCurrent<HPointCurrent>(dir, context);
+
+    for (int n=0; n<3; ++n) {
+      simulation->advance(1);
+      eRow->stepScheme(context.getDt());
+      ePoint->stepScheme(context.getDt());
+      hRow->stepScheme(context.getDt());
+      hPoint->stepScheme(context.getDt());
+
+      BOOST_CHECK_EQUAL(sheetMismatches(*eRow, *ePoint), 0);
+      BOOST_CHECK_EQUAL(sheetMismatches(*hRow, *hPoint), 0);
+
+      if (eRow->isActive()) BOOST_CHECK_GT(sheetMaximum(*eRow), 0.0);
+      if (hRow->isActive()) BOOST_CHECK_GT(sheetMaximum(*hRow), 0.0);
+    }
+  }
+}
+
+/*
+ * At normal incidence, the phase of the plane wave is the same on the whole
+ * injection plane. The field function must only be evaluated once per component
+ * and time step, independently of the size of the sheet.
+ */
+BOOST_FIXTURE_TEST_CASE( plane_wave_normal_incidence_evaluations, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", incidentSourceSetup());
+  SimulationContext &context = *simulation;
+
+  typedef SheetProbe<IncidentSourceECurrent, CountingESource> ECurrent;
+  typedef SheetProbe<IncidentSourceHCurrent, CountingHSource> HCurrent;
+
+  const double kn = 2.0*PI/8e-6;
+  for (size_t dim=0; dim<DIMENSION; ++dim) {
+    Vector k;
+    for (size_t d=0; d<DIMENSION; ++d) k[d] = (d == dim) ? kn : 0.0;
+    Direction dir = static_cast<Direction>(2*dim);
+
+    auto eCurrent = makePlaneWaveCurrent<ECurrent>(dir, k, context);
+    auto hCurrent = makePlaneWaveCurrent<HCurrent>(dir, k, context);
+    if (!eCurrent->isActive()) continue;
+
+    for (int n=0; n<5; ++n) {
+      simulation->advance(1);
+      long eCalls = eCurrent->calls;
+      long hCalls = hCurrent->calls;
+      eCurrent->stepScheme(context.getDt());
+      hCurrent->stepScheme(context.getDt());
+      BOOST_CHECK_EQUAL(eCurrent->calls - eCalls, 3);
+      BOOST_CHECK_EQUAL(hCurrent->calls - hCalls, 3);
+    }
+    BOOST_CHECK_GT(sheetMaximum(*eCurrent), 0.0);
+    BOOST_CHECK_GT(sheetMaximum(*hCurrent), 0.0);
+  }
+}
+
+/*
+ * At oblique incidence, the phase varies along the rows and between the rows.
+ * The sheets filled row by row must be identical to those filled by the
+ * point-wise evaluation.
+ */
+BOOST_FIXTURE_TEST_CASE( plane_wave_oblique_matches_pointwise, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", incidentSourceSetup());
+  SimulationContext &context = *simulation;
+
+  typedef SheetProbe<IncidentSourceECurrent, CountingESource> ERowCurrent;
+  typedef SheetProbe<IncidentSourceECurrent, PointwiseSourceFunc<CountingESource>> EPointCurrent;
+  typedef SheetProbe<IncidentSourceHCurrent, CountingHSource> HRowCurrent;
+  typedef SheetProbe<IncidentSourceHCurrent, PointwiseSourceFunc<CountingHSource>> HPointCurrent;
+
+  const double kn = 2.0*PI/8e-6;
+  Vector k;
+  for (size_t d=0; d<DIMENSION; ++d) k[d] = kn*(1.0 - 0.3*d);
+
+  for (Direction dir: allDirections()) {
+    auto eRow = makePlaneWaveCurrent<ERowCurrent>(dir, k, context);
+    auto ePoint = makePlaneWaveCurrent<EPointCurrent>(dir, k, context);
+    auto hRow = makePlaneWaveCurrent<HRowCurrent>(dir, k, context);
+    auto hPoint = makePlaneWaveCurrent<HPointCurrent>(dir, k, context);
+
+    for (int n=0; n<3; ++n) {
+      simulation->advance(1);
+      eRow->stepScheme(context.getDt());
+      ePoint->stepScheme(context.getDt());
+      hRow->stepScheme(context.getDt());
+      hPoint->stepScheme(context.getDt());
+
+      BOOST_CHECK_EQUAL(sheetMismatches(*eRow, *ePoint), 0);
+      BOOST_CHECK_EQUAL(sheetMismatches(*hRow, *hPoint), 0);
+    }
+    if (eRow->isActive()) BOOST_CHECK_GT(sheetMaximum(*eRow), 0.0);
+    if (hRow->isActive()) BOOST_CHECK_GT(sheetMaximum(*hRow), 0.0);
+  }
+}
+
+/*
+ * Each process only allocates the part of a current sheet that lies inside its
+ * local domain. A process that the sheet does not reach must neither allocate
+ * the sheet nor evaluate the source function. On two processes, at least one of
+ * the sheets misses one of the processes.
+ */
+BOOST_FIXTURE_TEST_CASE( sheet_outside_local_domain, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", incidentSourceSetup());
+  SimulationContext &context = *simulation;
+  HuertoDecomposition &decomposition = context.getDecomposition();
+
+  Range local;
+  schnek::GridRegistration domain = decomposition.registerField(schnek::GridFactory<Grid>{});
+  decomposition.getGridContext({domain}).forEach([&](Range range, Grid &) { local = range; });
+
+  typedef SheetProbe<IncidentSourceECurrent, CountingESource> ECurrent;
+
+  const double kn = 2.0*PI/8e-6;
+  Vector k;
+  for (size_t d=0; d<DIMENSION; ++d) k[d] = kn*(1.0 - 0.3*d);
+
+  simulation->run(1);
+  int missed = 0;
+  for (Direction dir: allDirections()) {
+    auto current = makePlaneWaveCurrent<ECurrent>(dir, k, context);
+
+    Index blow, bhigh;
+    getBorderExtent(dir, 1, 4, blow, bhigh, false, context);
+    bool intersects = true;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      intersects = intersects && (blow[d] <= local.getHi(d)) && (bhigh[d] >= local.getLo(d));
+    }
+    BOOST_CHECK_EQUAL(current->isActive(), intersects);
+
+    long allocated = 0;
+    decomposition.getGridContext({current->getJx(), current->getJy(), current->getJz()}).forEach(
+        [&](Range, Grid &jx, Grid &jy, Grid &jz) {
+          allocated += allocatedCells(jx) + allocatedCells(jy) + allocatedCells(jz);
+        });
+
+    long calls = current->calls;
+    current->stepScheme(context.getDt());
+
+    if (intersects) {
+      BOOST_CHECK_GT(allocated, 0);
+      BOOST_CHECK_GT(current->calls, calls);
+      BOOST_CHECK_GT(sheetMaximum(*current), 0.0);
+    } else {
+      ++missed;
+      BOOST_CHECK_EQUAL(allocated, 0);
+      BOOST_CHECK_EQUAL(current->calls, calls);
+    }
+  }
+
+  int size;
+  int totalMissed;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Allreduce(&missed, &totalMissed, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  if (size > 1) BOOST_CHECK_GT(totalMissed, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * test_psatd.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/em_simulation.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/pml/cpml_border.hpp"
+#include "../../electromagnetics/spectral/psatd.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( psatd )
+
+/*
+ * A plane wave travels through the periodic domain at twice the Courant limit
+ * of the Yee scheme. The phase after half a period must not depend on the
+ * number of processes.
+ */
+BOOST_FIXTURE_TEST_CASE( plane_wave_phase, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<PSATD>("PSATD", "tests/electromagnetics/test_psatd_1.setup");
+  FieldProbe &probe = simulation->getProbe();
+
+  const double k = 2.0*PI/simulation->getSize()[0];
+  probe.fill(1, [&](const Vector &x) { return std::cos(k*x[0]); });
+  probe.fill(5, [&](const Vector &x) { return std::cos(k*x[0])/clight; });
+
+  // The wave moves by two cells in each step
+  const int steps = 16;
+  simulation->run(steps);
+
+  const double omega = clight*k;
+  const double time = steps*simulation->getDt();
+  double maxError = 0.0;
+  for (ptrdiff_t i=0; i<simulation->getGridSize()[0]; ++i) {
+    Index pos{i};
+    double x = simulation->getPosition(0, i);
+    double expected = std::cos(k*x - omega*time);
+    maxError = std::max(maxError, std::fabs(probe.get(1, pos) - expected));
+  }
+
+  BOOST_CHECK_SMALL(maxError, 5e-3);
+}
+
+/*
+ * Several modes up to about half the Nyquist wave number travel through the
+ * periodic domain for about three crossings. Each mode must move with the
+ * frequency of the modified wave number of the stencil, where the highest mode
+ * lags behind the exact plane wave by more than a radian.
+ *
+ * The magnetic field is started so that the initial half step lands exactly on
+ * the travelling wave, otherwise the high modes would also excite waves that
+ * travel backwards.
+ */
+BOOST_FIXTURE_TEST_CASE( multi_mode_dispersion, EMSimulationRunner )
+{
+  pTestEMSimulation simulation = createSimulation<PSATD>("PSATD", "tests/electromagnetics/test_psatd_1.setup");
+  FieldProbe &probe = simulation->getProbe();
+
+  const int modes[] = {1, 5, 11, 17};
+  const double amplitude = 0.25;
+  const double dx = simulation->getDx()[0];
+  const double dt = simulation->getDt();
+  const double length = simulation->getSize()[0];
+
+  probe.fill(1, [&](const Vector &x) {
+    double e = 0.0;
+    for (int m: modes) e += amplitude*std::cos(2.0*PI*m*x[0]/length);
+    return e;
+  });
+  probe.fill(5, [&](const Vector &x) {
+    double b = 0.0;
+    for (int m: modes) {
+      double k = 2.0*PI*m/length;
+      double omega = clight*PSATD::modifiedWaveNumber(8, k, dx);
+      b += amplitude*(std::cos(k*x[0])*std::cos(0.5*omega*dt)
+          + std::sin(k*x[0])*(std::sin(0.5*omega*dt) - 2.0*std::sin(0.25*omega*dt)))/clight;
+    }
+    return b;
+  });
+
+  const int steps = 100;
+  simulation->run(steps);
+
+  const double time = steps*dt;
+  double maxError = 0.0;
+  for (ptrdiff_t i=0; i<simulation->getGridSize()[0]; ++i) {
+    Index pos{i};
+    double x = simulation->getPosition(0, i);
+    double expected = 0.0;
+    for (int m: modes) {
+      double k = 2.0*PI*m/length;
+      double omega = clight*PSATD::modifiedWaveNumber(8, k, dx);
+      expected += amplitude*std::cos(k*x - omega*time);
+    }
+    maxError = std::max(maxError, std::fabs(probe.get(1, pos) - expected));
+  }
+
+  BOOST_CHECK_SMALL(maxError, 3e-2);
+}
+
+/*
+ * The CPML layers cannot absorb the fields of the spectral solver
+ */
+BOOST_FIXTURE_TEST_CASE( rejects_cpml, EMSimulationRunner )
+{
+  BOOST_CHECK_THROW(createSimulation<PSATD>("PSATD",
+      "tests/electromagnetics/test_psatd_2.setup",
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("CPMLBorder").setClass<CPMLBorder>();
+        blocks("PSATD").addChildren("CPMLBorder");
+      }), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,246 @@
+/*
+ * test_waveform.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../fixtures/incident_source.hpp"
+#include "../../constants.hpp"
+#include "../../electromagnetics/fdtd/fdtd_plain.hpp"
+#include "../../electromagnetics/source/waveform.hpp"
+#include "../../maths/vector/vector.hpp"
+
+#include <mpi.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#ifndef HUERTO_ONE_DIM
+
+namespace {
+
+const int NRecords = 200;
+
+/**
+ * The value of the test waveform at record `n` and column `col`
+ *
+ * The value is linear in both arguments, so that the linear interpolation of
+ * the source reproduces it exactly between the samples.
+ */
+double recordValue(double n, double col)
+{
+  return (1.0 + 0.25*n)*(1.0 + 0.5*col);
+}
+
+/**
+ * Write the test waveform with `columns` values per record
+ */
+void writeWaveform(const std::string &fileName, int columns)
+{
+  std::ofstream out(fileName, std::ios::binary);
+  for (int n=0; n<NRecords; ++n) {
+    for (int c=0; c<columns; ++c) {
+      double value = recordValue(n, c);
+      out.write(reinterpret_cast<const char*>(&value), sizeof(double));
+    }
+  }
+}
+
+/**
+ * The field of the waveform source at a grid index, calculated from the
+ * analytic form of the record
+ *
+ * The electric field is staggered along its own component, the magnetic field
+ * along the other axes.
+ */
+Vector3d analyticField(SimulationContext &context,
+                       const WaveformParameters &param,
+                       const Vector3d &F,
+                       bool electric,
+                       const Index &pos,
+                       double time)
+{
+  double speed = clight/std::sqrt(param.eps);
+  Vector axis = param.k / norm(param.k);
+
+  Vector3d f(0.0, 0.0, 0.0);
+  for (int c=0; c<3; ++c) {
+    if (F[c] == 0.0) continue;
+
+    double s = 0.0;
+    double x2 = 0.0;
+    for (size_t d=0; d<DIMENSION; ++d) {
+      double shift = ((int(d) == c) == electric) ? 0.5 : 0.0;
+      double x = context.getPosition(d, pos[d] + shift) - param.origin[d];
+      s += axis[d]*x;
+      x2 += x*x;
+    }
+    double r = std::sqrt(std::max(x2 - s*s, 0.0));
+
+    // The sample index of the retarded time and the column of the distance
+    double u = (time - s/speed - param.start)/param.interval;
+    double v = (param.columns > 1) ? r/param.dr : 0.0;
+    if (u < 0.0 || u > NRecords - 1 || v > param.columns - 1) continue;
+
+    f[c] = F[c]*recordValue(u, v);
+  }
+  return f;
+}
+
+/**
+ * A pulse record with one column
+ */
+void writePulse(const std::string &fileName)
+{
+  std::ofstream out(fileName, std::ios::binary);
+  for (int n=0; n<NRecords; ++n) {
+    double phase = (n - 60.0)/15.0;
+    double value = std::exp(-phase*phase)*std::sin(0.5*n);
+    out.write(reinterpret_cast<const char*>(&value), sizeof(double));
+  }
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( electromagnetics )
+
+BOOST_AUTO_TEST_SUITE( waveform_source )
+
+/*
+ * The current sheets on all boundaries are filled from a record that is linear
+ * in time and in the transverse distance. The interpolated values at the
+ * retarded times must agree with the analytic form of the record, with one
+ * column and with several columns. Parts of the sheets lie before the first
+ * sample or beyond the last column, where the field vanishes. The check is
+ * repeated after the window has moved along the normal of the sheet.
+ */
+BOOST_FIXTURE_TEST_CASE( retarded_time_interpolation, EMSimulationRunner )
+{
+  const std::string fileName = "test_waveform_source.bin";
+  const double tolerance = 10*std::numeric_limits<Real>::epsilon();
+
+  typedef SheetProbe<IncidentSourceECurrent, WaveformSourceEFunc> ECurrent;
+  typedef SheetProbe<IncidentSourceHCurrent, WaveformSourceHFunc> HCurrent;
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  for (int columns: {1, 3}) {
+    if (rank == 0) writeWaveform(fileName, columns);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    for (Direction dir: allDirections()) {
+      pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", incidentSourceSetup());
+      SimulationContext &context = *simulation;
+      const double dt = context.getDt();
+
+      WaveformParameters param;
+      Vector size = context.getSize();
+      for (size_t d=0; d<DIMENSION; ++d) {
+        param.k[d] = 0.0;
+        param.origin[d] = 0.5*size[d];
+      }
+      param.k[0] = std::cos(0.3);
+      param.k[1] = std::sin(0.3);
+#ifdef HUERTO_THREE_DIM
+      param.k[2] = 0.2;
+#endif
+      param.eps = 1.0;
+      param.file = fileName;
+      param.columns = columns;
+      param.interval = 0.7*dt;
+      param.start = 20.0*dt;
+      param.dr = 8e-6;
+      param.window = 16;
+
+      const Vector3d F(0.2, -0.5, 1.0);
+
+      std::shared_ptr<ECurrent> eCurrent = std::make_shared<ECurrent>(4, dir, context);
+      std::shared_ptr<HCurrent> hCurrent = std::make_shared<HCurrent>(4, dir, context);
+      eCurrent->setParam(param, F, false);
+      hCurrent->setParam(param, F, true);
+      eCurrent->init();
+      hCurrent->init();
+
+      int dim = static_cast<int>(dir)/2;
+      simulation->run(40);
+      for (int shift: {0, 2}) {
+        while (context.getWindowShift()[dim] < shift) context.shiftWindow(dim);
+        simulation->advance(10);
+
+        eCurrent->stepScheme(dt);
+        hCurrent->stepScheme(dt);
+
+        double maxValue;
+        double error = sheetDeviation(*eCurrent, [&](const Index &pos, double time) {
+          return analyticField(context, param, F, false, pos, time - 0.5*dt);
+        }, context.getTime(), maxValue);
+        if (eCurrent->isActive()) BOOST_CHECK_GT(maxValue, 0.0);
+        BOOST_CHECK_LE(error, tolerance*maxValue);
+
+        error = sheetDeviation(*hCurrent, [&](const Index &pos, double time) {
+          return analyticField(context, param, F, true, pos, time);
+        }, context.getTime(), maxValue);
+        if (hCurrent->isActive()) BOOST_CHECK_GT(maxValue, 0.0);
+        BOOST_CHECK_LE(error, tolerance*maxValue);
+      }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::remove(fileName.c_str());
+  }
+}
+
+/*
+ * A WaveformSource block inside the field solver injects a pulse into the
+ * simulation
+ */
+BOOST_FIXTURE_TEST_CASE( source_block, EMSimulationRunner )
+{
+  const std::string fileName = "test_waveform_pulse.bin";
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) writePulse(fileName);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+#ifdef HUERTO_TWO_DIM
+  std::string setup = "tests/electromagnetics/test_waveform_2d.setup";
+#endif
+#ifdef HUERTO_THREE_DIM
+  std::string setup = "tests/electromagnetics/test_waveform_3d.setup";
+#endif
+
+  pTestEMSimulation simulation = createSimulation<FDTD_Plain>("FDTD_Plain", setup,
+      [](schnek::BlockClasses &blocks) {
+        blocks.registerBlock("WaveformSource").setClass<WaveformSource>();
+        blocks("FDTD_Plain").addChildren("WaveformSource");
+      });
+  FieldProbe &probe = simulation->getProbe();
+
+  BOOST_CHECK_EQUAL(probe.sumSquares(1), 0.0);
+  simulation->run(60);
+
+  double ey = probe.sumSquares(1);
+  double bz = probe.sumSquares(5);
+  BOOST_CHECK(std::isfinite(ey));
+  BOOST_CHECK_GT(ey, 0.0);
+  BOOST_CHECK_GT(bz, 0.0);
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0) std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
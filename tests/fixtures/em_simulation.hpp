@@ -0,0 +1,266 @@
+/*
+ * em_simulation.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_TESTS_FIXTURES_EM_SIMULATION_HPP_
+#define HUERTO_TESTS_FIXTURES_EM_SIMULATION_HPP_
+
+#include "../../constants.hpp"
+#include "../../electromagnetics/em_fields.hpp"
+#include "../../electromagnetics/fieldsolver.hpp"
+#include "../../simulation/simulation_context.hpp"
+#include "../../types.hpp"
+
+#include <mpi.h>
+
+#include <schnek/variables/block.hpp>
+#include <schnek/variables/blockclasses.hpp>
+#include <schnek/variables/blockcontainer.hpp>
+#include <schnek/parser/parser.hpp>
+#include <schnek/parser/parsertoken.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <string>
+
+/**
+ * Read and write the electromagnetic fields of a test simulation
+ *
+ * The values are accessed through the global grid index on all processes.
+ */
+class FieldProbe : public schnek::ChildBlock<FieldProbe>,
+                   public SimulationEntity
+{
+  private:
+    schnek::GridRegistration fields[6];
+
+    const Stagger *staggers[6] = {
+      &exStaggerYee, &eyStaggerYee, &ezStaggerYee,
+      &bxStaggerYee, &byStaggerYee, &bzStaggerYee
+    };
+  public:
+    FieldProbe(schnek::pBlock parent = schnek::pBlock()) : schnek::ChildBlock<FieldProbe>(parent)
+    {}
+
+    void init() override
+    {
+      SimulationEntity::init(this);
+      const char *names[6] = {"Ex", "Ey", "Ez", "Bx", "By", "Bz"};
+      for (int c=0; c<6; ++c) retrieveData(names[c], fields[c]);
+    }
+
+    /**
+     * Set a field component, 0-2 for E and 3-5 for B, from a function of the
+     * physical position of each grid point, including the ghost cells
+     */
+    void fill(int component, std::function<double(const Vector&)> func)
+    {
+      SimulationContext &context = getContext();
+      const Stagger &stagger = *staggers[component];
+      context.getDecomposition().getGridContext({fields[component]}).forEach([&](Range /* range */, Field &field) {
+        schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{field.getLo(), field.getHi()}, [&](const Index &pos) {
+          Vector x;
+          for (size_t d=0; d<DIMENSION; ++d) {
+            x[d] = context.getPosition(d, pos[d] + (stagger[d] ? 0.5 : 0.0));
+          }
+          field[pos] = func(x);
+        });
+      });
+    }
+
+    /**
+     * Get the value of a field component at a global grid index
+     *
+     * This is a collective operation.
+     */
+    double get(int component, const Index &index)
+    {
+      double local = 0.0;
+      getContext().getDecomposition().getGridContext({fields[component]}).forEach([&](Range range, Field &field) {
+        bool inside = true;
+        for (size_t d=0; d<DIMENSION; ++d) {
+          inside = inside && (index[d] >= range.getLo(d)) && (index[d] <= range.getHi(d));
+        }
+        if (inside) local = field[index];
+      });
+      double value;
+      MPI_Allreduce(&local, &value, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      return value;
+    }
+
+    /**
+     * The sum of the squares of a field component over the inner cells of the
+     * global domain
+     *
+     * This is a collective operation.
+     */
+    double sumSquares(int component)
+    {
+      double local = 0.0;
+      getContext().getDecomposition().getGridContext({fields[component]}).forEach([&](Range range, Field &field) {
+        schnek::RangeCIterationPolicy<DIMENSION>::forEach(range, [&](const Index &pos) {
+          local += double(field[pos])*double(field[pos]);
+        });
+      });
+      double value;
+      MPI_Allreduce(&local, &value, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      return value;
+    }
+};
+
+typedef std::shared_ptr<FieldProbe> pFieldProbe;
+
+/**
+ * A minimal periodic simulation of the electromagnetic fields
+ *
+ * The block holds the EMFields, the field solver under test, and a FieldProbe.
+ * The time step is `cflFactor` times the smallest grid spacing divided by the
+ * speed of light.
+ */
+class TestEMSimulation : public schnek::Block,
+                         public SimulationContext,
+                         public schnek::BlockContainer<EMFields>,
+                         public schnek::BlockContainer<FieldSolver>,
+                         public schnek::BlockContainer<FieldProbe>
+{
+  private:
+    double cflFactor;
+  protected:
+    void initParameters(schnek::BlockParameters &blockPars) override
+    {
+      SimulationContext::initParameters(blockPars);
+      initConstantParameters(blockPars);
+      blockPars.addArrayParameter("N", gridSize, 64);
+      blockPars.addArrayParameter("L", size, 1.0);
+      blockPars.addParameter("cflFactor", &cflFactor, 0.5);
+    }
+
+    void preInit() override
+    {
+      Index lo, hi;
+      for (size_t d=0; d<DIMENSION; ++d) {
+        lo[d] = 0;
+        hi[d] = gridSize[d] - 1;
+        dx[d] = size[d]/gridSize[d];
+      }
+      decomposition->setGlobalRange(Range{lo, hi});
+      decomposition->init();
+
+      double minDx = dx[0];
+      for (size_t d=1; d<DIMENSION; ++d) minDx = std::min(minDx, dx[d]);
+      dt = cflFactor*minDx/clight;
+      time = 0.0;
+      timeStep = 0;
+    }
+  public:
+    TestEMSimulation(schnek::pBlock parent = schnek::pBlock()) : schnek::Block(parent)
+    {
+      // The fields register themselves with the decomposition before preInit
+      decomposition = std::make_shared<HuertoDecomposition>();
+    }
+
+    /**
+     * Initialise the solvers and perform `steps` time steps
+     */
+    void run(int steps)
+    {
+      for (pFieldSolver solver: schnek::BlockContainer<FieldSolver>::childBlocks()) {
+        solver->stepSchemeInit(dt);
+      }
+      advance(steps);
+    }
+
+    /**
+     * Perform `steps` further time steps without initialising the solvers
+     */
+    void advance(int steps)
+    {
+      for (int n=0; n<steps; ++n) {
+        for (pFieldSolver solver: schnek::BlockContainer<FieldSolver>::childBlocks()) {
+          solver->stepScheme(dt);
+        }
+        time += dt;
+        ++timeStep;
+      }
+    }
+
+    /**
+     * The first probe of the simulation
+     */
+    FieldProbe &getProbe()
+    {
+      return *schnek::BlockContainer<FieldProbe>::childBlocks().front();
+    }
+};
+
+typedef std::shared_ptr<TestEMSimulation> pTestEMSimulation;
+
+/**
+ * Create a TestEMSimulation from a setup file
+ *
+ * The field solver of the class `SolverType` is registered under the name
+ * `solverName`. Further blocks can be registered through `registerBlocks`.
+ */
+class EMSimulationRunner
+{
+  protected:
+    template<class SolverType>
+    pTestEMSimulation createSimulation(std::string solverName,
+                                       std::string fileName,
+                                       std::function<void(schnek::BlockClasses&)> registerBlocks
+                                           = std::function<void(schnek::BlockClasses&)>())
+    {
+      pTestEMSimulation simulation;
+      try
+      {
+        schnek::BlockClasses blocks;
+
+        blocks.registerBlock("Simulation").setClass<TestEMSimulation>();
+        blocks.registerBlock("EMFields").setClass<EMFields>();
+        blocks.registerBlock(solverName).setClass<SolverType>();
+        blocks.registerBlock("FieldProbe").setClass<FieldProbe>();
+
+        blocks("Simulation").addChildren("EMFields")(solverName)("FieldProbe");
+
+        if (registerBlocks) registerBlocks(blocks);
+
+        std::ifstream in(fileName);
+        BOOST_REQUIRE(in);
+
+        schnek::Parser P("Simulation", "Simulation", blocks);
+
+        schnek::pBlock application = P.parse(in);
+        application->initAll();
+
+        simulation = std::dynamic_pointer_cast<TestEMSimulation>(application);
+        BOOST_REQUIRE(!!simulation);
+      }
+      catch (schnek::ParserError &e)
+      {
+        BOOST_FAIL("EMSimulationRunner: Parse error in " + e.getFilename() + " at line "
+            + boost::lexical_cast<std::string>(e.getLine()) + ": " + e.message);
+      }
+      catch (schnek::VariableNotInitialisedException &e)
+      {
+        BOOST_FAIL("EMSimulationRunner: Variable was not initialised: " + e.getVarName());
+      }
+      catch (schnek::EvaluationException &e)
+      {
+        BOOST_FAIL("EMSimulationRunner: Error in evaluation: " + e.getMessage());
+      }
+      catch (schnek::VariableNotFoundException &e)
+      {
+        BOOST_FAIL("EMSimulationRunner: Error: " + e.getMessage());
+      }
+
+      return simulation;
+    }
+};
+
+#endif /* HUERTO_TESTS_FIXTURES_EM_SIMULATION_HPP_ */
@@ -0,0 +1,177 @@
+/*
+ * incident_source.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_TESTS_FIXTURES_INCIDENT_SOURCE_HPP_
+#define HUERTO_TESTS_FIXTURES_INCIDENT_SOURCE_HPP_
+
+#include "em_simulation.hpp"
+#include "../../electromagnetics/source/incsource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * The setup file of a small simulation that provides the context for the
+ * incident sources under test
+ */
+inline std::string incidentSourceSetup()
+{
+#ifdef HUERTO_TWO_DIM
+  return "tests/electromagnetics/test_incident_source_2d.setup";
+#endif
+#ifdef HUERTO_THREE_DIM
+  return "tests/electromagnetics/test_incident_source_3d.setup";
+#endif
+}
+
+/**
+ * All the boundaries of the simulation domain
+ */
+inline std::vector<Direction> allDirections()
+{
+#ifdef HUERTO_TWO_DIM
+  return {west, east, south, north};
+#endif
+#ifdef HUERTO_THREE_DIM
+  return {west, east, south, north, down, up};
+#endif
+}
+
+/**
+ * A source function that hides the batched evaluation of `SourceFunc`
+ *
+ * The current sheet of an incident source using this function is filled point
+ * by point, even if `SourceFunc` provides a row evaluation.
+ */
+template<class SourceFunc>
+class PointwiseSourceFunc : public SourceFunc
+{
+  public:
+    PointwiseSourceFunc(Direction dir, SimulationContext &context)
+      : SourceFunc(dir, context) {}
+  private:
+    // Never defined; the signatures do not match the row evaluation, so that
+    // IncidentSourceECurrent and IncidentSourceHCurrent do not detect it
+    void getHFieldRow();
+    void getEFieldRow();
+};
+
+/**
+ * An incident source current that exposes its current sheet
+ *
+ * `CurrentType` is either IncidentSourceECurrent or IncidentSourceHCurrent.
+ */
+template<template<class> class CurrentType, class SourceFunc>
+class SheetProbe : public CurrentType<SourceFunc>
+{
+  public:
+    SheetProbe(int distance, Direction dir, SimulationContext &context)
+      : CurrentType<SourceFunc>(distance, dir, context) {}
+
+    /**
+     * True if the current sheet intersects the local domain
+     */
+    bool isActive() { return this->active; }
+
+    /**
+     * The local grid of the transverse current component `i`, 0 or 1
+     */
+    Grid &getSheet(int i) { return this->JT[i]; }
+
+    /**
+     * The grid index, in the frame of the initial window, at which the source
+     * function is evaluated for the sheet index `ind`
+     */
+    Index getSourceIndex(const Index &ind)
+    {
+      const Index &shift = this->IncidentSourceCurrent::context.getWindowShift();
+      Index pos;
+      for (size_t d=0; d<DIMENSION; ++d) pos[d] = ind[d] + shift[d];
+      if (!this->reverse) pos[this->dim] += this->isH ? 1 : -1;
+      return pos;
+    }
+
+    /**
+     * The value of the transverse current component `i` for the field `F` of
+     * the source function
+     */
+    double getSheetValue(int i, const Vector3d &F)
+    {
+      double factor = this->reverse ? 1.0 : -1.0;
+      return (i == 0) ? -factor*F[this->transverse2]/this->dN : factor*F[this->transverse1]/this->dN;
+    }
+};
+
+/**
+ * The largest deviation of the current sheet of `probe` from the values
+ * calculated from `field`
+ *
+ * `field` returns the field of the source function at a grid index and a time.
+ * The largest absolute value on the sheet is returned in `maxValue`. Only the
+ * local part of the sheet is checked.
+ */
+template<class Probe, class FieldFunc>
+double sheetDeviation(Probe &probe, FieldFunc field, double time, double &maxValue)
+{
+  double maxError = 0.0;
+  maxValue = 0.0;
+  if (!probe.isActive()) return maxError;
+
+  Grid &J0 = probe.getSheet(0);
+  Grid &J1 = probe.getSheet(1);
+  schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{J0.getLo(), J0.getHi()}, [&](const Index &ind) {
+    Vector3d F = field(probe.getSourceIndex(ind), time);
+    for (int i=0; i<2; ++i) {
+      double value = (i == 0) ? J0[ind] : J1[ind];
+      maxError = std::max(maxError, std::fabs(value - probe.getSheetValue(i, F)));
+      maxValue = std::max(maxValue, std::fabs(value));
+    }
+  });
+  return maxError;
+}
+
+/**
+ * The largest absolute value on the local part of the current sheet of `probe`
+ */
+template<class Probe>
+double sheetMaximum(Probe &probe)
+{
+  double maxValue = 0.0;
+  if (!probe.isActive()) return maxValue;
+
+  for (int i=0; i<2; ++i) {
+    Grid &J = probe.getSheet(i);
+    schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{J.getLo(), J.getHi()}, [&](const Index &ind) {
+      maxValue = std::max(maxValue, std::fabs(double(J[ind])));
+    });
+  }
+  return maxValue;
+}
+
+/**
+ * The number of values that differ between the current sheets of two probes
+ * on the same boundary
+ */
+template<class ProbeA, class ProbeB>
+int sheetMismatches(ProbeA &a, ProbeB &b)
+{
+  int mismatches = 0;
+  if (a.isActive() != b.isActive()) return 1;
+  if (!a.isActive()) return 0;
+
+  for (int i=0; i<2; ++i) {
+    Grid &A = a.getSheet(i);
+    Grid &B = b.getSheet(i);
+    schnek::RangeCIterationPolicy<DIMENSION>::forEach(Range{A.getLo(), A.getHi()}, [&](const Index &ind) {
+      if (A[ind] != B[ind]) ++mismatches;
+    });
+  }
+  return mismatches;
+}
+
+#endif /* HUERTO_TESTS_FIXTURES_INCIDENT_SOURCE_HPP_ */
@@ -0,0 +1,63 @@
+/*
+ * test_waveform_stream.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "../../io/waveform_stream.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE( io )
+
+BOOST_AUTO_TEST_SUITE( waveform_stream )
+
+BOOST_AUTO_TEST_CASE( sliding_window )
+{
+  const size_t columns = 3;
+  const size_t records = 5000;
+  std::string fileName = "test_waveform_stream.bin";
+
+  {
+    std::ofstream out(fileName, std::ios::binary);
+    for (size_t n=0; n<records; ++n) {
+      for (size_t c=0; c<columns; ++c) {
+        double value = 10.0*n + c;
+        out.write(reinterpret_cast<const char*>(&value), sizeof(double));
+      }
+    }
+  }
+
+  WaveformStream stream;
+  stream.open(fileName, columns, 100);
+  BOOST_CHECK_EQUAL(stream.getRecords(), records);
+  BOOST_CHECK_EQUAL(stream.getColumns(), columns);
+
+  // Move forward, jump back, and read up to the end of the file
+  for (size_t first: {0, 7, 98, 350, 351, 20, 4990}) {
+    size_t last = std::min(first + 9, records - 1);
+    stream.require(first, last);
+    for (size_t n=first; n<=last; ++n) {
+      const double *record = stream.getRecord(n);
+      for (size_t c=0; c<columns; ++c) {
+        BOOST_CHECK_EQUAL(record[c], 10.0*n + c);
+      }
+    }
+  }
+
+  BOOST_CHECK_THROW(stream.require(records - 1, records), std::runtime_error);
+
+  stream.close();
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
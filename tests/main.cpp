@@ -6,10 +6,42 @@
  */
 
 #define BOOST_TEST_MODULE "Unit Tests for Huerto"
+
+#include "../types.hpp"
+
+#include <mpi.h>
+
 #include <boost/test/included/unit_test.hpp>
 
 #include <cmath>
 
+/**
+ * Initialise MPI for the tests that run a decomposed simulation
+ */
+struct MpiEnvironment
+{
+    MpiEnvironment()
+    {
+      int initialised;
+      MPI_Initialized(&initialised);
+      if (!initialised) MPI_Init(&boost::unit_test::framework::master_test_suite().argc,
+                                 &boost::unit_test::framework::master_test_suite().argv);
+    }
+
+    ~MpiEnvironment()
+    {
+#ifdef HUERTO_USE_KOKKOS
+      // Kokkos must be shut down while MPI is still available
+      huertoFinalizeKokkos();
+#endif
+      int finalised;
+      MPI_Finalized(&finalised);
+      if (!finalised) MPI_Finalize();
+    }
+};
+
+BOOST_GLOBAL_FIXTURE( MpiEnvironment );
+
 bool is_equal(double a, double b)
 {
   return ((a==0.0) && (b==0.0)) ||
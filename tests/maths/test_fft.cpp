@@ -0,0 +1,94 @@
+/*
+ * test_fft.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "../../maths/fft/fft.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<FFT::Complex> testData(size_t n)
+{
+  std::vector<FFT::Complex> data(n);
+  for (size_t j=0; j<n; ++j) {
+    data[j] = FFT::Complex(std::sin(1.3*j + 0.2), std::cos(0.7*j*j));
+  }
+  return data;
+}
+
+std::vector<FFT::Complex> directTransform(const std::vector<FFT::Complex> &data)
+{
+  size_t n = data.size();
+  std::vector<FFT::Complex> result(n);
+  for (size_t k=0; k<n; ++k) {
+    for (size_t j=0; j<n; ++j) {
+      result[k] += data[j]*std::polar(1.0, -2.0*M_PI*double((j*k) % n)/double(n));
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE( maths )
+
+BOOST_AUTO_TEST_SUITE( fft )
+
+BOOST_AUTO_TEST_CASE( forward_matches_direct_transform )
+{
+  for (size_t n: {1, 2, 3, 5, 8, 12, 16, 17, 30, 64}) {
+    std::vector<FFT::Complex> data = testData(n);
+    std::vector<FFT::Complex> expected = directTransform(data);
+
+    FFT fft(n);
+    fft.forward(data.data());
+    for (size_t k=0; k<n; ++k) {
+      BOOST_CHECK_SMALL(std::abs(data[k] - expected[k]), 1e-10*n);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( backward_inverts_forward )
+{
+  for (size_t n: {4, 7, 10, 32, 33}) {
+    std::vector<FFT::Complex> original = testData(n);
+    std::vector<FFT::Complex> data = original;
+
+    FFT fft(n);
+    fft.forward(data.data());
+    fft.backward(data.data());
+    for (size_t j=0; j<n; ++j) {
+      BOOST_CHECK_SMALL(std::abs(data[j] - original[j]), 1e-12*n);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( strided_data )
+{
+  const size_t n = 6;
+  const ptrdiff_t stride = 3;
+  std::vector<FFT::Complex> line = testData(n);
+  std::vector<FFT::Complex> expected = directTransform(line);
+
+  std::vector<FFT::Complex> data(n*stride, FFT::Complex(-1.0, 0.0));
+  for (size_t j=0; j<n; ++j) data[j*stride] = line[j];
+
+  FFT fft(n);
+  fft.forward(data.data(), stride);
+  for (size_t k=0; k<n; ++k) {
+    BOOST_CHECK_SMALL(std::abs(data[k*stride] - expected[k]), 1e-10);
+    // The values in between are left untouched
+    BOOST_CHECK_EQUAL(data[k*stride + 1], FFT::Complex(-1.0, 0.0));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,75 @@
+/*
+ * test_tridiagonal.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#include "../../maths/linear/tridiagonal.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE( maths )
+
+BOOST_AUTO_TEST_SUITE( tridiagonal )
+
+BOOST_AUTO_TEST_CASE( solution )
+{
+  for (size_t n: {1, 2, 17, 64}) {
+    for (double r: {0.01, 1.0, 250.0}) {
+      double a = -r;
+      double b = 1.0 + 2.1*r;
+      double c = -1.1*r;
+
+      std::vector<double> expected(n);
+      for (size_t i=0; i<n; ++i) expected[i] = std::sin(0.3*i) + 0.1*i;
+
+      // Apply the matrix to the expected solution, the values beyond the ends vanish
+      std::vector<double> x(n);
+      for (size_t i=0; i<n; ++i) {
+        x[i] = b*expected[i];
+        if (i > 0) x[i] += a*expected[i-1];
+        if (i < n-1) x[i] += c*expected[i+1];
+      }
+
+      Tridiagonal system(n, a, b, c);
+      system.solve(x.data());
+      for (size_t i=0; i<n; ++i) {
+        BOOST_CHECK_SMALL(x[i] - expected[i], 1e-10);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cyclic_solution )
+{
+  for (size_t n: {3, 4, 17, 64}) {
+    for (double r: {0.01, 1.0, 250.0}) {
+      double a = -r;
+      double b = 1.0 + 2.1*r;
+      double c = -1.1*r;
+
+      std::vector<double> expected(n);
+      for (size_t i=0; i<n; ++i) expected[i] = std::sin(0.3*i) + 0.1*i;
+
+      // Apply the cyclic matrix to the expected solution
+      std::vector<double> x(n);
+      for (size_t i=0; i<n; ++i) {
+        x[i] = a*expected[(i + n - 1) % n] + b*expected[i] + c*expected[(i + 1) % n];
+      }
+
+      CyclicTridiagonal system(n, a, b, c);
+      system.solve(x.data());
+      for (size_t i=0; i<n; ++i) {
+        BOOST_CHECK_SMALL(x[i] - expected[i], 1e-10);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
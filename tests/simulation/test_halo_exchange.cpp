@@ -0,0 +1,186 @@
+/*
+ * test_halo_exchange.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../../electromagnetics/em_fields.hpp"
+#include "../../simulation/halo_exchange.hpp"
+#include "../../types.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#ifdef HUERTO_ONE_DIM
+
+namespace {
+
+const ptrdiff_t NCellsHalo = 40;
+const int NGhostHalo = 2;
+
+/**
+ * A decomposed field whose inner cells hold their global index and whose ghost
+ * cells are marked as stale
+ */
+struct HaloExchangeFixture
+{
+    HuertoDecomposition decomposition;
+    schnek::GridRegistration reg;
+
+    HaloExchangeFixture()
+    {
+      reg = decomposition.registerField(schnek::GridFactory<Field>{exStaggerYee, NGhostHalo});
+      decomposition.setGlobalRange(Range{Index{0}, Index{NCellsHalo - 1}});
+      decomposition.init();
+
+      decomposition.getGridContext({reg}).forEach([&](Range range, Field &field) {
+        for (ptrdiff_t i=field.getLo(0); i<=field.getHi(0); ++i) {
+          field(i) = (i >= range.getLo(0) && i <= range.getHi(0)) ? i : -1.0;
+        }
+      });
+    }
+
+    /**
+     * The value expected in a ghost cell filled from the periodic neighbour
+     */
+    static double expected(ptrdiff_t i)
+    {
+      return (i + NCellsHalo) % NCellsHalo;
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( simulation )
+
+BOOST_AUTO_TEST_SUITE( halo_exchange )
+
+BOOST_FIXTURE_TEST_CASE( all_faces, HaloExchangeFixture )
+{
+  HaloExchange exchange(decomposition, {reg});
+  exchange.start();
+  exchange.finish();
+
+  decomposition.getGridContext({reg}).forEach([&](Range /* range */, Field &field) {
+    for (ptrdiff_t i=field.getLo(0); i<=field.getHi(0); ++i) {
+      BOOST_CHECK_EQUAL(field(i), expected(i));
+    }
+  });
+}
+
+BOOST_FIXTURE_TEST_CASE( low_face, HaloExchangeFixture )
+{
+  HaloFaces faces = HaloFaces::all();
+  faces.high[0] = false;
+  HaloExchange exchange(decomposition, {reg}, {faces});
+  exchange.start();
+  exchange.finish();
+
+  decomposition.getGridContext({reg}).forEach([&](Range range, Field &field) {
+    for (ptrdiff_t i=field.getLo(0); i<=field.getHi(0); ++i) {
+      double value = (i > range.getHi(0)) ? -1.0 : expected(i);
+      BOOST_CHECK_EQUAL(field(i), value);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
+
+#ifdef HUERTO_TWO_DIM
+
+namespace {
+
+const ptrdiff_t NCellsHalo = 24;
+const int NGhostHalo = 2;
+
+/**
+ * A decomposed field whose inner cells encode their global index and whose
+ * ghost cells are marked as stale
+ */
+struct HaloExchangeFixture
+{
+    HuertoDecomposition decomposition;
+    schnek::GridRegistration reg;
+
+    HaloExchangeFixture()
+    {
+      reg = decomposition.registerField(schnek::GridFactory<Field>{ezStaggerYee, NGhostHalo});
+      decomposition.setGlobalRange(Range{Index{0, 0}, Index{NCellsHalo - 1, NCellsHalo - 1}});
+      decomposition.init();
+
+      decomposition.getGridContext({reg}).forEach([&](Range range, Field &field) {
+        for (ptrdiff_t i=field.getLo(0); i<=field.getHi(0); ++i) {
+          for (ptrdiff_t j=field.getLo(1); j<=field.getHi(1); ++j) {
+            bool inner = (i >= range.getLo(0) && i <= range.getHi(0))
+                      && (j >= range.getLo(1) && j <= range.getHi(1));
+            field(i, j) = inner ? value(i, j) : -1.0;
+          }
+        }
+      });
+    }
+
+    /**
+     * The value of a cell, wrapped into the periodic domain
+     */
+    static double value(ptrdiff_t i, ptrdiff_t j)
+    {
+      return 100*((i + NCellsHalo) % NCellsHalo) + (j + NCellsHalo) % NCellsHalo;
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( simulation )
+
+BOOST_AUTO_TEST_SUITE( halo_exchange )
+
+/*
+ * The edges of the ghost region are filled from the diagonal neighbours
+ */
+BOOST_FIXTURE_TEST_CASE( faces_and_corners, HaloExchangeFixture )
+{
+  HaloExchange exchange(decomposition, {reg});
+  exchange.start();
+  exchange.finish();
+
+  decomposition.getGridContext({reg}).forEach([&](Range /* range */, Field &field) {
+    for (ptrdiff_t i=field.getLo(0); i<=field.getHi(0); ++i) {
+      for (ptrdiff_t j=field.getLo(1); j<=field.getHi(1); ++j) {
+        BOOST_CHECK_EQUAL(field(i, j), value(i, j));
+      }
+    }
+  });
+}
+
+/*
+ * The corners are only exchanged where both adjacent faces are needed
+ */
+BOOST_FIXTURE_TEST_CASE( low_faces_and_corner, HaloExchangeFixture )
+{
+  HaloFaces faces = HaloFaces::all();
+  faces.high[0] = false;
+  faces.high[1] = false;
+  HaloExchange exchange(decomposition, {reg}, {faces});
+  exchange.start();
+  exchange.finish();
+
+  decomposition.getGridContext({reg}).forEach([&](Range range, Field &field) {
+    for (ptrdiff_t i=field.getLo(0); i<=field.getHi(0); ++i) {
+      for (ptrdiff_t j=field.getLo(1); j<=field.getHi(1); ++j) {
+        bool stale = (i > range.getHi(0)) || (j > range.getHi(1));
+        BOOST_CHECK_EQUAL(field(i, j), stale ? -1.0 : value(i, j));
+      }
+    }
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
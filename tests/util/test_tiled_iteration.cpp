@@ -0,0 +1,114 @@
+/*
+ * test_tiled_iteration.cpp
+ *
+ * Created on: 16 Oct 2026
+ * Author: Holger Schmitz
+ * Email: holger@notjustphysics.com
+ */
+
+#include "../../util/tiled_iteration.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace {
+
+typedef schnek::Array<ptrdiff_t, 3> Index3;
+typedef schnek::Range<ptrdiff_t, 3> Range3;
+
+/**
+ * Count how many times each position of a range is visited
+ */
+struct VisitCounter
+{
+    Range3 range;
+    std::vector<int> counts;
+
+    VisitCounter(const Range3 &range) : range(range)
+    {
+      counts.resize(
+          (range.getHi(0) - range.getLo(0) + 1)
+          * (range.getHi(1) - range.getLo(1) + 1)
+          * (range.getHi(2) - range.getLo(2) + 1), 0);
+    }
+
+    int &count(const Index3 &pos)
+    {
+      ptrdiff_t ny = range.getHi(1) - range.getLo(1) + 1;
+      ptrdiff_t nz = range.getHi(2) - range.getLo(2) + 1;
+      return counts[((pos[0] - range.getLo(0))*ny + pos[1] - range.getLo(1))*nz + pos[2] - range.getLo(2)];
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( util )
+
+BOOST_AUTO_TEST_SUITE( tiled_iteration )
+
+BOOST_AUTO_TEST_CASE( visits_every_position_once )
+{
+  Range3 range{Index3{-2, 3, 0}, Index3{17, 11, 6}};
+  for (Index3 shape: {Index3{0, 0, 0}, Index3{4, 4, 0}, Index3{3, 5, 2}, Index3{64, 1, 7}})
+  {
+    VisitCounter counter(range);
+    RangeTiledIterationPolicy<3>::forEach(range, shape, [&](const Index3 &pos) {
+      for (size_t d=0; d<3; ++d)
+      {
+        BOOST_REQUIRE(pos[d] >= range.getLo(d));
+        BOOST_REQUIRE(pos[d] <= range.getHi(d));
+      }
+      ++counter.count(pos);
+    });
+
+    for (int c: counter.counts)
+    {
+      BOOST_CHECK_EQUAL(c, 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( tiles_respect_shape )
+{
+  Range3 range{Index3{0, 0, 0}, Index3{9, 9, 9}};
+  Index3 shape{4, 3, 0};
+  int numTiles = 0;
+  RangeTiledIterationPolicy<3>::forEachTile(range, shape, [&](const Range3 &tile) {
+    BOOST_CHECK(tile.getHi(0) - tile.getLo(0) < 4);
+    BOOST_CHECK(tile.getHi(1) - tile.getLo(1) < 3);
+    BOOST_CHECK_EQUAL(tile.getLo(2), 0);
+    BOOST_CHECK_EQUAL(tile.getHi(2), 9);
+    ++numTiles;
+  });
+  BOOST_CHECK_EQUAL(numTiles, 3*4);
+}
+
+BOOST_AUTO_TEST_CASE( empty_range )
+{
+  Range3 range{Index3{0, 5, 0}, Index3{9, 4, 9}};
+  int visits = 0;
+  RangeTiledIterationPolicy<3>::forEach(range, Index3{4, 4, 0}, [&](const Index3 &) {
+    ++visits;
+  });
+  BOOST_CHECK_EQUAL(visits, 0);
+}
+
+BOOST_AUTO_TEST_CASE( candidates_keep_rows_whole )
+{
+  Range3 range{Index3{0, 0, 0}, Index3{19, 7, 99}};
+  std::vector<Index3> candidates = tileShapeCandidates(range);
+  // 0, 4, 8, 16 in the first and 0, 4 in the second dimension
+  BOOST_CHECK_EQUAL(candidates.size(), 4U*2U);
+  for (const Index3 &shape: candidates)
+  {
+    BOOST_CHECK_EQUAL(shape[2], 0);
+  }
+
+  Index3 best = autotuneTileShape(candidates, [](const Index3 &) {}, 1);
+  BOOST_CHECK_EQUAL(best[2], 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,8 @@
 #include <schnek/grid/iteration/range-iteration.hpp>
 #include <schnek/decomposition/mpi_cartesian_decomposition.hpp>
 
+#include "util/kokkos_iteration.hpp"
+
 #include <memory>
 
 #if !defined(HUERTO_ONE_DIM) && !defined(HUERTO_TWO_DIM) && !defined(HUERTO_THREE_DIM)
@@ -31,6 +33,19 @@ std::static_assert(false, "Must define Huerto Dimension before including types.h
 #define HuertoGridChecker HUERTO_GRID_CHECKER
 #endif
 
+/**
+ * The floating point type of the simulation grids
+ *
+ * Defining `HUERTO_SINGLE_PRECISION` stores the `Grid` and `Field` types in single
+ * precision. Coordinates, coefficients and the 1D grids are always kept in double
+ * precision.
+ */
+#ifdef HUERTO_SINGLE_PRECISION
+typedef float Real;
+#else
+typedef double Real;
+#endif
+
 #ifdef HUERTO_ONE_DIM
 static const size_t DIMENSION = 1;
 enum Direction {west, east};
@@ -49,11 +64,11 @@ enum Direction {west, east, south, north, down, up};
 typedef schnek::Array<ptrdiff_t, DIMENSION> Index;
 typedef schnek::Array<size_t, DIMENSION> Size;
 typedef schnek::Array<double, DIMENSION> Vector;
-typedef schnek::Grid<double, DIMENSION, HuertoGridChecker> Grid;
+typedef schnek::Grid<Real, DIMENSION, HuertoGridChecker> Grid;
 typedef std::shared_ptr<Grid> pGrid;
 typedef std::unique_ptr<Grid> uGrid;
 typedef std::reference_wrapper<Grid> rGrid;
-typedef schnek::Field<double, DIMENSION, HuertoGridChecker> Field;
+typedef schnek::Field<Real, DIMENSION, HuertoGridChecker> Field;
 typedef std::shared_ptr<Field> pField;
 typedef std::unique_ptr<Field> uField;
 typedef std::reference_wrapper<Field> rField;
@@ -111,7 +126,15 @@ typedef schnek::Range<ptrdiff_t, 3> Range3d;
 typedef schnek::Range<double, 3> Domain3d;
 typedef schnek::Array<bool, 3> Stagger3d;
 
+/*
+ * The iteration policy of the field kernels is chosen when configuring the build.
+ * With HUERTO_USE_KOKKOS, ranges are iterated in parallel using Kokkos.
+ */
+#ifdef HUERTO_USE_KOKKOS
+typedef RangeKokkosIterationPolicy<DIMENSION> FieldIterator;
+#else
 typedef schnek::RangeCIterationPolicy<DIMENSION> FieldIterator;
+#endif
 typedef schnek::RangeCIterationPolicy<1> Field1dIterator;
 typedef schnek::RangeCIterationPolicy<2> Field2dIterator;
 typedef schnek::RangeCIterationPolicy<3> Field3dIterator;
@@ -17,12 +17,18 @@ struct SetField {
   }
 };
 
-template<typename FieldType, typename Decomposition>
+/**
+ * Set a field to a constant value
+ *
+ * The iteration policy can be chosen through the `Iterator` template argument,
+ * e.g. `FieldSlabIterator` for a multi-threaded iteration.
+ */
+template<typename FieldType, typename Iterator = FieldIterator, typename Decomposition>
 void setField(Decomposition &decomposition, schnek::GridRegistration fieldReg, typename FieldType::value_type val) {
     auto gridContext = decomposition.getGridContext({fieldReg});
     gridContext.forEach([&](Range range, FieldType &field) {
         SetField<FieldType> set{field, val};
-        FieldIterator::forEach(range, set);
+        Iterator::forEach(range, set);
     });
 }
 
@@ -45,11 +51,17 @@ struct AddToField {
   }
 };
 
-template<typename AccType, typename FieldType, typename Decomposition>
+/**
+ * Add a field to an accumulator field on the range in which both are defined
+ *
+ * The iteration policy can be chosen through the `Iterator` template argument,
+ * e.g. `FieldSlabIterator` for a multi-threaded iteration.
+ */
+template<typename AccType, typename FieldType, typename Iterator = FieldIterator, typename Decomposition>
 void addToField(Decomposition &decomposition, schnek::GridRegistration accReg, schnek::GridRegistration fieldReg) {
     auto gridContext = decomposition.getGridContext({fieldReg, accReg});
     gridContext.forEach([&](Range range, FieldType &field, AccType &acc) {
         AddToField<AccType, FieldType> sum{acc, field};
-        FieldIterator::forEach(range, sum);
+        Iterator::forEach(range, sum);
     });
 }
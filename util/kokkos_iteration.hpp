@@ -0,0 +1,123 @@
+/*
+ * kokkos_iteration.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_UTIL_KOKKOS_ITERATION_HPP_
+#define HUERTO_UTIL_KOKKOS_ITERATION_HPP_
+
+#ifdef HUERTO_USE_KOKKOS
+
+#include <schnek/grid/array.hpp>
+#include <schnek/grid/grid.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+/**
+ * Initialise Kokkos on first use
+ *
+ * The program must call huertoFinalizeKokkos() before it finalises MPI.
+ */
+inline void huertoEnsureKokkos() {
+  if (!Kokkos::is_initialized()) {
+    Kokkos::initialize();
+  }
+}
+
+/**
+ * Finalise Kokkos if it has been initialised
+ *
+ * This must be called by the program before MPI_Finalize. Kokkos may hold MPI
+ * resources and its host threads must not outlive MPI.
+ */
+inline void huertoFinalizeKokkos() {
+  if (Kokkos::is_initialized()) {
+    Kokkos::finalize();
+  }
+}
+
+/**
+ * Adapts a functor taking a `schnek::Array` index to the index arguments
+ * passed by Kokkos
+ *
+ * The functors of Huerto write to the fields through their non-const call
+ * operator. The adapter only holds a pointer to the functor, so that its own
+ * call operator is const as required by Kokkos. All threads call the same
+ * functor, which therefore must not modify its members.
+ */
+template<size_t rank, class Func>
+struct KokkosIndexAdapter {
+    typedef schnek::Array<ptrdiff_t, rank> IndexType;
+    Func *func;
+
+    KOKKOS_INLINE_FUNCTION void operator()(const ptrdiff_t i) const {
+      (*func)(IndexType{i});
+    }
+
+    KOKKOS_INLINE_FUNCTION void operator()(const ptrdiff_t i, const ptrdiff_t j) const {
+      (*func)(IndexType{i, j});
+    }
+
+    KOKKOS_INLINE_FUNCTION void operator()(const ptrdiff_t i, const ptrdiff_t j, const ptrdiff_t k) const {
+      (*func)(IndexType{i, j, k});
+    }
+};
+
+/**
+ * An iteration policy that maps the iteration over a range onto Kokkos
+ *
+ * This is a drop-in replacement for `schnek::RangeCIterationPolicy`. The range is
+ * iterated with a `Kokkos::MDRangePolicy` on the default host execution space,
+ * which is OpenMP or Serial depending on how Kokkos was built. The innermost index
+ * runs fastest, matching the memory layout of the grids.
+ *
+ * The functor is called concurrently from multiple threads. It must not modify
+ * its members or rely on the order of iteration.
+ */
+template<size_t rank>
+struct RangeKokkosIterationPolicy
+{
+    typedef schnek::Range<ptrdiff_t, rank> RangeType;
+    typedef Kokkos::DefaultHostExecutionSpace ExecutionSpace;
+    typedef Kokkos::MDRangePolicy<ExecutionSpace,
+                                  Kokkos::Rank<rank, Kokkos::Iterate::Right, Kokkos::Iterate::Right>,
+                                  Kokkos::IndexType<ptrdiff_t>> MDPolicy;
+
+    template<class Func>
+    static void forEach(const RangeType &range, Func func)
+    {
+      huertoEnsureKokkos();
+      KokkosIndexAdapter<rank, Func> adapter{&func};
+      forEachImpl(range, adapter, std::integral_constant<bool, (rank > 1)>());
+      // The adapter points to the local copy of the functor
+      ExecutionSpace().fence();
+    }
+  private:
+    template<class Adapter>
+    static void forEachImpl(const RangeType &range, const Adapter &adapter, std::true_type)
+    {
+      typename MDPolicy::point_type lo, hi;
+      for (size_t d=0; d<rank; ++d) {
+        lo[d] = range.getLo(d);
+        hi[d] = range.getHi(d) + 1;
+      }
+      Kokkos::parallel_for("huerto::forEach", MDPolicy(lo, hi), adapter);
+    }
+
+    template<class Adapter>
+    static void forEachImpl(const RangeType &range, const Adapter &adapter, std::false_type)
+    {
+      // MDRangePolicy requires at least two dimensions
+      Kokkos::RangePolicy<ExecutionSpace, Kokkos::IndexType<ptrdiff_t>>
+          policy(range.getLo(0), range.getHi(0) + 1);
+      Kokkos::parallel_for("huerto::forEach", policy, adapter);
+    }
+};
+
+#endif // HUERTO_USE_KOKKOS
+
+#endif /* HUERTO_UTIL_KOKKOS_ITERATION_HPP_ */
@@ -0,0 +1,184 @@
+/*
+ * parallel_iteration.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_UTIL_PARALLEL_ITERATION_HPP_
+#define HUERTO_UTIL_PARALLEL_ITERATION_HPP_
+
+#include "../types.hpp"
+
+#include <schnek/grid/iteration/range-iteration.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * The approximate number of grid cells in a slab processed by a single thread
+ *
+ * The default of \f$2^{15}\f$ cells keeps a slab of a few fields inside the L2
+ * cache. The value can be changed at run time.
+ */
+inline ptrdiff_t &slabCells() {
+  static ptrdiff_t cells = 1 << 15;
+  return cells;
+}
+
+/**
+ * Split a range into slabs along the first dimension
+ *
+ * Each slab contains approximately slabCells() grid cells but at least one plane.
+ * The innermost dimension is never split so that the rows remain contiguous.
+ */
+template<size_t rank>
+std::vector<schnek::Range<ptrdiff_t, rank>> splitIntoSlabs(const schnek::Range<ptrdiff_t, rank> &range)
+{
+  std::vector<schnek::Range<ptrdiff_t, rank>> slabs;
+  for (size_t d=0; d<rank; ++d) {
+    if (range.getHi(d) < range.getLo(d)) return slabs;
+  }
+
+  ptrdiff_t planeCells = 1;
+  for (size_t d=1; d<rank; ++d) {
+    planeCells *= range.getHi(d) - range.getLo(d) + 1;
+  }
+  ptrdiff_t planes = std::max<ptrdiff_t>(1, slabCells() / planeCells);
+
+  for (ptrdiff_t lo = range.getLo(0); lo <= range.getHi(0); lo += planes) {
+    schnek::Array<ptrdiff_t, rank> slabLo = range.getLo();
+    schnek::Array<ptrdiff_t, rank> slabHi = range.getHi();
+    slabLo[0] = lo;
+    slabHi[0] = std::min(lo + planes - 1, range.getHi(0));
+    slabs.push_back(schnek::Range<ptrdiff_t, rank>{slabLo, slabHi});
+  }
+  return slabs;
+}
+
+/**
+ * Call `body(s)` for every slab index `s` from 0 to `numSlabs - 1`
+ *
+ * With HUERTO_USE_KOKKOS, the slabs are distributed by Kokkos on the default
+ * host execution space, otherwise by OpenMP. The slabs are processed serially if
+ * `threaded` is false or if there is only one slab.
+ */
+template<class Body>
+void forEachSlabIndex(ptrdiff_t numSlabs, bool threaded, const Body &body)
+{
+#ifdef HUERTO_USE_KOKKOS
+  if (threaded && numSlabs > 1) {
+    huertoEnsureKokkos();
+    typedef Kokkos::DefaultHostExecutionSpace ExecutionSpace;
+    Kokkos::parallel_for("huerto::forEachSlab",
+        Kokkos::RangePolicy<ExecutionSpace, Kokkos::Schedule<Kokkos::Dynamic>, Kokkos::IndexType<ptrdiff_t>>(0, numSlabs),
+        body);
+    ExecutionSpace().fence();
+    return;
+  }
+#elif defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(threaded && numSlabs > 1)
+#endif
+  for (ptrdiff_t s=0; s<numSlabs; ++s) {
+    body(s);
+  }
+  (void)threaded;
+}
+
+/**
+ * An iteration policy that distributes slabs of a range over threads
+ *
+ * This is a drop-in replacement for `schnek::RangeCIterationPolicy`. Each slab
+ * is processed by its own copy of the functor. The functor must therefore not rely
+ * on state that is modified during the iteration. The slabs are distributed as
+ * described in forEachSlabIndex(). Without threads, or if `threaded` is false,
+ * they are processed serially. Callers pass their own setting. Without the
+ * flag, as in the generic field utilities, the slabs are threaded.
+ */
+template<size_t rank>
+struct RangeSlabIterationPolicy
+{
+    typedef schnek::Range<ptrdiff_t, rank> RangeType;
+    typedef schnek::Array<ptrdiff_t, rank> IndexType;
+
+    /**
+     * Call `func(pos)` for every position in the range
+     */
+    template<class Func>
+    static void forEach(const RangeType &range, Func func, bool threaded = true)
+    {
+      std::vector<RangeType> slabs = splitIntoSlabs(range);
+      forEachSlabIndex(slabs.size(), threaded, [&](const ptrdiff_t s) {
+        Func slabFunc = func;
+        schnek::RangeCIterationPolicy<rank>::forEach(slabs[s], slabFunc);
+      });
+    }
+
+    /**
+     * Call `func(slab)` for every slab of the range
+     */
+    template<class Func>
+    static void forEachSlab(const RangeType &range, Func func, bool threaded = true)
+    {
+      std::vector<RangeType> slabs = splitIntoSlabs(range);
+      forEachSlabIndex(slabs.size(), threaded, [&](const ptrdiff_t s) {
+        Func slabFunc = func;
+        slabFunc(slabs[s]);
+      });
+    }
+};
+
+typedef RangeSlabIterationPolicy<DIMENSION> FieldSlabIterator;
+
+/**
+ * A list of independent tasks, each operating on a range of a local grid
+ *
+ * All the tasks are split into slabs, and all slabs are then processed in a single
+ * parallel loop. In this way, the sub-blocks of a local grid, such as the interior
+ * and the boundary layers, are processed concurrently, and the work is balanced
+ * between threads even if the sub-blocks differ in size. The tasks must not write
+ * to overlapping parts of the grids. A task may be called concurrently for
+ * different slabs and must not modify its captured state.
+ */
+class BlockTaskList
+{
+  public:
+    typedef std::function<void(const Range&)> Task;
+  private:
+    std::vector<std::pair<Range, Task>> tasks;
+  public:
+    /**
+     * Add a task that is called for parts of the range
+     */
+    void add(const Range &range, Task task) {
+      tasks.push_back(std::make_pair(range, task));
+    }
+
+    /**
+     * Run all tasks and clear the list
+     *
+     * If `threaded` is false, or without OpenMP, the tasks are run serially.
+     */
+    void run(bool threaded) {
+      std::vector<std::pair<size_t, Range>> slabs;
+      for (size_t t=0; t<tasks.size(); ++t) {
+        for (const Range &slab: splitIntoSlabs(tasks[t].first)) {
+          slabs.push_back(std::make_pair(t, slab));
+        }
+      }
+
+      forEachSlabIndex(slabs.size(), threaded, [&](const ptrdiff_t s) {
+        tasks[slabs[s].first].second(slabs[s].second);
+      });
+
+      tasks.clear();
+    }
+};
+
+#endif /* HUERTO_UTIL_PARALLEL_ITERATION_HPP_ */
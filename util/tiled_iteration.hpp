@@ -0,0 +1,170 @@
+/*
+ * tiled_iteration.hpp
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: Holger Schmitz
+ */
+
+#ifndef HUERTO_UTIL_TILED_ITERATION_HPP_
+#define HUERTO_UTIL_TILED_ITERATION_HPP_
+
+#include "../types.hpp"
+
+#include <schnek/grid/iteration/range-iteration.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+/**
+ * The default tile shape used by RangeTiledIterationPolicy
+ *
+ * An entry of zero or less means that the range is not tiled along that dimension.
+ * By default, tiles are 16 cells wide in all but the innermost dimension, which
+ * is kept whole so that the rows remain contiguous. The value can be changed at
+ * run time.
+ */
+template<size_t rank>
+schnek::Array<ptrdiff_t, rank> &defaultTileShape() {
+  static schnek::Array<ptrdiff_t, rank> shape = []() {
+    schnek::Array<ptrdiff_t, rank> s;
+    for (size_t d=0; d<rank; ++d) {
+      s[d] = (d + 1 < rank) ? 16 : 0;
+    }
+    return s;
+  }();
+  return shape;
+}
+
+/**
+ * An iteration policy that sweeps over a range in tiles
+ *
+ * This is a drop-in replacement for `schnek::RangeCIterationPolicy`. The tiles are
+ * visited in lexicographic order, and the cells inside each tile are also visited
+ * in lexicographic order. For stencils that read the neighbouring planes, such
+ * as the Yee curl, this keeps the planes of a tile in the cache between uses even
+ * if the transverse size of the grid is large.
+ */
+template<size_t rank>
+struct RangeTiledIterationPolicy
+{
+    typedef schnek::Range<ptrdiff_t, rank> RangeType;
+    typedef schnek::Array<ptrdiff_t, rank> IndexType;
+
+    /**
+     * Call `func(tile)` for every tile of the range
+     */
+    template<class Func>
+    static void forEachTile(const RangeType &range, const IndexType &shape, Func &&func)
+    {
+      for (size_t d=0; d<rank; ++d) {
+        if (range.getHi(d) < range.getLo(d)) return;
+      }
+
+      IndexType step;
+      for (size_t d=0; d<rank; ++d) {
+        step[d] = (shape[d] > 0) ? shape[d] : range.getHi(d) - range.getLo(d) + 1;
+      }
+
+      IndexType tileLo = range.getLo();
+      while (true) {
+        IndexType tileHi;
+        for (size_t d=0; d<rank; ++d) {
+          tileHi[d] = std::min(tileLo[d] + step[d] - 1, range.getHi(d));
+        }
+        func(RangeType{tileLo, tileHi});
+
+        int d = rank - 1;
+        while (d >= 0) {
+          tileLo[d] += step[d];
+          if (tileLo[d] <= range.getHi(d)) break;
+          tileLo[d] = range.getLo(d);
+          --d;
+        }
+        if (d < 0) return;
+      }
+    }
+
+    /**
+     * Call `func(pos)` for every position in the range, using tiles of the given shape
+     */
+    template<class Func>
+    static void forEach(const RangeType &range, const IndexType &shape, Func func)
+    {
+      forEachTile(range, shape, [&](const RangeType &tile) {
+        schnek::RangeCIterationPolicy<rank>::forEach(tile, func);
+      });
+    }
+
+    /**
+     * Call `func(pos)` for every position in the range, using the default tile shape
+     */
+    template<class Func>
+    static void forEach(const RangeType &range, Func func)
+    {
+      forEach(range, defaultTileShape<rank>(), func);
+    }
+};
+
+typedef RangeTiledIterationPolicy<DIMENSION> FieldTileIterator;
+
+/**
+ * The tile shapes tried by autotuneTileShape() for a range
+ *
+ * The innermost dimension is never tiled. In the other dimensions the candidates
+ * are powers of two from 4 to 64 that are smaller than the extent of the range,
+ * as well as the untiled extent.
+ */
+template<size_t rank>
+std::vector<schnek::Array<ptrdiff_t, rank>> tileShapeCandidates(const schnek::Range<ptrdiff_t, rank> &range)
+{
+  std::vector<schnek::Array<ptrdiff_t, rank>> candidates;
+  schnek::Array<ptrdiff_t, rank> shape;
+  for (size_t d=0; d<rank; ++d) shape[d] = 0;
+  candidates.push_back(shape);
+
+  for (size_t d=0; d+1<rank; ++d) {
+    ptrdiff_t extent = range.getHi(d) - range.getLo(d) + 1;
+    std::vector<schnek::Array<ptrdiff_t, rank>> previous = candidates;
+    for (ptrdiff_t size = 4; size <= 64 && size < extent; size *= 2) {
+      for (schnek::Array<ptrdiff_t, rank> candidate: previous) {
+        candidate[d] = size;
+        candidates.push_back(candidate);
+      }
+    }
+  }
+  return candidates;
+}
+
+/**
+ * Find the fastest tile shape by timing a function for each candidate
+ *
+ * `step(shape)` should perform a representative update on the local grid using
+ * tiles of the given shape. Each candidate is timed `repeats` times and the
+ * shortest time is used.
+ */
+template<size_t rank, class StepFunc>
+schnek::Array<ptrdiff_t, rank> autotuneTileShape(const std::vector<schnek::Array<ptrdiff_t, rank>> &candidates,
+                                                 StepFunc step,
+                                                 int repeats = 2)
+{
+  schnek::Array<ptrdiff_t, rank> best = candidates.at(0);
+  double bestTime = std::numeric_limits<double>::max();
+  for (const schnek::Array<ptrdiff_t, rank> &shape: candidates) {
+    double time = std::numeric_limits<double>::max();
+    for (int r=0; r<repeats; ++r) {
+      auto start = std::chrono::steady_clock::now();
+      step(shape);
+      auto stop = std::chrono::steady_clock::now();
+      time = std::min(time, std::chrono::duration<double>(stop - start).count());
+    }
+    if (time < bestTime) {
+      bestTime = time;
+      best = shape;
+    }
+  }
+  return best;
+}
+
+#endif /* HUERTO_UTIL_TILED_ITERATION_HPP_ */